@@ -25,6 +25,7 @@ SOFTWARE.
 
 #include <string.h>
 #include <hardware/pio.h>
+#include <hardware/sync.h>
 #include "abus.h"
 #include "abus_setup.h"
 #include "abus_pin_config.h"
@@ -32,6 +33,7 @@ SOFTWARE.
 #include "config/config.h"
 #include "config/device_regs.h"
 #include "fonts/textfont.h"
+#include "debug/profiler.h"
 
 #define VIDEX_ABUS
 #include "videx/videx_vterm.h"
@@ -57,11 +59,11 @@ static inline void __time_critical_func(machine_auto_detection)(uint32_t address
 {
     if(current_machine == MACHINE_AUTO)
     {
-        char Char1 = apple_memory[0x0413];
-        char Char2 = apple_memory[0x0415];
+        char Char1 = apple_memory[SHADOW_OFFSET(0x0413)];
+        char Char2 = apple_memory[SHADOW_OFFSET(0x0415)];
         if (Char1 == 0xA0) // ' '
         {
-            if (((uint16_t*)apple_memory)[0x07D0>>1] == 0x60AA)
+            if (((uint16_t*)apple_memory)[SHADOW_OFFSET(0x07D0)>>1] == 0x60AA)
             {
                 detected_machine = MACHINE_II;  // "*(CURSOR)" = Apple II without Autostart
                 set_machine(MACHINE_II);
@@ -207,8 +209,67 @@ static inline void romxe_faxx_check_read(uint_fast16_t address)
     }
 }
 
+#ifdef BEAM_TRACKING
+// The bus interface does not sample the data of read cycles, so the VBL flag
+// returned by $C019 is unknown. But programs poll $C019 in a loop until the
+// flag changes, so the last read of a polling loop happened at a VBL edge:
+// the start of the VBL (scanline 192), unless the loop ended one VBL period
+// after the previous one (waiting for the end of the VBL, scanline 0).
+#define BEAM_POLL_GAP 16 // max. bus cycles between two reads of a polling loop
+
+static uint32_t beam_poll_last;  // bus cycle of the most recent $C019 read
+static uint32_t beam_poll_reads; // number of reads of the current polling loop
+static uint32_t beam_edge_last;  // bus cycle of the most recent VBL edge
+
+static inline void __time_critical_func(beam_vbl_edge)(uint32_t cycle)
+{
+    uint32_t lines      = IS_IFLAG(IFLAGS_PAL) ? BEAM_LINES_PAL : BEAM_LINES_NTSC;
+    uint32_t vbl_cycles = (lines - BEAM_VISIBLE_LINES) * BEAM_CYCLES_PER_LINE;
+    // distance to the previous edge, minus the VBL period, within +/- one scanline
+    uint32_t deviation  = cycle - beam_edge_last - vbl_cycles + BEAM_CYCLES_PER_LINE;
+
+    if (deviation <= 2*BEAM_CYCLES_PER_LINE)
+        beam_frame_start = cycle;
+    else
+        beam_frame_start = cycle - BEAM_VISIBLE_LINES*BEAM_CYCLES_PER_LINE;
+    beam_edge_last = cycle;
+    beam_anchored  = true;
+}
+
+static inline void __time_critical_func(beam_vbl_read)(void)
+{
+    uint32_t cycle = bus_cycle_counter;
+    if (cycle - beam_poll_last > BEAM_POLL_GAP)
+    {
+        // a new polling loop: the previous one ended at a VBL edge
+        if (beam_poll_reads > 1)
+            beam_vbl_edge(beam_poll_last);
+        beam_poll_reads = 0;
+    }
+    beam_poll_reads++;
+    beam_poll_last = cycle;
+}
+#endif
+
+#ifdef FEATURE_BEAM_TIMELINE
+static inline void __time_critical_func(beam_log_softswitches)(uint32_t softsw)
+{
+    uint32_t count = beam_log_count;
+    volatile beam_event_t* event = &beam_log[count & (BEAM_LOG_SIZE-1)];
+    event->cycle  = bus_cycle_counter;
+    event->softsw = softsw;
+    // publish the entry after writing it
+    __dmb();
+    beam_log_count = count+1;
+}
+#endif
+
 static inline void __time_critical_func(apple2_softswitches)(bool is_write, uint32_t address, uint32_t value)
 {
+#ifdef FEATURE_BEAM_TIMELINE
+    uint32_t previous = soft_switches;
+#endif
+
     switch(address & 0x7f)
     {
     case 0x00: // 80STOREOFF
@@ -309,7 +370,12 @@ static inline void __time_critical_func(apple2_softswitches)(bool is_write, uint
         break;
     case 0x19: // VBLANK
         if (IS_IFLAG(IFLAGS_IIE_REGS) && (!is_write))
+        {
             vblank_counter += 1;
+#ifdef BEAM_TRACKING
+            beam_vbl_read();
+#endif
+        }
         break;
     case 0x21: // COLOR/MONO
         if (IS_IFLAG(IFLAGS_IIE_REGS) && (is_write))
@@ -432,10 +498,17 @@ static inline void __time_critical_func(apple2_softswitches)(bool is_write, uint
         }
         break;
     }
+
+#ifdef FEATURE_BEAM_TIMELINE
+    if ((soft_switches ^ previous) & SOFTSW_BEAM_MASK)
+    {
+        beam_log_softswitches(soft_switches);
+    }
+#endif
 }
 
 // access to card's DEVSEL register area
-static void bus_card_selected(uint32_t value)
+static void CORE1_CODE(bus_card_selected)(uint32_t value)
 {
     uint_fast16_t address = ADDRESS_BUS(value);
 
@@ -455,18 +528,22 @@ static void bus_card_selected(uint32_t value)
 }
 
 // handle address ranges we're not really interested in
-void __time_critical_func(bus_func_ignore)(uint32_t value)
+void CORE1_CODE(bus_func_ignore)(uint32_t value)
 {
     // do nothing for this address area
 }
 
 // Shadow screen area of the Apple's memory by observing the bus write cycles
-void __time_critical_func(bus_func_screen_write)(uint32_t value)
+void CORE1_CODE(bus_func_screen_write)(uint32_t value)
 {
     uint_fast16_t address = ADDRESS_BUS(value);
-    if ((address >= 0x400)&&(address < MAX_ADDRESS))
+    // only the display pages are shadowed ($0400-$0BFF, $2000-$5FFF)
+    if ((address < SHADOW_HGR_START) ?
+        ((address >= SHADOW_TEXT_START)&&(address < SHADOW_TEXT_END)) :
+        (address < SHADOW_HGR_END))
     {
-        uint_fast8_t data = DATA_BUS(value);
+        uint_fast8_t  data   = DATA_BUS(value);
+        uint_fast16_t offset = SHADOW_OFFSET(address);
 
         // Mirror Video Memory from MAIN & AUX banks
         if ((soft_switches & SOFTSW_80STORE)&&
@@ -479,11 +556,17 @@ void __time_critical_func(bus_func_screen_write)(uint32_t value)
             if(soft_switches & SOFTSW_PAGE_2)
             {
                 if (!ramworks_active)
-                    aux_memory[address] = data;
+                {
+                    aux_memory[offset] = data;
+                    SHADOW_MARK_DIRTY(aux, offset);
+                }
             }
             else
             if (!IS_SOFTSWITCH(SOFTSW_MENU_ENABLE))
-                apple_memory[address] = data;
+            {
+                apple_memory[offset] = data;
+                SHADOW_MARK_DIRTY(main, offset);
+            }
             // nothing else to do
         }
         else
@@ -491,12 +574,16 @@ void __time_critical_func(bus_func_screen_write)(uint32_t value)
             if(soft_switches & SOFTSW_AUX_WRITE)
             {
                 if (!ramworks_active)
-                    aux_memory[address] = data;
+                {
+                    aux_memory[offset] = data;
+                    SHADOW_MARK_DIRTY(aux, offset);
+                }
             }
             else
             if (!IS_SOFTSWITCH(SOFTSW_MENU_ENABLE))
             {
-                apple_memory[address] = data;
+                apple_memory[offset] = data;
+                SHADOW_MARK_DIRTY(main, offset);
                 if (address < 0x800)
                 {
                     machine_auto_detection(address);
@@ -506,7 +593,7 @@ void __time_critical_func(bus_func_screen_write)(uint32_t value)
     }
 }
 
-void __time_critical_func(bus_func_cxxx_read)(uint32_t value)
+void CORE1_CODE(bus_func_cxxx_read)(uint32_t value)
 {
     uint_fast16_t address = ADDRESS_BUS(value);
 
@@ -536,7 +623,7 @@ void __time_critical_func(bus_func_cxxx_read)(uint32_t value)
     romx_cxxx_check_read(address);
 }
 
-void __time_critical_func(bus_func_cxxx_write)(uint32_t value)
+void CORE1_CODE(bus_func_cxxx_write)(uint32_t value)
 {
     uint_fast16_t address = ADDRESS_BUS(value);
 
@@ -564,7 +651,7 @@ void __time_critical_func(bus_func_cxxx_write)(uint32_t value)
     }
 }
 
-void __time_critical_func(bus_func_fxxx_read)(uint32_t value)
+void CORE1_CODE(bus_func_fxxx_read)(uint32_t value)
 {
     uint_fast16_t address = ADDRESS_BUS(value);
 
@@ -579,6 +666,8 @@ void __time_critical_func(bus_func_fxxx_read)(uint32_t value)
 #ifndef FEATURE_ABUS_DEBUG
         bus_overflow_counter = 0;
 #endif
+        bus_handler_worst_cycles = 0;
+        bus_fifo_high_water = 0;
         videx_vterm_mem_selected = false;
         ramworks_active = false;
         reset_counter++;
@@ -594,7 +683,7 @@ void __time_critical_func(bus_func_fxxx_read)(uint32_t value)
     }
 }
 
-a2busfunc bus_functions[16*2] =
+a2busfunc CORE1_DATA(bus_functions)[16*2] =
 {
     /*$0xxx READ */ bus_func_ignore,
     /*$1xxx READ */ bus_func_ignore,
@@ -632,7 +721,7 @@ a2busfunc bus_functions[16*2] =
 };
 
 #ifdef FEATURE_TEST
-void __time_critical_func(abus_interface)(uint32_t value)
+void CORE1_CODE(abus_interface)(uint32_t value)
 #else
 static inline void abus_interface(uint32_t value)
 #endif
@@ -673,15 +762,70 @@ static inline void abus_interface(uint32_t value)
     }
 }
 
-void __time_critical_func(abus_clear_fifo)(void)
+// record the CPU cycles spent for a bus cycle
+static inline void __time_critical_func(abus_statistics)(uint32_t value, uint32_t cycles)
+{
+    uint_fast8_t handler = BUS_HANDLER_CARD_SELECT;
+    if (!CARD_SELECT(value))
+    {
+        handler = ADDRESS_BUS_HI_NIBBLE(value);
+        if (ACCESS_WRITE(value))
+            handler += 0x10;
+    }
+
+    uint_fast32_t bucket = cycles >> BUS_HISTOGRAM_SHIFT;
+    if (bucket >= BUS_HISTOGRAM_BUCKETS)
+        bucket = BUS_HISTOGRAM_BUCKETS-1;
+    bus_handler_histogram[handler][bucket]++;
+
+    if (cycles > bus_handler_worst_cycles)
+    {
+        bus_handler_worst_cycles = cycles;
+        bus_handler_worst        = handler;
+    }
+}
+
+// record the CPU cycles spent for a number of bus cycles (sustained bus cycle rate)
+static inline void __time_critical_func(abus_busy)(uint32_t bus_cycles, uint32_t cycles)
 {
+    bus_busy_cycles += cycles;
+    bus_busy_count  += bus_cycles;
+    if (bus_busy_cycles & 0x80000000)
+    {
+        // keep a moving average
+        bus_busy_cycles >>= 1;
+        bus_busy_count  >>= 1;
+    }
+}
+
+#ifdef FEATURE_TEST
+// process a simulated bus cycle and record its CPU cycles in the bus handler statistics
+void CORE1_CODE(abus_interface_timed)(uint32_t value)
+{
+    uint32_t start = CYCLE_COUNTER_READ();
+    abus_interface(value);
+    abus_statistics(value, CYCLE_COUNTER_ELAPSED(start, CYCLE_COUNTER_READ()));
+}
+#endif
+
+#ifdef FEATURE_ABUS_DMA
+static uint32_t      abus_dma_read_count;
+static volatile bool abus_dma_flush;
+#endif
+
+void CORE1_CODE(abus_clear_fifo)(void)
+{
+#ifdef FEATURE_ABUS_DMA
+    // the ring buffer is skipped once the current bus cycle was processed
+    abus_dma_flush = true;
+#endif
     while (abus_pio_fifo_level())
     {
         (void) abus_pio_blocking_read();
     }
 }
 
-void __time_critical_func(abus_init)()
+void CORE1_CODE(abus_init)()
 {
 #ifdef APPLE_MODEL_IIPLUS
     videx_vterm_init();
@@ -689,11 +833,73 @@ void __time_critical_func(abus_init)()
     abus_pio_setup();
 }
 
-void __time_critical_func(abus_loop)()
+#ifdef FEATURE_ABUS_DMA
+// Bus cycles are captured into a ring buffer by DMA and processed in batches.
+void CORE1_CODE(abus_loop)()
 {
     // initialize the Apple II bus interface
     abus_init();
 
+    // cycle counter for the bus handler statistics
+    CYCLE_COUNTER_INIT();
+
+    while(1)
+    {
+        uint32_t write_count = abus_dma_write_count();
+        if (write_count == abus_dma_read_count)
+            continue;
+
+        // number of bus cycles waiting to be processed
+        uint32_t level = (write_count - abus_dma_read_count) & (ABUS_DMA_PASS_WORDS-1);
+        if (level > ABUS_DMA_RING_SIZE)
+        {
+            // The DMA lapped the reader: the oldest cycles were overwritten. Count
+            // them for the beam position, continue with the newest half of the ring.
+            bus_overflow_counter++;
+            bus_cycle_counter  += level - ABUS_DMA_RING_SIZE/2;
+            abus_dma_read_count = (write_count - ABUS_DMA_RING_SIZE/2) & (ABUS_DMA_PASS_WORDS-1);
+            level               = ABUS_DMA_RING_SIZE/2;
+        }
+        if (level > bus_fifo_high_water)
+            bus_fifo_high_water = level;
+
+        uint32_t batch_start = CYCLE_COUNTER_READ();
+        uint32_t start = batch_start;
+        uint32_t count = abus_dma_read_count;
+        for (uint32_t i=0;i<level;i++)
+        {
+            uint32_t value = abus_dma_ring[count & (ABUS_DMA_RING_SIZE-1)];
+            count = (count+1) & (ABUS_DMA_PASS_WORDS-1);
+
+            abus_interface(value);
+            bus_cycle_counter++;
+
+            uint32_t now = CYCLE_COUNTER_READ();
+            abus_statistics(value, CYCLE_COUNTER_ELAPSED(start, now));
+            start = now;
+
+            if (abus_dma_flush)
+            {
+                // skip everything captured while the bus was not served (menu)
+                abus_dma_flush = false;
+                count = abus_dma_write_count();
+                break;
+            }
+        }
+        abus_dma_read_count = count;
+
+        abus_busy(level, CYCLE_COUNTER_ELAPSED(batch_start, CYCLE_COUNTER_READ()));
+    }
+}
+#else
+void CORE1_CODE(abus_loop)()
+{
+    // initialize the Apple II bus interface
+    abus_init();
+
+    // cycle counter for the bus handler statistics
+    CYCLE_COUNTER_INIT();
+
     uint32_t value = 0;
 #if FEATURE_ABUS_DEBUG
     uint32_t idle_count = 0;
@@ -701,6 +907,11 @@ void __time_critical_func(abus_loop)()
 #endif
     while(1)
     {
+        // number of bus cycles waiting to be processed
+        uint_fast8_t fifo_level = abus_pio_fifo_level();
+        if (fifo_level > bus_fifo_high_water)
+            bus_fifo_high_water = fifo_level;
+
         if (abus_pio_is_full())
         {
             bus_overflow_counter++;
@@ -717,7 +928,11 @@ void __time_critical_func(abus_loop)()
 #endif
         }
 
+        uint32_t start = CYCLE_COUNTER_READ();
         abus_interface(value);
+        uint32_t cycles = CYCLE_COUNTER_ELAPSED(start, CYCLE_COUNTER_READ());
+        abus_statistics(value, cycles);
+        abus_busy(1, cycles);
 
 #ifdef FEATURE_ABUS_DEBUG
         if (idle_count < bus_overflow_counter)
@@ -726,3 +941,4 @@ void __time_critical_func(abus_loop)()
         bus_cycle_counter++;
     }
 }
+#endif
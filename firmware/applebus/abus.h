@@ -32,6 +32,7 @@ void abus_loop      (void);
 void abus_clear_fifo(void);
 #ifdef FEATURE_TEST
 void abus_interface (uint32_t value);
+void abus_interface_timed(uint32_t value);
 #endif
 
 #define ACCESS_WRITE(value)    ((value & (1u << (CONFIG_PIN_APPLEBUS_RW     - CONFIG_PIN_APPLEBUS_DATA_BASE))) == 0)
@@ -35,6 +35,14 @@ SOFTWARE.
 #error CONFIG_PIN_APPLEBUS_PHI0 and PHI0_GPIO must be set to the same pin
 #endif
 
+#ifdef FEATURE_ABUS_DMA
+// the DMA ring buffer must be aligned to its size (in core 1's RAM bank, next to the shadow memory)
+uint32_t __attribute__((section (".appledata."), aligned(ABUS_DMA_RING_SIZE*4))) abus_dma_ring[ABUS_DMA_RING_SIZE];
+int      abus_dma_channel;
+static int      abus_dma_control_channel;
+static uint32_t abus_dma_pass_words = ABUS_DMA_PASS_WORDS;
+#endif
+
 void a2dvi_check_hardware(void)
 {
     // initialize transceiver GPIOs
@@ -65,10 +73,23 @@ void abus_pio_setup(void)
     const uint sm = ABUS_MAIN_SM;
     const uint32_t control_bit_count = 3;
 
+#ifdef FEATURE_ABUS_FILTER
+    // filtering program: located at address 0 (jump table)
+    uint program_offset = pio_add_program(pio, &abus_filter_program);
+    uint entry_offset   = program_offset + abus_filter_offset_entry;
+    pio_sm_claim(pio, sm);
+
+    pio_sm_config pio_cfg = abus_filter_program_get_default_config(program_offset);
+
+    // AddrHi is shifted out to the program counter, starting with the lowest bit
+    sm_config_set_out_shift(&pio_cfg, true, false, 32);
+#else
     uint program_offset = pio_add_program(pio, &abus_program);
+    uint entry_offset   = program_offset;
     pio_sm_claim(pio, sm);
 
     pio_sm_config pio_cfg = abus_program_get_default_config(program_offset);
+#endif
 
     // set the bus R/W pin as the jump pin
     sm_config_set_jmp_pin(&pio_cfg, CONFIG_PIN_APPLEBUS_RW);
@@ -85,7 +106,12 @@ void abus_pio_setup(void)
     // no divider, run at full speed
     sm_config_set_clkdiv_int_frac(&pio_cfg, 1, 0);
 
-    pio_sm_init(pio, sm, program_offset, &pio_cfg);
+#ifdef FEATURE_ABUS_DMA
+    // the state machine only uses the RX FIFO: join both FIFOs to buffer 8 cycles while the DMA is restarted
+    sm_config_set_fifo_join(&pio_cfg, PIO_FIFO_JOIN_RX);
+#endif
+
+    pio_sm_init(pio, sm, entry_offset, &pio_cfg);
 
     // configure the GPIOs
     // Ensure all transceivers will start disabled. Set data direction to input (low).
@@ -113,5 +139,40 @@ void abus_pio_setup(void)
         gpio_set_pulls(pin, false, false);
     }
 
+#ifdef FEATURE_ABUS_DMA
+    abus_dma_setup();
+#endif
+
     pio_enable_sm_mask_in_sync(pio, (1 << ABUS_MAIN_SM));
 }
+
+#ifdef FEATURE_ABUS_DMA
+void abus_dma_setup(void)
+{
+    PIO pio = CONFIG_ABUS_PIO;
+
+    abus_dma_channel         = dma_claim_unused_channel(true);
+    abus_dma_control_channel = dma_claim_unused_channel(true);
+
+    // capture channel: copies the RX FIFO to the ring buffer, paced by the FIFO's DREQ
+    dma_channel_config cfg = dma_channel_get_default_config(abus_dma_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, false);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_ring(&cfg, true, ABUS_DMA_RING_BITS+2);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, ABUS_MAIN_SM, false));
+    channel_config_set_chain_to(&cfg, abus_dma_control_channel);
+    dma_channel_configure(abus_dma_channel, &cfg, abus_dma_ring, &pio->rxf[ABUS_MAIN_SM], ABUS_DMA_PASS_WORDS, false);
+
+    // control channel: restarts the capture channel after every pass (the write address
+    // is back at the start of the ring, since a pass is a multiple of the ring size)
+    dma_channel_config ctrl = dma_channel_get_default_config(abus_dma_control_channel);
+    channel_config_set_transfer_data_size(&ctrl, DMA_SIZE_32);
+    channel_config_set_read_increment(&ctrl, false);
+    channel_config_set_write_increment(&ctrl, false);
+    dma_channel_configure(abus_dma_control_channel, &ctrl, &dma_hw->ch[abus_dma_channel].al1_transfer_count_trig,
+        &abus_dma_pass_words, 1, false);
+
+    dma_channel_start(abus_dma_channel);
+}
+#endif
@@ -40,3 +40,29 @@ SOFTWARE.
 #define abus_pio_blocking_read()    (pio_sm_get_blocking(CONFIG_ABUS_PIO, ABUS_MAIN_SM))
 
 void abus_pio_setup(void);
+
+#ifdef FEATURE_ABUS_DMA
+#include <hardware/dma.h>
+
+// DMA capture ring for the RX FIFO, so bursts of bus cycles (accelerated machines)
+// are buffered in RAM instead of overflowing the PIO FIFO. Size in 32bit words.
+#define ABUS_DMA_RING_BITS          10
+#define ABUS_DMA_RING_SIZE          (1u << ABUS_DMA_RING_BITS)
+
+// The capture channel wraps around the ring ABUS_DMA_PASS_WORDS/ABUS_DMA_RING_SIZE
+// times before the control channel restarts it. Its transfer count is the number
+// of words written during the pass, so the reader sees when the DMA lapped it
+// (instead of a ring index, which wraps to a small fill level). Fits the 28 bit
+// transfer count of the RP2350: a pass takes more than a minute at 1MHz.
+#define ABUS_DMA_PASS_BITS          26
+#define ABUS_DMA_PASS_WORDS         (1u << ABUS_DMA_PASS_BITS)
+
+extern uint32_t abus_dma_ring[ABUS_DMA_RING_SIZE];
+extern int      abus_dma_channel;
+
+// number of words written by the DMA (modulo ABUS_DMA_PASS_WORDS), its lower
+// ABUS_DMA_RING_BITS bits are the ring index of the next entry
+#define abus_dma_write_count()      ((ABUS_DMA_PASS_WORDS - (uint32_t) dma_hw->ch[abus_dma_channel].transfer_count) & (ABUS_DMA_PASS_WORDS-1))
+
+void abus_dma_setup(void);
+#endif
@@ -25,6 +25,7 @@ SOFTWARE.
 */
 
 #include "buffers.h"
+#include "config/config.h"
 
 volatile uint32_t reset_counter;
 volatile uint32_t bus_cycle_counter;
@@ -34,10 +35,18 @@ volatile uint32_t devicereg_counter;
 volatile uint32_t devicemem_counter;
 volatile uint32_t vblank_counter;
 
-volatile uint16_t last_address_stack;
-volatile uint16_t last_address_pc;
-volatile uint16_t last_address_zp;
-volatile uint32_t last_read_address;
+// updated by core 1 for every bus cycle
+volatile uint32_t CORE1_DATA(bus_handler_histogram)[BUS_HANDLER_COUNT][BUS_HISTOGRAM_BUCKETS];
+volatile uint32_t CORE1_DATA(bus_handler_worst_cycles);
+volatile uint8_t  CORE1_DATA(bus_handler_worst);
+volatile uint16_t CORE1_DATA(bus_fifo_high_water);
+volatile uint32_t CORE1_DATA(bus_busy_cycles);
+volatile uint32_t CORE1_DATA(bus_busy_count);
+
+volatile uint16_t CORE1_DATA(last_address_stack);
+volatile uint16_t CORE1_DATA(last_address_pc);
+volatile uint16_t CORE1_DATA(last_address_zp);
+volatile uint32_t CORE1_DATA(last_read_address);
 
          uint32_t boot_time;
 #ifdef FEATURE_DEBUG_COUNTER
@@ -50,19 +59,39 @@ volatile uint32_t internal_flags = IFLAGS_INTERP_DGR | IFLAGS_INTERP_DHGR;
 
 volatile uint8_t  cardslot;
 
-uint8_t __attribute__((section (".appledata."))) apple_memory[MAX_ADDRESS];
-uint8_t __attribute__((section (".appledata."))) aux_memory[MAX_ADDRESS];
+uint8_t __attribute__((section (".appledata."))) apple_memory[SHADOW_MEMORY_SIZE];
+uint8_t __attribute__((section (".appledata."))) aux_memory[SHADOW_MEMORY_SIZE];
 
 uint8_t __attribute__((section (".appledata."))) status_line[4*40]; // 4 rows of 40 columns
 
-volatile uint8_t *text_p1 = apple_memory + 0x0400;
-volatile uint8_t *text_p2 = apple_memory + 0x0800;
-volatile uint8_t *text_p3 = aux_memory   + 0x0400;
-volatile uint8_t *text_p4 = aux_memory   + 0x0800;
-volatile uint8_t *hgr_p1  = apple_memory + 0x2000;
-volatile uint8_t *hgr_p2  = apple_memory + 0x4000;
-volatile uint8_t *hgr_p3  = aux_memory   + 0x2000;
-volatile uint8_t *hgr_p4  = aux_memory   + 0x4000;
+volatile uint8_t CORE1_DATA(screen_dirty_main)[SHADOW_BLOCK_COUNT] __attribute__((aligned(4)));
+volatile uint8_t CORE1_DATA(screen_dirty_aux)[SHADOW_BLOCK_COUNT]  __attribute__((aligned(4)));
+#ifdef FEATURE_FRAME_LATCH
+volatile uint8_t CORE1_DATA(shadow_dirty_main)[SHADOW_BLOCK_COUNT] __attribute__((aligned(4)));
+volatile uint8_t CORE1_DATA(shadow_dirty_aux)[SHADOW_BLOCK_COUNT]  __attribute__((aligned(4)));
+#endif
+
+#ifdef BEAM_TRACKING
+volatile uint32_t     CORE1_DATA(beam_frame_start);
+volatile bool         CORE1_DATA(beam_anchored);
+#endif
+
+#ifdef FEATURE_BEAM_TIMELINE
+volatile beam_event_t CORE1_DATA(beam_log)[BEAM_LOG_SIZE];
+volatile uint32_t     CORE1_DATA(beam_log_count);
+#endif
+
+volatile uint8_t *text_p1 = apple_memory + SHADOW_OFFSET(0x0400);
+volatile uint8_t *text_p2 = apple_memory + SHADOW_OFFSET(0x0800);
+volatile uint8_t *text_p3 = aux_memory   + SHADOW_OFFSET(0x0400);
+volatile uint8_t *text_p4 = aux_memory   + SHADOW_OFFSET(0x0800);
+volatile uint8_t *hgr_p1  = apple_memory + SHADOW_OFFSET(0x2000);
+volatile uint8_t *hgr_p2  = apple_memory + SHADOW_OFFSET(0x4000);
+volatile uint8_t *hgr_p3  = aux_memory   + SHADOW_OFFSET(0x2000);
+volatile uint8_t *hgr_p4  = aux_memory   + SHADOW_OFFSET(0x4000);
+
+volatile uint8_t  apple_tbcolor;
+volatile uint8_t  apple_border;
 
 // The currently programmed character generator ROMs for text mode (US + local char set)
 uint8_t __attribute__((section (".appledata."))) character_rom[2* CHARACTER_ROM_SIZE];
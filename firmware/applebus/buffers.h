@@ -27,6 +27,7 @@ SOFTWARE.
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 extern volatile uint32_t reset_counter;
 extern volatile uint32_t bus_cycle_counter;
@@ -36,6 +37,21 @@ extern volatile uint32_t devicereg_counter;
 extern volatile uint32_t devicemem_counter;
 extern volatile uint32_t vblank_counter;
 
+// bus handler statistics (core 1): CPU cycles spent for each bus cycle, as
+// histograms per bus_functions[] entry (card register accesses use the last entry)
+#define BUS_HANDLER_COUNT       (16*2+1)
+#define BUS_HANDLER_CARD_SELECT (16*2)
+#define BUS_HISTOGRAM_BUCKETS   8
+#define BUS_HISTOGRAM_SHIFT     5 /* 32 CPU cycles per bucket */
+
+extern volatile uint32_t bus_handler_histogram[BUS_HANDLER_COUNT][BUS_HISTOGRAM_BUCKETS];
+extern volatile uint32_t bus_handler_worst_cycles;
+extern volatile uint8_t  bus_handler_worst;
+extern volatile uint16_t bus_fifo_high_water;
+// CPU cycles spent for a number of bus cycles (moving average of the sustained bus cycle rate)
+extern volatile uint32_t bus_busy_cycles;
+extern volatile uint32_t bus_busy_count;
+
 extern volatile uint16_t last_address_stack;
 extern volatile uint16_t last_address_pc;
 extern volatile uint16_t last_address_zp;
@@ -52,8 +68,84 @@ extern volatile uint8_t  cardslot;
 
 #define MAX_ADDRESS (0x6000)
 
-extern uint8_t apple_memory[MAX_ADDRESS];
-extern uint8_t aux_memory[MAX_ADDRESS];
+// Compact shadow memory layout: only the display pages are backed by RAM,
+// the holes at $0000-$03FF and $0C00-$1FFF are dropped.
+//   $0400-$0BFF (text/lores pages 1+2) => $0000-$07FF
+//   $2000-$5FFF (hires pages 1+2)      => $0800-$47FF
+#define SHADOW_TEXT_START   (0x0400)
+#define SHADOW_TEXT_END     (0x0C00)
+#define SHADOW_HGR_START    (0x2000)
+#define SHADOW_HGR_END      (MAX_ADDRESS)
+#define SHADOW_HGR_OFFSET   (SHADOW_TEXT_END - SHADOW_TEXT_START)
+#define SHADOW_MEMORY_SIZE  (SHADOW_HGR_OFFSET + SHADOW_HGR_END - SHADOW_HGR_START)
+// RAM saved by the compact layout (main + aux memory): the heap extends up to
+// core 1's data (see linker scripts), so it gains these bytes
+#define SHADOW_SAVED_BYTES  (2*(MAX_ADDRESS - SHADOW_MEMORY_SIZE))
+
+// translate an Apple II address (within a display page) to the shadow memory offset
+#define SHADOW_OFFSET(address) (((address) < SHADOW_HGR_START) ? \
+                                ((address) - SHADOW_TEXT_START) : \
+                                ((address) - SHADOW_HGR_START + SHADOW_HGR_OFFSET))
+
+extern uint8_t apple_memory[SHADOW_MEMORY_SIZE];
+extern uint8_t aux_memory[SHADOW_MEMORY_SIZE];
+
+// Write tracking: one flag per 128 byte block of shadow memory, set by the bus
+// handler (core 1) after writing, cleared by the renderer (core 0) before
+// reading the block. Plain byte stores on either side, so no update is lost
+// without any locking. A block holds 3 text rows or 3 HGR lines.
+// screen_dirty_*: the TMDS line cache keeps the hash of unmodified lines (see
+// tmds_cache_line_hash).
+// shadow_dirty_*: the frame latch copies modified blocks (see render/render_latch.h).
+#define SHADOW_BLOCK_SHIFT  7
+#define SHADOW_BLOCK_COUNT  (SHADOW_MEMORY_SIZE >> SHADOW_BLOCK_SHIFT)
+extern volatile uint8_t screen_dirty_main[SHADOW_BLOCK_COUNT];
+extern volatile uint8_t screen_dirty_aux[SHADOW_BLOCK_COUNT];
+#ifdef FEATURE_FRAME_LATCH
+extern volatile uint8_t shadow_dirty_main[SHADOW_BLOCK_COUNT];
+extern volatile uint8_t shadow_dirty_aux[SHADOW_BLOCK_COUNT];
+#define SHADOW_MARK_DIRTY(bank, offset) \
+    do { screen_dirty_##bank[(offset) >> SHADOW_BLOCK_SHIFT] = 1; shadow_dirty_##bank[(offset) >> SHADOW_BLOCK_SHIFT] = 1; } while (0)
+#else
+#define SHADOW_MARK_DIRTY(bank, offset) screen_dirty_##bank[(offset) >> SHADOW_BLOCK_SHIFT] = 1
+#endif
+
+#if defined(FEATURE_BEAM_TIMELINE) || defined(FEATURE_GENLOCK)
+#define BEAM_TRACKING
+#endif
+
+#ifdef BEAM_TRACKING
+// Beam position of the Apple II (FEATURE_BEAM_TIMELINE, FEATURE_GENLOCK): core
+// 1 anchors the frame timing to the bus cycle of scanline 0 (see abus.c), the
+// position of any other bus cycle follows from the bus cycle counter.
+#define BEAM_CYCLES_PER_LINE  65
+#define BEAM_LINES_NTSC       262
+#define BEAM_LINES_PAL        312
+#define BEAM_VISIBLE_LINES    192
+
+extern volatile uint32_t     beam_frame_start; // bus cycle of a scanline 0
+extern volatile bool         beam_anchored;    // beam_frame_start is known
+#endif
+
+#ifdef FEATURE_BEAM_TIMELINE
+// Display soft switch log (see render/render_timeline.h): core 1 logs every
+// change of the display soft switches with its bus cycle, core 0 maps the log
+// to the scanlines of the last complete frame. The log is only written by
+// core 1: an entry is filled before the count is published.
+#define BEAM_LOG_SIZE         64 // entries, power of 2
+
+// soft switches selecting what is displayed
+#define SOFTSW_BEAM_MASK (SOFTSW_MODE_MASK|SOFTSW_PAGE_2|SOFTSW_80STORE|SOFTSW_80COL|SOFTSW_DGR|SOFTSW_V7_MODE3|SOFTSW_VIDEX_80COL)
+
+typedef struct
+{
+    uint32_t cycle;  // bus_cycle_counter when the soft switches changed
+    uint32_t softsw; // soft switches after the change
+} beam_event_t;
+
+extern volatile beam_event_t beam_log[BEAM_LOG_SIZE];
+extern volatile uint32_t     beam_log_count;   // number of logged changes (wraps)
+#endif
 
 extern uint8_t status_line[4*40]; // 4 rows of 40 columns
 
@@ -71,8 +163,9 @@ extern volatile uint8_t *hgr_p4;
 /* Videx VideoTerm */
 extern volatile uint8_t *videx_page;
 
-#define apple_tbcolor  apple_memory[0xC022]
-#define apple_border   apple_memory[0xC034]
+// IIgs text/background ($C022) and border ($C034) colors
+extern volatile uint8_t apple_tbcolor;
+extern volatile uint8_t apple_border;
 
 #if 0
 extern volatile uint8_t *baseio;
@@ -359,7 +359,7 @@ void config_load(void)
 
     if(IS_STORED_IN_CONFIG(cfg, video_mode))
     {
-        cfg_video_mode = cfg->video_mode & 1;
+        cfg_video_mode = (cfg->video_mode < DviModeCount) ? cfg->video_mode : Dvi640x480;
     }
 
     if(IS_STORED_IN_CONFIG(cfg, pal_enabled))
@@ -442,7 +442,7 @@ void DELAYED_COPY_CODE(config_save)(void)
     new_config->rendering_fx            = cfg_rendering_fx;
     new_config->color_style             = cfg_color_style;
     new_config->color_mode              = color_mode;
-    new_config->video_mode              = cfg_video_mode & 1;
+    new_config->video_mode              = cfg_video_mode & ~DviModeChange;
     new_config->machine_type            = (cfg_machine>MACHINE_AUTO) ? cfg_machine-1 : 0xff; // old encoding
     new_config->local_charset           = cfg_local_charset;
     new_config->alt_charset             = cfg_alt_charset;
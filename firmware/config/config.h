@@ -53,9 +53,13 @@ typedef enum {
 
 typedef enum
 {
-    Dvi640x480   = 0,
-    Dvi720x480   = 1,
-    DviInvalid   = 0xff
+    Dvi640x480    = 0,
+    Dvi720x480    = 1,
+    Dvi720x576    = 2,    // 50Hz, for PAL machines
+    Dvi800x480    = 3,    // native resolution of small HDMI panels
+    DviModeCount  = 4,
+    DviModeChange = 0x10, // flag: the menu requested a mode change
+    DviInvalid    = 0xff
 } DviVideoMode_t;
 
 typedef enum
@@ -125,6 +129,13 @@ extern volatile uint8_t color_mode;
     #define DELAYED_COPY_DATA(n) n
 #endif
 
+// bus handlers and their data, placed next to the Apple II shadow memory (RAM bank of core 1)
+#define CORE1_CODE(n) __noinline __attribute__((section(".core1_code."))) n
+#define CORE1_DATA(n) __attribute__((section(".core1_data."))) n
+extern void* __ram_core1_copy_source__[];
+extern void* __ram_core1_copy_start__[];
+extern void* __ram_core1_copy_end__[];
+
 extern void set_machine         (compat_t machine);
 extern void config_load         (void);
 extern void config_load_defaults(void);
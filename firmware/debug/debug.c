@@ -165,11 +165,11 @@ void __no_inline_not_in_flash_func(debug_check_bootsel)()
 }
 #endif
 
-// total size of heap
+// total size of heap (up to the start of core 1's data, see linker scripts)
 uint32_t getTotalHeap(void)
 {
-   extern char __StackLimit, __bss_end__;
-   return &__StackLimit  - &__bss_end__;
+   extern char __StackLimit, __end__;
+   return &__StackLimit  - &__end__;
 }
 
 // available heap size
@@ -25,6 +25,19 @@
 
 #include "hardware/structs/systick.h"
 
+// free-running cycle counter (the systick timer is separate for each core)
+#define CYCLE_COUNTER_INIT() \
+{\
+	systick_hw->csr = 0x5;\
+	systick_hw->rvr = 0x00FFFFFF;\
+}
+
+// current counter value (count-down timer)
+#define CYCLE_COUNTER_READ() (systick_hw->cvr)
+
+// elapsed CPU cycles between two counter values
+#define CYCLE_COUNTER_ELAPSED(Start, End) (((Start)-(End)) & 0x00FFFFFF)
+
 #ifdef FUNCTION_PROFILER
 
 	// enable systick timer, use CPU clock source, keep timer exception disabled
@@ -28,16 +28,30 @@ SOFTWARE.
 #include "dvi.h"
 #include "tmds.h"
 #include "dvi_pin_config.h"
+#ifndef FEATURE_HSTX
 #include "dvi_serialiser.h"
 #include "dvi_timing.h"
+#endif
+#include "genlock.h"
+#include "applebus/buffers.h"
 #include "render/render.h"
 #include "util/dmacopy.h"
 #include "config/config.h"
 #include "debug/debug.h"
 
+#ifdef FEATURE_HSTX
+#define DVI_SERIAL_CONFIG pico_a2dvi_hstx_cfg
+#else
 #define DVI_SERIAL_CONFIG pico_a2dvi_cfg
+#endif
 
-struct dvi_inst __attribute__((section (".appledata."))) dvi0;
+// widest scanline buffer: 8 of them (3 channels, 2 pixels per word) must leave
+// enough heap for the line cache
+#define A2DVI_MAX_X_RESOLUTION 720
+
+// DVI state, including the DMA control block lists: in core 0's RAM (the DVI
+// IRQ and DMA must not contend with core 1 in its SRAM bank)
+struct dvi_inst dvi0;
 
 static void a2dvi_init(void)
 {
@@ -62,21 +76,58 @@ void DELAYED_COPY_CODE(a2dvi_dvi_enable)(uint32_t video_mode)
     {
         if (current_video_mode == video_mode)
             return;
+        // waiting index lines are sent and cached lines returned, before the DVI buffers are freed
+        tmds_mono_release();
+        tmds_index_release();
+        tmds_cache_release();
         dvi_destroy(&dvi0, DMA_IRQ_0);
     }
 
     // remember current mode
     current_video_mode = video_mode;
 
-    // select timing
-    struct dvi_timing* p_dvi_timing = (video_mode == Dvi720x480) ? &dvi_timing_720x480p_60hz : &dvi_timing_640x480p_60hz;
+    // select timing (the system clock follows the bit clock)
+    struct dvi_timing* p_dvi_timing;
+    switch (video_mode)
+    {
+        case Dvi720x480:
+            p_dvi_timing = &dvi_timing_720x480p_60hz;
+            break;
+        case Dvi720x576:
+            p_dvi_timing = &dvi_timing_720x576p_50hz;
+            break;
+        case Dvi800x480:
+            p_dvi_timing = &dvi_timing_800x480p_60hz;
+            break;
+        default:
+            p_dvi_timing = &dvi_timing_640x480p_60hz;
+            break;
+    }
 
     // configure DVI
     set_sys_clock_khz(p_dvi_timing->bit_clk_khz, true);
-    DVI_INIT_RESOLUTION(p_dvi_timing->h_active_pixels);
+    // wider modes only get black borders (from the DMA), not wider scanline buffers
+    uint32_t x_resolution = p_dvi_timing->h_active_pixels;
+    if (x_resolution > A2DVI_MAX_X_RESOLUTION)
+        x_resolution = A2DVI_MAX_X_RESOLUTION;
+    DVI_INIT_RESOLUTION(x_resolution);
     dvi0.timing = p_dvi_timing;
+    dvi0.h_border = (p_dvi_timing->h_active_pixels - x_resolution) / 2;
     dvi0.ser_cfg = &DVI_SERIAL_CONFIG;
     dvi_init(&dvi0, spinlock1, spinlock2);
+#ifdef FEATURE_GENLOCK
+    // sample the Apple II beam position at the start of each DVI frame
+    dvi0.frame_stamp_src = &bus_cycle_counter;
+    genlock_init();
+#endif
+    // frame latch snapshot (only allocated once), before the line cache sizes itself
+    render_latch_init();
+    // index lines (only allocated while a mode renders them, see tmds_index_start_frame)
+    tmds_index_init();
+    // line cache uses the remaining heap, after the DVI buffers were allocated
+    tmds_cache_init();
+    // monochrome encoder uses a spare state machine of the DVI PIO
+    tmds_mono_init();
     dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
     dvi_start(&dvi0);
 }
@@ -103,7 +154,15 @@ void DELAYED_COPY_CODE(a2dvi_loop)(void)
     __builtin_unreachable();
 }
 
-uint32_t DELAYED_COPY_CODE(a2dvi_scanline_errors)(void)
+uint32_t DELAYED_COPY_CODE(a2dvi_lines_per_frame)(void)
+{
+    const struct dvi_timing* t = dvi0.timing;
+    return t->v_front_porch + t->v_sync_width + t->v_back_porch + t->v_active_lines;
+}
+
+uint32_t DELAYED_COPY_CODE(a2dvi_scanline_errors)(uint32_t* recovered)
 {
+    if (recovered)
+        *recovered = dvi0.scanline_recovered;
     return dvi0.scanline_errors;
 }
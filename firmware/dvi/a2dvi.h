@@ -27,4 +27,8 @@ SOFTWARE.
 void     a2dvi_dvi_enable     (uint32_t video_mode);
 void     a2dvi_loop           (void);
 void     a2dvi_check_hardware (void);
-uint32_t a2dvi_scanline_errors(void);
+// DVI lines per frame (including blanking) of the current video mode
+uint32_t a2dvi_lines_per_frame(void);
+// scanlines which missed their display lines (the last line was repeated instead),
+// and, optionally, late scanlines which were recovered for their repeated display line
+uint32_t a2dvi_scanline_errors(uint32_t* recovered);
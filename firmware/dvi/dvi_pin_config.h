@@ -5,11 +5,25 @@
 // developing on. It's not a particularly important file -- just saves some
 // copy + paste.
 
-#include "dvi_serialiser.h"
-
 // ----------------------------------------------------------------------------
 // PicoDVI boards
 
+#ifdef FEATURE_HSTX
+
+// A2DVI with HSTX output (RP2350): HSTX is only available on GPIO 12..19, so
+// D0 is expected on GPIO 12/13 (instead of 20/21). On the original A2DVI
+// boards GPIO 12/13 are Apple II bus control inputs, so this needs a board
+// revision.
+static struct dvi_hstx_cfg DELAYED_COPY_DATA(pico_a2dvi_hstx_cfg) = {
+	.bits_tmds = {0, 6, 4},
+	.bits_clk = 2,
+	.invert_diffpairs = false
+};
+
+#else
+
+#include "dvi_serialiser.h"
+
 // Ralle Palaveev A2DVI
 static struct dvi_serialiser_cfg DELAYED_COPY_DATA(pico_a2dvi_cfg) = {
 	.pio = pio1,
@@ -19,4 +33,6 @@ static struct dvi_serialiser_cfg DELAYED_COPY_DATA(pico_a2dvi_cfg) = {
 	.invert_diffpairs = false
 };
 
+#endif // FEATURE_HSTX
+
 #endif
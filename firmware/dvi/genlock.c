@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "tmds.h"
+#include "tmds_index.h"
+#include "genlock.h"
+
+#ifdef FEATURE_GENLOCK
+
+// Apple II bus clock (Hz): 14.31818MHz (NTSC) or 14.25045MHz (PAL) divided by
+// 14, with every 65th cycle stretched by 2 clocks
+#define APPLE_CLOCK_NTSC 1020484
+#define APPLE_CLOCK_PAL  1015625
+
+// margin of the DVI beam behind the rendered scanlines (Apple scanlines)
+#define GENLOCK_MARGIN_LINES 2
+
+uint32_t genlock_latency = GENLOCK_LATENCY_UNKNOWN;
+bool     genlock_locked;
+
+static uint32_t DELAYED_COPY_DATA(genlock_frame_count);
+
+// distance of the DVI beam behind the Apple beam (Apple scanlines): the renderer
+// works as many DVI buffers ahead of the output as are queued, the TMDS buffers
+// plus the index lines waiting for expansion (see tmds_index.h), and each
+// buffer covers 1/DVI_VERTICAL_REPEAT of an Apple scanline
+static inline uint32_t genlock_target_lines(void)
+{
+    return (DVI_N_TMDS_BUFFERS + tmds_index_queued()) / DVI_VERTICAL_REPEAT + GENLOCK_MARGIN_LINES;
+}
+
+void DELAYED_COPY_CODE(genlock_init)(void)
+{
+    genlock_frame_count = dvi0.frame_count;
+    genlock_latency     = GENLOCK_LATENCY_UNKNOWN;
+    genlock_locked      = false;
+}
+
+void DELAYED_COPY_CODE(genlock_frame)(void)
+{
+    // bus cycle at the start of the current DVI frame (retry when the interrupt
+    // started the next frame in between)
+    uint32_t count, stamp;
+    do
+    {
+        count = dvi0.frame_count;
+        stamp = dvi0.frame_stamp;
+    } while (count != dvi0.frame_count);
+
+    if (count == genlock_frame_count)
+        return;
+    genlock_frame_count = count;
+
+    if ((!beam_anchored)||(dvi0.frame_stamp_src == NULL))
+    {
+        genlock_latency = GENLOCK_LATENCY_UNKNOWN;
+        genlock_locked  = false;
+        return;
+    }
+
+    bool     pal          = IS_IFLAG(IFLAGS_PAL);
+    uint32_t apple_clock  = (pal) ? APPLE_CLOCK_PAL : APPLE_CLOCK_NTSC;
+    uint32_t apple_frame  = ((pal) ? BEAM_LINES_PAL : BEAM_LINES_NTSC) * BEAM_CYCLES_PER_LINE;
+
+    // DVI line and frame period, in Apple II bus cycles
+    const struct dvi_timing* t = dvi0.timing;
+    uint32_t h_total      = t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+    uint32_t v_total      = t->v_front_porch + t->v_sync_width + t->v_back_porch + t->v_active_lines;
+    uint64_t pixel_clock  = (uint64_t) t->bit_clk_khz * 100; // 10 bits per pixel
+    uint32_t line_cycles  = (uint32_t) ((uint64_t) h_total * apple_clock / pixel_clock);
+    uint32_t dvi_frame    = (uint32_t) ((uint64_t) h_total * v_total * apple_clock / pixel_clock);
+
+    // bus cycle when the DVI outputs Apple scanline 0 (the image is centered vertically)
+    uint32_t image_offset = (t->v_active_lines - DVI_VERTICAL_REPEAT*BEAM_VISIBLE_LINES) / 2 * line_cycles;
+
+    // distance of the DVI beam behind the Apple beam
+    uint32_t phase = (stamp + image_offset - beam_frame_start) % apple_frame;
+    genlock_latency = phase * 10000 / apple_clock;
+
+    // the line adjustment can only compensate small differences of the frame rates
+    int32_t period_error = (int32_t) dvi_frame - (int32_t) apple_frame;
+    int32_t max_error    = GENLOCK_MAX_ADJUST * line_cycles / 2;
+    if ((period_error > max_error)||(period_error < -max_error))
+    {
+        genlock_locked = false;
+        return;
+    }
+
+    // shorter/longer DVI frame when the DVI beam is too far behind/ahead
+    int32_t error = (int32_t) phase - (int32_t) (genlock_target_lines()*BEAM_CYCLES_PER_LINE);
+    if (error > (int32_t) apple_frame/2)
+        error -= apple_frame;
+    int32_t adjust = -error / (int32_t) line_cycles;
+    if (adjust > GENLOCK_MAX_ADJUST)
+        adjust = GENLOCK_MAX_ADJUST;
+    if (adjust < -GENLOCK_MAX_ADJUST)
+        adjust = -GENLOCK_MAX_ADJUST;
+
+    // the interrupt clears the adjustment once it was applied to a back porch
+    if ((adjust)&&(dvi0.timing_state.v_adjust == 0))
+        dvi0.timing_state.v_adjust = adjust;
+
+    genlock_locked = (error <= (int32_t) (GENLOCK_MAX_ADJUST*line_cycles))&&
+                     (error >= -(int32_t) (GENLOCK_MAX_ADJUST*line_cycles));
+}
+
+#endif // FEATURE_GENLOCK
@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Genlock (FEATURE_GENLOCK).
+//
+// The DVI output free-runs at 59.94Hz, the Apple II at 59.92Hz (NTSC), so the
+// output frames slowly drift against the Apple's frames: the tear between
+// old and new image data rolls through the picture, and a bus write takes
+// anywhere up to a full frame until it is shown.
+//
+// The DVI interrupt samples the bus cycle counter when the active area of a
+// DVI frame starts. Since the beam position of the Apple II is known from the
+// bus cycle counter (once anchored by the $C019 VBL polling of the running
+// program, see beam_frame_start in buffers.h), this gives the phase of each
+// DVI frame against the Apple frame. Once per DVI frame, the controller moves
+// the start of the next DVI frame by a line or two (vertical back porch), so
+// the DVI beam follows the Apple beam at a fixed distance: a few scanlines,
+// just enough for the renderer, which works as many queued DVI buffers ahead
+// of the output (TMDS buffers, plus the index lines while they are in use).
+//
+// Only locks when both frame rates match (a PAL Apple II needs the 50Hz video
+// mode, Dvi720x576). Displays must accept a vertical total varying by up to
+// GENLOCK_MAX_ADJUST lines.
+
+#ifdef FEATURE_GENLOCK
+
+// maximum adjustment of a DVI frame (lines)
+#define GENLOCK_MAX_ADJUST 2
+
+// latency of a bus write to the display (bus write at a scanline to the DVI
+// output of the same scanline), in 0.1ms, or GENLOCK_LATENCY_UNKNOWN
+#define GENLOCK_LATENCY_UNKNOWN 0xffffffff
+extern uint32_t genlock_latency;
+// the DVI frames follow the Apple II frames
+extern bool     genlock_locked;
+
+// start sampling the frame phase (after the DVI was (re)initialized)
+extern void genlock_init(void);
+// adjust the next DVI frame (called once per rendered frame)
+extern void genlock_frame(void);
+
+#else
+
+#define genlock_init()
+#define genlock_frame()
+
+#endif
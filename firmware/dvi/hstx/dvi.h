@@ -0,0 +1,160 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// HSTX replacement for libdvi's dvi.h (FEATURE_HSTX builds): keeps the scanline
+// queue interface and the dvi_init/dvi_start/dvi_destroy calls of libdvi, but
+// the scanlines are sent by the RP2350 HSTX peripheral (see dvi/hstx_dvi.c),
+// instead of the PIO serialiser.
+
+#ifndef _DVI_H
+#define _DVI_H
+
+#include "pico/util/queue.h"
+#include "util_queue_u32_inline.h"
+
+#define DELAYED_COPY_CODE(n) __noinline __attribute__((section(".delayed_code."))) n
+#define DELAYED_COPY_DATA(n) __attribute__((section(".delayed_data."))) n
+
+#define N_TMDS_LANES 3
+
+// each scanline buffer is displayed twice (the Apple II has 192 or 224 lines)
+#define DVI_VERTICAL_REPEAT 2
+
+#ifndef DVI_N_TMDS_BUFFERS
+#define DVI_N_TMDS_BUFFERS 3
+#endif
+
+struct dvi_timing {
+    bool h_sync_polarity;
+    uint h_front_porch;
+    uint h_sync_width;
+    uint h_back_porch;
+    uint h_active_pixels;
+
+    bool v_sync_polarity;
+    uint v_front_porch;
+    uint v_sync_width;
+    uint v_back_porch;
+    uint v_active_lines;
+
+    uint bit_clk_khz;
+};
+
+enum dvi_line_state {
+    DVI_STATE_FRONT_PORCH = 0,
+    DVI_STATE_SYNC,
+    DVI_STATE_BACK_PORCH,
+    DVI_STATE_ACTIVE,
+    DVI_STATE_COUNT
+};
+
+struct dvi_timing_state {
+    uint v_ctr;
+    enum dvi_line_state v_state;
+    // lines added to (or removed from) the next vertical back porch, for
+    // pacing the frames to an external source (cleared once applied)
+    volatile int v_adjust;
+};
+
+// HSTX output bits (GPIO 12 + bit) of the TMDS lanes and the clock. Each pair
+// uses two adjacent bits, the positive signal on the lower bit (unless inverted).
+struct dvi_hstx_cfg {
+    uint bits_tmds[N_TMDS_LANES];
+    uint bits_clk;
+    bool invert_diffpairs;
+};
+
+struct dvi_inst {
+    // Config ---
+    const struct dvi_timing *timing;
+    struct dvi_timing_state timing_state;
+    struct dvi_hstx_cfg* ser_cfg;
+    // Black border left and right of the scanline buffers, output by HSTX
+    // commands (pixels, even): the scanline buffers are h_active_pixels - 2*h_border wide
+    uint h_border;
+
+    // State ---
+    // ping-pong DMA channels feeding the HSTX FIFO, and their DMA IRQ
+    int dma_chan[2];
+    uint dma_next;
+    uint dma_irq_index;
+    // command lists: vertical blanking with/without sync, active line (with the
+    // left border, followed by the RGB332 pixels) and blank active line. Each
+    // list starts with the right border of the previous line, which is skipped
+    // unless that line had pixels (see hstx_dma_irq).
+    uint32_t cmd_vblank_sync[9];
+    uint32_t cmd_vblank_nosync[9];
+    uint32_t cmd_active[11];
+    uint32_t cmd_active_blank[10];
+    // RGB332 pixels to follow the active line's command list
+    const uint32_t *pixels_pending;
+    uint pixel_words;
+    // the right border is due before the next command list
+    bool h_border_pending;
+    // Scanline buffer displayed by the current line (kept for the repeated line)
+    uint32_t *tmds_buf_last;
+    // Scanline buffer to pass back to the free queue: the DMA may still read it
+    // for the line being sent, so it is released one line later
+    uint32_t *tmds_buf_release;
+
+    // Scanlines missed entirely (counting up): the source skips as many lines
+    // (see tmds_cache_skip_line), so the following ones keep their position
+    volatile uint32_t scanline_skip;
+    // count production errors (scanlines were not ready in time)
+    uint32_t scanline_errors;
+    // count scanlines which were late for their first, but ready for their
+    // repeated display line (the last line was shown once more instead)
+    uint32_t scanline_recovered;
+    bool scanline_stale;
+    // enable/disable scan line emulation (alternating blank lines)
+    uint8_t scanline_emulation;
+    // Frame pacing: *frame_stamp_src is sampled when the active area of a
+    // frame starts (optional, e.g. a counter of the source's clock)
+    const volatile uint32_t *frame_stamp_src;
+    volatile uint32_t frame_stamp;
+    volatile uint32_t frame_count;
+
+    // Rendered scanlines (RGB332 pixels, see hstx_line.h):
+    queue_t q_tmds_valid;
+    queue_t q_tmds_free;
+};
+
+extern struct dvi_timing dvi_timing_640x480p_60hz;
+extern struct dvi_timing dvi_timing_720x480p_60hz;
+extern struct dvi_timing dvi_timing_720x576p_50hz;
+extern struct dvi_timing dvi_timing_800x480p_60hz;
+
+// Set up data structures and hardware for DVI.
+void dvi_init(struct dvi_inst *inst, uint spinlock_tmds_queue, uint spinlock_colour_queue);
+
+void dvi_destroy(struct dvi_inst *inst, uint irq_num);
+
+// Call this after calling dvi_init(). DVI DMA interrupts will be routed to
+// whichever core called this function. Registers an exclusive IRQ handler.
+void dvi_register_irqs_this_core(struct dvi_inst *inst, uint irq_num);
+
+// Start the HSTX output. Call this once you have initialised the DVI, have
+// registered the IRQs, and are producing rendered scanlines.
+void dvi_start(struct dvi_inst *inst);
+
+#endif
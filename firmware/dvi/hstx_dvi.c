@@ -0,0 +1,533 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// DVI output through the RP2350 HSTX peripheral (FEATURE_HSTX builds).
+//
+// HSTX has its own TMDS encoder: it is fed with a stream of commands (raw
+// control symbols for the blanking periods, RGB332 pixels to be TMDS encoded
+// for the active lines) by two DMA channels, which alternately reload each
+// other. The DMA interrupt prepares the transfer after next: when a command
+// list for an active line is set up, the scanline buffer is taken from the DVI
+// queue, and its RGB332 pixels (see hstx_line.h) are sent as they are, by the
+// following transfer. The buffer is kept for the repeated line, and goes back
+// to the free queue one line after it was last sent.
+//
+// The scanline queues work as with libdvi: each buffer is shown for
+// DVI_VERTICAL_REPEAT lines, within the letter box of the Apple II screen area.
+// With a horizontal border (h_border), the scanline buffers only cover the
+// centre of the active line: the borders are black TMDS_REPEAT commands, the
+// left one in the active line's command list, the right one at the start of
+// the next command list.
+
+#include <stdlib.h>
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/structs/hstx_ctrl.h"
+#include "hardware/structs/hstx_fifo.h"
+
+#include "dvi.h"
+#include "tmds.h"
+#include "hstx_line.h"
+
+// Apple II screen area (including the border of the debug lines)
+#define A2DVI_SCANLINES (2*192 + 4*16)
+
+// HSTX commands
+#define HSTX_CMD_RAW_REPEAT  (0x1u << 12)
+#define HSTX_CMD_TMDS        (0x2u << 12)
+#define HSTX_CMD_TMDS_REPEAT (0x3u << 12)
+#define HSTX_CMD_NOP         (0xfu << 12)
+
+// TMDS control symbols (C1: vsync, C0: hsync)
+#define TMDS_CTRL_00 0x354u
+#define TMDS_CTRL_01 0x0abu
+#define TMDS_CTRL_10 0x154u
+#define TMDS_CTRL_11 0x2abu
+
+// words of the right border at the start of each command list
+#define HSTX_CMD_BORDER_WORDS 2
+
+// HSTX output bits start at GPIO 12
+#define HSTX_FIRST_GPIO 12
+
+// VGA: clk_sys at 252 MHz, HSTX at 126 MHz (two bits per clock)
+struct dvi_timing DELAYED_COPY_DATA(dvi_timing_640x480p_60hz) = {
+    .h_sync_polarity   = false,
+    .h_front_porch     = 16,
+    .h_sync_width      = 96,
+    .h_back_porch      = 48,
+    .h_active_pixels   = 640,
+
+    .v_sync_polarity   = false,
+    .v_front_porch     = 10,
+    .v_sync_width      = 2,
+    .v_back_porch      = 33,
+    .v_active_lines    = 480,
+
+    .bit_clk_khz       = 252000
+};
+
+// 720x480p 60 Hz: clk_sys at 270 MHz, HSTX at 135 MHz
+struct dvi_timing DELAYED_COPY_DATA(dvi_timing_720x480p_60hz) = {
+    .h_sync_polarity   = false,
+    .h_front_porch     = 16,
+    .h_sync_width      = 62,
+    .h_back_porch      = 60,
+    .h_active_pixels   = 720,
+
+    .v_sync_polarity   = false,
+    .v_front_porch     = 9,
+    .v_sync_width      = 6,
+    .v_back_porch      = 30,
+    .v_active_lines    = 480,
+
+    .bit_clk_khz       = 270000
+};
+
+// 720x576p 50 Hz: clk_sys at 270 MHz, HSTX at 135 MHz. 624 instead of 625 lines,
+// matching the frame rate of a PAL Apple II exactly (see libdvi's dvi_timing.c)
+struct dvi_timing DELAYED_COPY_DATA(dvi_timing_720x576p_50hz) = {
+    .h_sync_polarity   = false,
+    .h_front_porch     = 12,
+    .h_sync_width      = 64,
+    .h_back_porch      = 68,
+    .h_active_pixels   = 720,
+
+    .v_sync_polarity   = false,
+    .v_front_porch     = 5,
+    .v_sync_width      = 5,
+    .v_back_porch      = 38,
+    .v_active_lines    = 576,
+
+    .bit_clk_khz       = 270000
+};
+
+// 800x480p 60 Hz (`cvt 800 480 60`): clk_sys at 295.2 MHz, HSTX at 147.6 MHz
+struct dvi_timing DELAYED_COPY_DATA(dvi_timing_800x480p_60hz) = {
+    .h_sync_polarity   = false,
+    .h_front_porch     = 24,
+    .h_sync_width      = 72,
+    .h_back_porch      = 96,
+    .h_active_pixels   = 800,
+
+    .v_sync_polarity   = true,
+    .v_front_porch     = 3,
+    .v_sync_width      = 10,
+    .v_back_porch      = 7,
+    .v_active_lines    = 480,
+
+    .bit_clk_khz       = 295200
+};
+
+static struct dvi_inst* DELAYED_COPY_DATA(hstx_irq_inst);
+
+static uint32_t DELAYED_COPY_DATA(hstx_ctrl_symbols)[4] = {TMDS_CTRL_00, TMDS_CTRL_01, TMDS_CTRL_10, TMDS_CTRL_11};
+
+// raw control symbols for all lanes: sync levels on lane 0, lanes 1 and 2 are idle
+static uint32_t DELAYED_COPY_CODE(hstx_sync)(const struct dvi_timing* t, bool vsync, bool hsync)
+{
+    uint v = (vsync) ? t->v_sync_polarity : !t->v_sync_polarity;
+    uint h = (hsync) ? t->h_sync_polarity : !t->h_sync_polarity;
+    return hstx_ctrl_symbols[(v << 1) | h] | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20);
+}
+
+// horizontal blanking: front porch, sync, back porch (6 words)
+static uint32_t* DELAYED_COPY_CODE(hstx_cmd_hblank)(uint32_t* cmd, const struct dvi_timing* t, bool vsync, uint back_porch)
+{
+    *(cmd++) = HSTX_CMD_RAW_REPEAT | t->h_front_porch;
+    *(cmd++) = hstx_sync(t, vsync, false);
+    *(cmd++) = HSTX_CMD_RAW_REPEAT | t->h_sync_width;
+    *(cmd++) = hstx_sync(t, vsync, true);
+    *(cmd++) = HSTX_CMD_RAW_REPEAT | back_porch;
+    *(cmd++) = hstx_sync(t, vsync, false);
+    return cmd;
+}
+
+// right border of the previous line: black pixels (2 words, skipped unless the previous line had pixels)
+static uint32_t* DELAYED_COPY_CODE(hstx_cmd_border)(uint32_t* cmd, uint h_border)
+{
+    *(cmd++) = (h_border) ? HSTX_CMD_TMDS_REPEAT | h_border : HSTX_CMD_NOP;
+    *(cmd++) = (h_border) ? 0 : HSTX_CMD_NOP;
+    return cmd;
+}
+
+static void DELAYED_COPY_CODE(hstx_cmd_init)(struct dvi_inst *inst)
+{
+    const struct dvi_timing* t = inst->timing;
+    uint32_t* cmd;
+
+    // vertical blanking: the back porch continues over the active area
+    cmd = hstx_cmd_border(inst->cmd_vblank_sync, inst->h_border);
+    cmd = hstx_cmd_hblank(cmd, t, true, t->h_back_porch + t->h_active_pixels);
+    *cmd = HSTX_CMD_NOP;
+    cmd = hstx_cmd_border(inst->cmd_vblank_nosync, inst->h_border);
+    cmd = hstx_cmd_hblank(cmd, t, false, t->h_back_porch + t->h_active_pixels);
+    *cmd = HSTX_CMD_NOP;
+
+    // active line: left border, the pixels follow in a separate transfer
+    cmd = hstx_cmd_border(inst->cmd_active, inst->h_border);
+    cmd = hstx_cmd_hblank(cmd, t, false, t->h_back_porch);
+    if (inst->h_border)
+    {
+        *(cmd++) = HSTX_CMD_TMDS_REPEAT | inst->h_border;
+        *(cmd++) = 0;
+    }
+    else
+    {
+        *(cmd++) = HSTX_CMD_NOP;
+        *(cmd++) = HSTX_CMD_NOP;
+    }
+    *cmd = HSTX_CMD_TMDS | (t->h_active_pixels - 2*inst->h_border);
+
+    // blank active line (overscan, scanline emulation, late scanlines): black pixels
+    cmd = hstx_cmd_border(inst->cmd_active_blank, inst->h_border);
+    cmd = hstx_cmd_hblank(cmd, t, false, t->h_back_porch);
+    *(cmd++) = HSTX_CMD_TMDS_REPEAT | t->h_active_pixels;
+    *cmd     = 0;
+}
+
+static void DELAYED_COPY_CODE(hstx_timing_advance)(const struct dvi_timing *t, struct dvi_timing_state *s)
+{
+    s->v_ctr++;
+    if ((s->v_state == DVI_STATE_FRONT_PORCH && s->v_ctr == t->v_front_porch) ||
+        (s->v_state == DVI_STATE_SYNC && s->v_ctr == t->v_sync_width) ||
+        (s->v_state == DVI_STATE_BACK_PORCH && s->v_ctr >= t->v_back_porch + s->v_adjust) ||
+        (s->v_state == DVI_STATE_ACTIVE && s->v_ctr == t->v_active_lines))
+    {
+        if (s->v_state == DVI_STATE_BACK_PORCH)
+            s->v_adjust = 0;
+        s->v_state = (s->v_state + 1) % DVI_STATE_COUNT;
+        s->v_ctr = 0;
+    }
+}
+
+// RGB332 pixels of the current active line (NULL for a blank line)
+static const uint32_t* DELAYED_COPY_CODE(hstx_active_line)(struct dvi_inst *inst)
+{
+    uint top  = (inst->timing->v_active_lines - A2DVI_SCANLINES)/2;
+    uint line = inst->timing_state.v_ctr - top;
+
+    // letter box
+    if ((inst->timing_state.v_ctr < top)||(line >= A2DVI_SCANLINES))
+    {
+        // the last line is not repeated across frames: release it
+        if (inst->tmds_buf_last)
+        {
+            inst->tmds_buf_release = inst->tmds_buf_last;
+            inst->tmds_buf_last    = NULL;
+        }
+        inst->scanline_stale = false;
+        return NULL;
+    }
+
+    // a new scanline is due for the first display line, or for the repeated one when it was late
+    if ((line % DVI_VERTICAL_REPEAT == 0)||(inst->scanline_stale))
+    {
+        uint32_t *tmdsbuf;
+        if (queue_spsc_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf))
+        {
+            // keep this line for repeating it, release the one displayed before (still being sent)
+            inst->tmds_buf_release = inst->tmds_buf_last;
+            inst->tmds_buf_last    = tmdsbuf;
+            if (inst->scanline_stale)
+            {
+                // the line was late, but made it in time for its repeated display line
+                ++inst->scanline_recovered;
+                inst->scanline_stale = false;
+            }
+        }
+        else
+        if (line % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1)
+        {
+            // Missed entirely: the last line (if any) is shown once more, and the
+            // renderer skips a line instead, so the following ones keep their position.
+            ++inst->scanline_errors;
+            ++inst->scanline_skip;
+            inst->scanline_stale = false;
+        }
+        else
+        {
+            // No valid scanline was ready: show the last line once more (rather
+            // than a flashing black line), and retry for the next display line
+            inst->scanline_stale = true;
+        }
+    }
+
+    if ((inst->scanline_emulation)&&((line & 1) == 0))
+        return NULL;
+
+    return inst->tmds_buf_last;
+}
+
+static void __isr DELAYED_COPY_CODE(hstx_dma_irq)(void)
+{
+    struct dvi_inst *inst = hstx_irq_inst;
+    uint chan = inst->dma_chan[inst->dma_next];
+    dma_irqn_acknowledge_channel(inst->dma_irq_index, chan);
+    inst->dma_next ^= 1;
+
+    // the completed channel is reloaded with the transfer after the running one
+    dma_channel_hw_t *ch = dma_channel_hw_addr(chan);
+    if (inst->pixels_pending)
+    {
+        ch->read_addr      = (uintptr_t) inst->pixels_pending;
+        ch->transfer_count = inst->pixel_words;
+        inst->pixels_pending = NULL;
+        return;
+    }
+
+    hstx_timing_advance(inst->timing, &inst->timing_state);
+    if ((inst->timing_state.v_state == DVI_STATE_ACTIVE)&&(inst->timing_state.v_ctr == 0))
+    {
+        if (inst->frame_stamp_src)
+            inst->frame_stamp = *inst->frame_stamp_src;
+        inst->frame_count++;
+    }
+
+    // the pixels of the previous line have been sent: its released buffer is no longer read
+    if (inst->tmds_buf_release && !queue_spsc_try_add_u32(&inst->q_tmds_free, &inst->tmds_buf_release))
+        panic("TMDS free queue full in IRQ!");
+    inst->tmds_buf_release = NULL;
+
+    // the right border of the previous line is only sent when it had pixels
+    uint skip = (inst->h_border_pending) ? 0 : HSTX_CMD_BORDER_WORDS;
+
+    const uint32_t *cmd;
+    uint32_t count;
+    switch (inst->timing_state.v_state)
+    {
+        case DVI_STATE_ACTIVE:
+            inst->pixels_pending   = hstx_active_line(inst);
+            inst->h_border_pending = (inst->pixels_pending)&&(inst->h_border);
+            if (inst->pixels_pending)
+            {
+                cmd   = inst->cmd_active;
+                count = count_of(inst->cmd_active);
+            }
+            else
+            {
+                cmd   = inst->cmd_active_blank;
+                count = count_of(inst->cmd_active_blank);
+            }
+            break;
+        case DVI_STATE_SYNC:
+            cmd   = inst->cmd_vblank_sync;
+            count = count_of(inst->cmd_vblank_sync);
+            break;
+        default:
+            cmd   = inst->cmd_vblank_nosync;
+            count = count_of(inst->cmd_vblank_nosync);
+            break;
+    }
+    if (inst->timing_state.v_state != DVI_STATE_ACTIVE)
+        inst->h_border_pending = false;
+    ch->read_addr      = (uintptr_t) (cmd + skip);
+    ch->transfer_count = count - skip;
+}
+
+void DELAYED_COPY_CODE(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint spinlock_colour_queue)
+{
+    const struct dvi_timing *t = inst->timing;
+    const struct dvi_hstx_cfg *cfg = inst->ser_cfg;
+
+    inst->timing_state.v_ctr   = 0;
+    inst->timing_state.v_state = DVI_STATE_FRONT_PORCH;
+    inst->timing_state.v_adjust = 0;
+    inst->scanline_skip        = 0;
+    inst->scanline_emulation   = 0;
+    inst->scanline_errors      = 0;
+    inst->scanline_recovered   = 0;
+    inst->scanline_stale       = false;
+    inst->frame_stamp_src      = NULL;
+    inst->frame_stamp          = 0;
+    inst->frame_count          = 0;
+    inst->pixels_pending       = NULL;
+    inst->h_border_pending     = false;
+    inst->tmds_buf_last        = NULL;
+    inst->tmds_buf_release     = NULL;
+    inst->dma_next             = 0;
+    queue_init_with_spinlock(&inst->q_tmds_valid, sizeof(void*), 8, spinlock_tmds_queue);
+    queue_init_with_spinlock(&inst->q_tmds_free,  sizeof(void*), 8, spinlock_tmds_queue);
+
+    hstx_cmd_init(inst);
+
+    // scanline buffers for the renderers (RGB332, 4 pixels per word), black
+    uint image_pixels = t->h_active_pixels - 2 * inst->h_border;
+    inst->pixel_words = image_pixels / HSTX_RGB332_PIXELS;
+    for (int i = 0; i < DVI_N_TMDS_BUFFERS; ++i)
+    {
+        uint32_t *tmdsbuf = calloc(inst->pixel_words, sizeof(uint32_t));
+        if (!tmdsbuf)
+            panic("TMDS buffer allocation failed");
+        queue_spsc_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+    }
+
+    // 10 TMDS bits per pixel, two bits per HSTX clock
+    clock_configure(clk_hstx, 0, CLOCKS_CLK_HSTX_CTRL_AUXSRC_VALUE_CLK_SYS,
+                    clock_get_hz(clk_sys), t->bit_clk_khz * 1000 / 2);
+
+    hstx_ctrl_hw->expand_tmds =
+        HSTX_RGB332_LANE2_NBITS << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB |
+        HSTX_RGB332_LANE2_ROT   << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB   |
+        HSTX_RGB332_LANE1_NBITS << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB |
+        HSTX_RGB332_LANE1_ROT   << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB   |
+        HSTX_RGB332_LANE0_NBITS << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB |
+        HSTX_RGB332_LANE0_ROT   << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
+
+    // pixels: 4 shifts of 8 bits per word, raw control words: one shift
+    hstx_ctrl_hw->expand_shift =
+        HSTX_RGB332_PIXELS << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
+        HSTX_RGB332_SHIFT  << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB    |
+        1u                 << HSTX_CTRL_EXPAND_SHIFT_RAW_N_SHIFTS_LSB |
+        0u                 << HSTX_CTRL_EXPAND_SHIFT_RAW_SHIFT_LSB;
+
+    // serialiser: 5 shifts of 2 bits per 10 bit symbol, the clock toggles every 5 HSTX clocks
+    hstx_ctrl_hw->csr = 0;
+    hstx_ctrl_hw->csr =
+        HSTX_CTRL_CSR_EXPAND_EN_BITS   |
+        5u << HSTX_CTRL_CSR_CLKDIV_LSB   |
+        5u << HSTX_CTRL_CSR_N_SHIFTS_LSB |
+        2u << HSTX_CTRL_CSR_SHIFT_LSB;
+
+    uint32_t inv_p = (cfg->invert_diffpairs) ? HSTX_CTRL_BIT0_INV_BITS : 0;
+    uint32_t inv_n = inv_p ^ HSTX_CTRL_BIT0_INV_BITS;
+    hstx_ctrl_hw->bit[cfg->bits_clk    ] = HSTX_CTRL_BIT0_CLK_BITS | inv_p;
+    hstx_ctrl_hw->bit[cfg->bits_clk + 1] = HSTX_CTRL_BIT0_CLK_BITS | inv_n;
+    for (uint lane = 0; lane < N_TMDS_LANES; ++lane)
+    {
+        // output the even bit of the lane's 2 bit shift, then the odd bit
+        uint bit = cfg->bits_tmds[lane];
+        uint32_t sel = (lane * 10    ) << HSTX_CTRL_BIT0_SEL_P_LSB |
+                       (lane * 10 + 1) << HSTX_CTRL_BIT0_SEL_N_LSB;
+        hstx_ctrl_hw->bit[bit    ] = sel | inv_p;
+        hstx_ctrl_hw->bit[bit + 1] = sel | inv_n;
+    }
+
+    for (uint lane = 0; lane < N_TMDS_LANES; ++lane)
+    {
+        gpio_set_function(HSTX_FIRST_GPIO + cfg->bits_tmds[lane],     GPIO_FUNC_HSTX);
+        gpio_set_function(HSTX_FIRST_GPIO + cfg->bits_tmds[lane] + 1, GPIO_FUNC_HSTX);
+    }
+    gpio_set_function(HSTX_FIRST_GPIO + cfg->bits_clk,     GPIO_FUNC_HSTX);
+    gpio_set_function(HSTX_FIRST_GPIO + cfg->bits_clk + 1, GPIO_FUNC_HSTX);
+
+    // ping-pong DMA: each channel triggers the other one, starting with two blank lines
+    inst->dma_chan[0] = dma_claim_unused_channel(true);
+    inst->dma_chan[1] = dma_claim_unused_channel(true);
+    for (int i = 0; i < 2; ++i)
+    {
+        dma_channel_config c = dma_channel_get_default_config(inst->dma_chan[i]);
+        channel_config_set_chain_to(&c, inst->dma_chan[i ^ 1]);
+        channel_config_set_dreq(&c, DREQ_HSTX);
+        dma_channel_configure(inst->dma_chan[i], &c, &hstx_fifo_hw->fifo,
+                              inst->cmd_vblank_nosync + HSTX_CMD_BORDER_WORDS,
+                              count_of(inst->cmd_vblank_nosync) - HSTX_CMD_BORDER_WORDS, false);
+    }
+}
+
+// The IRQs will run on whichever core calls this function (this is why it's
+// called separately from dvi_init)
+void DELAYED_COPY_CODE(dvi_register_irqs_this_core)(struct dvi_inst *inst, uint irq_num)
+{
+    inst->dma_irq_index = irq_num - DMA_IRQ_0;
+    hstx_irq_inst = inst;
+    for (int i = 0; i < 2; ++i)
+    {
+        dma_irqn_acknowledge_channel(inst->dma_irq_index, inst->dma_chan[i]);
+        dma_irqn_set_channel_enabled(inst->dma_irq_index, inst->dma_chan[i], true);
+    }
+    irq_set_exclusive_handler(irq_num, hstx_dma_irq);
+    irq_set_enabled(irq_num, true);
+}
+
+void DELAYED_COPY_CODE(dvi_start)(struct dvi_inst *inst)
+{
+    hw_set_bits(&hstx_ctrl_hw->csr, HSTX_CTRL_CSR_EN_BITS);
+    dma_channel_start(inst->dma_chan[0]);
+}
+
+// must be called on the CPU core which is running the IRQ handlers
+void DELAYED_COPY_CODE(dvi_destroy)(struct dvi_inst *inst, uint irq_num)
+{
+    irq_set_enabled(irq_num, false);
+    irq_remove_handler(irq_num, hstx_dma_irq);
+
+    // stop the DMA chain (abort both channels, since each may retrigger the other)
+    for (int i = 0; i < 2; ++i)
+    {
+        dma_irqn_set_channel_enabled(inst->dma_irq_index, inst->dma_chan[i], false);
+        hw_write_masked(&dma_hw->ch[inst->dma_chan[i]].al1_ctrl,
+                        inst->dma_chan[i] << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB, DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS);
+    }
+    dma_channel_abort(inst->dma_chan[0]);
+    dma_channel_abort(inst->dma_chan[1]);
+    hstx_ctrl_hw->csr = 0;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        dma_channel_cleanup(inst->dma_chan[i]);
+        dma_channel_unclaim(inst->dma_chan[i]);
+    }
+
+    // free the scanline buffers, including the ones held by the IRQ (compact
+    // scanline buffers must have been taken out of the queues by the application)
+    uint buf_count = 0;
+    if (inst->tmds_buf_release)
+    {
+        free(inst->tmds_buf_release);
+        inst->tmds_buf_release = NULL;
+        buf_count++;
+    }
+    if (inst->tmds_buf_last)
+    {
+        free(inst->tmds_buf_last);
+        inst->tmds_buf_last = NULL;
+        buf_count++;
+    }
+    while (buf_count < DVI_N_TMDS_BUFFERS)
+    {
+        void *tmdsbuf = NULL;
+        if (queue_spsc_try_remove_u32(&inst->q_tmds_free, &tmdsbuf))
+        {
+            free(tmdsbuf);
+            buf_count++;
+        }
+        // also consider valid queue, since we may have aborted a frame display cycle
+        if (queue_spsc_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf))
+        {
+            free(tmdsbuf);
+            buf_count++;
+        }
+    }
+
+    // disable TMDS clock output
+    gpio_set_function(HSTX_FIRST_GPIO + inst->ser_cfg->bits_clk,     GPIO_FUNC_NULL);
+    gpio_set_function(HSTX_FIRST_GPIO + inst->ser_cfg->bits_clk + 1, GPIO_FUNC_NULL);
+
+    queue_free(&inst->q_tmds_valid);
+    queue_free(&inst->q_tmds_free);
+}
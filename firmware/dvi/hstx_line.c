@@ -0,0 +1,43 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "tmds.h"
+#include "hstx_line.h"
+
+void DELAYED_COPY_CODE(hstx_convert_pairs)(uint32_t* table, uint32_t count, uint32_t stride, uint32_t channel)
+{
+    for (uint32_t i=0;i<count*stride;i+=stride)
+    {
+        uint32_t pair = table[i];
+        table[i] = hstx_rgb332_pair(hstx_tmds_decode(pair & 0x3ff) | (hstx_tmds_decode(pair >> 10) << 8), channel);
+    }
+}
+
+void DELAYED_COPY_CODE(hstx_convert_values)(uint32_t* table, uint32_t count, uint32_t stride, uint32_t channel)
+{
+    for (uint32_t i=0;i<count*stride;i+=stride)
+    {
+        table[i] = hstx_rgb332_pair(table[i], channel);
+    }
+}
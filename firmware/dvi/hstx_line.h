@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// HSTX line format (RP2350, FEATURE_HSTX).
+//
+// The HSTX peripheral has its own TMDS encoder, so the scanline buffers do not
+// need balanced TMDS symbol pairs: a scanline is a line of RGB332 pixels (one
+// byte per pixel, 4 pixels per word, first pixel in the least significant byte),
+// which the HSTX expander splits into the three TMDS lanes. The DVI DMA sends
+// the scanline buffers as they are.
+//
+// The renderers still look up the red, green and blue entry of a pixel pair in
+// the tables, but each entry only holds the RGB332 bits of its channel for the
+// two pixels (first pixel in bits 0-7, second pixel in bits 8-15): the three
+// entries are simply combined (see dvi_add_pixel_pair in tmds.h). The TMDS
+// tables, which are defined as symbol pairs (or channel value pairs, see
+// TMDS_SYMBOL_x_y in tmds.h), are converted once when they are loaded.
+
+// HSTX expander configuration for RGB332 pixels: right-rotation and number of
+// valid bits (minus one) of each TMDS lane, starting from bit 7 of the rotated data
+#define HSTX_RGB332_LANE0_ROT   26 // blue:  bits 1..0
+#define HSTX_RGB332_LANE0_NBITS 1
+#define HSTX_RGB332_LANE1_ROT   29 // green: bits 4..2
+#define HSTX_RGB332_LANE1_NBITS 2
+#define HSTX_RGB332_LANE2_ROT   0  // red:   bits 7..5
+#define HSTX_RGB332_LANE2_NBITS 2
+// one pixel per 8bit shift, 4 pixels per word
+#define HSTX_RGB332_SHIFT       8
+#define HSTX_RGB332_PIXELS      4
+
+// channels (in the order of the TMDS lanes)
+#define HSTX_CHANNEL_BLUE  0
+#define HSTX_CHANNEL_GREEN 1
+#define HSTX_CHANNEL_RED   2
+
+// 8bit value of a 10bit TMDS data symbol
+static inline uint32_t hstx_tmds_decode(uint32_t symbol)
+{
+    uint32_t q = (symbol & 0x200) ? (symbol ^ 0xff) : symbol;
+    // bit 8: the data bits are XOR'ed (set) or XNOR'ed (clear) with the previous bit
+    uint32_t d = (q ^ (q << 1)) & 0xfe;
+    if ((q & 0x100) == 0)
+        d ^= 0xfe;
+    return d | (q & 1);
+}
+
+// RGB332 bits of a pair of 8bit channel values
+static inline uint32_t hstx_rgb332_pair(uint32_t values, uint32_t channel)
+{
+    switch (channel)
+    {
+        case HSTX_CHANNEL_BLUE:
+            return (values >> 6) & 0x0303;
+        case HSTX_CHANNEL_GREEN:
+            return (values >> 3) & 0x1c1c;
+        default:
+            return values & 0xe0e0;
+    }
+}
+
+// convert every 'stride'th entry of a table of TMDS symbol pairs (two 10bit
+// symbols per word) to the RGB332 bits of the given channel
+extern void hstx_convert_pairs(uint32_t* table, uint32_t count, uint32_t stride, uint32_t channel);
+
+// same for a table of channel value pairs (TMDS_SYMBOL_x_y)
+extern void hstx_convert_values(uint32_t* table, uint32_t count, uint32_t stride, uint32_t channel);
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "tmds.h"
+#include "hstx_line.h"
 #include "config/config.h"
 
 uint32_t DELAYED_COPY_DATA(dvi_x_resolution);
@@ -31,7 +32,7 @@ uint32_t DELAYED_COPY_DATA(dvi_xofs560);
 uint32_t DELAYED_COPY_DATA(dvi_xofs640);
 
 // TMDS data for RGB channels for a double pixel (a perfectly bit balanced pixel)
-uint32_t DELAYED_COPY_DATA(tmds_mono_double_pixel)[3*5] =
+uint32_t DELAYED_COPY_DATA(tmds_mono_double_pixel)[3*TMDS_MONO_COLORS] =
 {
     /* R                 G                    B               */
     TMDS_SYMBOL_255_255, TMDS_SYMBOL_255_255, TMDS_SYMBOL_255_255, /* white */
@@ -61,8 +62,91 @@ uint32_t DELAYED_COPY_DATA(tmds_mono_pixel_pair)[4*3*3] =
     /*B*/ TMDS_SYMBOL_0_0, TMDS_SYMBOL_0_0,   TMDS_SYMBOL_0_0,   TMDS_SYMBOL_0_0
 };
 
+#ifdef FEATURE_HSTX
+uint32_t DELAYED_COPY_DATA(tmds_mono_rgb332)[TMDS_MONO_COLORS][16];
+#else
+uint32_t DELAYED_COPY_DATA(tmds_mono_nibble)[TMDS_MONO_LEVELS][16*2];
+#endif
+
+// channel intensity of a monochrome "foreground" symbol
+uint DELAYED_COPY_CODE(tmds_mono_level)(uint32_t symbol)
+{
+    if (symbol == TMDS_SYMBOL_255_255)
+        return 2;
+    if (symbol == TMDS_SYMBOL_128_128)
+        return 1;
+    return 0;
+}
+
+#ifdef FEATURE_HSTX
+void DELAYED_COPY_CODE(tmds_color_load_text)(void)
+{
+    // the static tables are channel value pairs: convert them once
+    static bool converted = false;
+    if (!converted)
+    {
+        for (uint ch=0;ch<3;ch++)
+        {
+            // tables are defined as red, green, blue
+            uint channel = HSTX_CHANNEL_RED - ch;
+            hstx_convert_values(&tmds_mono_double_pixel[ch], TMDS_MONO_COLORS, 3, channel);
+            for (uint color=0;color<3;color++)
+                hstx_convert_values(&tmds_mono_pixel_pair[color*12+ch*4], 4, 1, channel);
+        }
+        converted = true;
+    }
+
+    // four RGB332 pixels per 4bit pattern, for each color
+    for (uint color=0;color<TMDS_MONO_COLORS;color++)
+    {
+        const uint32_t* rgb = &tmds_mono_double_pixel[color*3];
+        uint32_t foreground = (rgb[0] | rgb[1] | rgb[2]) & 0xff;
+        for (uint bits=0;bits<16;bits++)
+        {
+            uint32_t pixels = 0;
+            for (uint i=0;i<4;i++)
+            {
+                if (bits & (1u << i))
+                    pixels |= foreground << (i*8);
+            }
+            tmds_mono_rgb332[color][bits] = pixels;
+        }
+    }
+}
+#else
+void DELAYED_COPY_CODE(tmds_color_load_text)(void)
+{
+    // one pixel pair per two bits, for each channel intensity
+    for (uint i=0;i<3*3;i++)
+    {
+        const uint32_t* pixel_pair = &tmds_mono_pixel_pair[i*4];
+        uint32_t* table = tmds_mono_nibble[tmds_mono_level(pixel_pair[3])];
+        for (uint bits=0;bits<16;bits++)
+        {
+            table[bits*2+0] = pixel_pair[bits & 3];
+            table[bits*2+1] = pixel_pair[bits >> 2];
+        }
+    }
+}
+#endif
+
 void DELAYED_COPY_CODE(tmds_color_load)(void)
 {
+#ifdef FEATURE_HSTX
+    // the static HIRES tables are TMDS symbol pairs: convert them once
+    static bool hires_converted = false;
+    if (!hires_converted)
+    {
+        hstx_convert_pairs(tmds_hires_color_patterns_red,   2*256, 1, HSTX_CHANNEL_RED);
+        hstx_convert_pairs(tmds_hires_color_patterns_green, 2*256, 1, HSTX_CHANNEL_GREEN);
+        hstx_convert_pairs(tmds_hires_color_patterns_blue,  2*256, 1, HSTX_CHANNEL_BLUE);
+        hstx_convert_pairs(&tmds_hires_color_patterns_rgb[0], 2*256, TMDS_HIRES_RGB_STRIDE, HSTX_CHANNEL_RED);
+        hstx_convert_pairs(&tmds_hires_color_patterns_rgb[1], 2*256, TMDS_HIRES_RGB_STRIDE, HSTX_CHANNEL_GREEN);
+        hstx_convert_pairs(&tmds_hires_color_patterns_rgb[2], 2*256, TMDS_HIRES_RGB_STRIDE, HSTX_CHANNEL_BLUE);
+        hires_converted = true;
+    }
+#endif
+    tmds_color_load_text();
     tmds_color_load_lores(cfg_color_style);
     tmds_color_load_dhgr(cfg_color_style);
     reload_colors = false;
@@ -25,6 +25,9 @@ SOFTWARE.
 #pragma once
 
 #include "dvi.h"
+#include "tmds_cache.h"
+#include "tmds_mono.h"
+#include "tmds_index.h"
 
 extern struct dvi_inst dvi0;
 
@@ -35,7 +38,7 @@ extern uint32_t dvi_xofs640;
 
 // DVI x resolution in pixels
 #define DVI_X_RESOLUTION      dvi_x_resolution
-// DVI words per channel and for each scanline
+// DVI words per channel and for each scanline (pixel pairs per scanline)
 #define DVI_WORDS_PER_CHANNEL dvi_words_per_channel
 // DVI x offset (in words) when showing content with 560px horizontally
 #define DVI_APPLE2_XOFS_560   dvi_xofs560
@@ -62,6 +65,19 @@ extern uint32_t dvi_xofs640;
 // symbols to significantly simplify the production of a valid TMDS
 // encoded bit stream.
 
+#ifdef FEATURE_HSTX
+// HSTX builds: the HSTX peripheral does the TMDS encoding, so a "symbol" is just
+// the pair of 8bit channel values (see hstx_line.h). The tables of the renderers
+// are converted to the RGB332 bits of their channel when they are loaded.
+#define TMDS_SYMBOL_0_0     0x0000
+#define TMDS_SYMBOL_255_0   0x00ff
+#define TMDS_SYMBOL_0_255   0xff00
+#define TMDS_SYMBOL_255_255 0xffff
+
+#define TMDS_SYMBOL_128_0   0x0080
+#define TMDS_SYMBOL_0_128   0x8000
+#define TMDS_SYMBOL_128_128 0x8080
+#else
 #define TMDS_SYMBOL_0_0     0x7fd00 // actually 00/01
 #define TMDS_SYMBOL_255_0   0x402ff // actually FE/00
 #define TMDS_SYMBOL_0_255   0xbfd00 // actually 00/FE
@@ -70,11 +86,70 @@ extern uint32_t dvi_xofs640;
 #define TMDS_SYMBOL_128_0   0x7f980
 #define TMDS_SYMBOL_0_128   0xdfd00
 #define TMDS_SYMBOL_128_128 0x5fd80
+#endif
+
+#ifdef FEATURE_HSTX
+// HSTX builds: a scanline is a line of RGB332 pixels (see hstx_line.h). The
+// renderers still look up the red, green and blue "symbols" of a pixel pair, but
+// combine them into a single entry (the table entries hold the RGB332 bits of
+// their channel). All pixel pairs are written through the "blue" pointer.
+typedef uint16_t dvi_pixel_pair_t;
+
+// words of a scanline buffer
+#define DVI_SCANLINE_WORDS (DVI_X_RESOLUTION/4)
+
+// add a pixel pair to the scanline: the symbols of the red, green and blue channel
+#define dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b) \
+        *(tmdsbuf_blue++) = (r) | (g) | (b);
+#else
+typedef uint32_t dvi_pixel_pair_t;
+
+// words of a scanline buffer (all three channels)
+#define DVI_SCANLINE_WORDS (3*DVI_WORDS_PER_CHANNEL)
+
+// add a pixel pair to the scanline: the symbols of the red, green and blue channel
+#define dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b) \
+        *(tmdsbuf_red++)   = r; \
+        *(tmdsbuf_green++) = g; \
+        *(tmdsbuf_blue++)  = b;
+#endif
 
 #define dvi_get_scanline(tmdsbuf)  \
-    uint32_t* tmdsbuf;\
-    queue_remove_blocking_u32(&dvi0.q_tmds_free, &tmdsbuf);
+    uint32_t* tmdsbuf = tmds_cache_get_scanline(TMDS_CACHE_NO_LINE, 0);
 
+// get scanline for a display line of the Apple II screen area, with the hash of
+// its screen memory (the scanline is kept in the line cache)
+#define dvi_get_cached_scanline(tmdsbuf, line, hash)  \
+    uint32_t* tmdsbuf = tmds_cache_get_scanline(line, hash);
+
+#ifdef FEATURE_HSTX
+// get scanline rgb pointers (one pointer to the RGB332 pixel pairs, see dvi_add_pixel_pair)
+#define dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue) \
+        dvi_pixel_pair_t* tmdsbuf_blue = (dvi_pixel_pair_t*) (tmdsbuf);
+
+// get scanline rgb pointers for 640pixel/line rendering
+#define dvi_scanline_rgb640(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue) \
+        dvi_pixel_pair_t* tmdsbuf_blue = ((dvi_pixel_pair_t*) (tmdsbuf)) + DVI_APPLE2_XOFS_640;
+
+// get scanline rgb pointers for 560pixel/line rendering: this automatically fills the left/right border (40 pixels each)
+#define dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue) \
+        dvi_scanline_border560(tmdsbuf); \
+        dvi_pixel_pair_t* tmdsbuf_blue = ((dvi_pixel_pair_t*) (tmdsbuf)) + DVI_APPLE2_XOFS_560;
+
+// fill the left/right border (40 pixels each) of a scanline for 560pixel/line rendering
+#define dvi_scanline_border560(tmdsbuf) \
+        for (uint32_t i=0;i<DVI_APPLE2_XOFS_560;i++) \
+        {\
+            ((dvi_pixel_pair_t*) (tmdsbuf))[i]                           = TMDS_SYMBOL_0_0; \
+            ((dvi_pixel_pair_t*) (tmdsbuf))[i+DVI_APPLE2_XOFS_560+560/2] = TMDS_SYMBOL_0_0; \
+        }
+
+#define dvi_copy_scanline(destbuf, srcbuf) \
+    for (uint32_t i=0;i<DVI_SCANLINE_WORDS;i++) \
+    { \
+        destbuf[i] = srcbuf[i]; \
+    }
+#else
 // get scanline rgb pointers
 #define dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue) \
         uint32_t *tmdsbuf_blue  = tmdsbuf; \
@@ -92,14 +167,25 @@ extern uint32_t dvi_xofs640;
         dvi_scanline_rgb(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue); \
         for (uint32_t i=0;i<DVI_APPLE2_XOFS_560;i++) \
         {\
-            *(tmdsbuf_red+(600/2))   = TMDS_SYMBOL_0_0; \
-            *(tmdsbuf_green+(600/2)) = TMDS_SYMBOL_0_0; \
-            *(tmdsbuf_blue+(600/2))  = TMDS_SYMBOL_0_0; \
+            *(tmdsbuf_red+DVI_APPLE2_XOFS_560+(560/2))   = TMDS_SYMBOL_0_0; \
+            *(tmdsbuf_green+DVI_APPLE2_XOFS_560+(560/2)) = TMDS_SYMBOL_0_0; \
+            *(tmdsbuf_blue+DVI_APPLE2_XOFS_560+(560/2))  = TMDS_SYMBOL_0_0; \
             *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0; \
             *(tmdsbuf_green++) = TMDS_SYMBOL_0_0; \
             *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0; \
         }
 
+// fill the left/right border (40 pixels each) of a scanline for 560pixel/line rendering
+#define dvi_scanline_border560(tmdsbuf) \
+        for (uint32_t i=0;i<DVI_APPLE2_XOFS_560;i++) \
+        {\
+            for (uint32_t ch=0;ch<3*DVI_WORDS_PER_CHANNEL;ch+=DVI_WORDS_PER_CHANNEL) \
+            {\
+                tmdsbuf[ch+i]                          = TMDS_SYMBOL_0_0; \
+                tmdsbuf[ch+i+DVI_APPLE2_XOFS_560+560/2] = TMDS_SYMBOL_0_0; \
+            }\
+        }
+
 #define dvi_copy_scanline(destbuf, srcbuf) \
     for (uint32_t i=0;i<DVI_WORDS_PER_CHANNEL;i++) \
     { \
@@ -107,28 +193,52 @@ extern uint32_t dvi_xofs640;
         destbuf[i+  DVI_WORDS_PER_CHANNEL] = srcbuf[i+  DVI_WORDS_PER_CHANNEL]; \
         destbuf[i+2*DVI_WORDS_PER_CHANNEL] = srcbuf[i+2*DVI_WORDS_PER_CHANNEL]; \
     }
+#endif
 
 #define dvi_send_scanline(tmdsbuf) \
-    queue_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);
+    tmds_cache_send_scanline(tmdsbuf);
 
-// TMDS data for a duplicated monochrome pixel (a "bit balanced" double pixel).
-extern uint32_t tmds_mono_double_pixel[3*5];
+// TMDS data for a duplicated monochrome pixel (a "bit balanced" double pixel),
+// for the colors white, green, amber, black and red.
+#define TMDS_MONO_COLORS 5
+extern uint32_t tmds_mono_double_pixel[3*TMDS_MONO_COLORS];
 
 // TMDS data for two separate monochrome pixels (a "bit balanced" pixel pair).
 extern uint32_t tmds_mono_pixel_pair[4*3*3];
 
+#ifdef FEATURE_HSTX
+// RGB332 pixels of monochrome scanlines, pre-expanded for each 4bit pattern: 4 pixels.
+// One table per color.
+extern uint32_t tmds_mono_rgb332[TMDS_MONO_COLORS][16];
+#else
+// TMDS data for monochrome scanlines, pre-expanded for each 4bit pattern: 2 pixel pairs.
+// One table per channel intensity (off/half/full), see tmds_mono_level.
+#define TMDS_MONO_LEVELS 3
+extern uint32_t tmds_mono_nibble[TMDS_MONO_LEVELS][16*2];
+#endif
+
+// channel intensity (table index) of a monochrome "foreground" symbol
+extern uint tmds_mono_level(uint32_t symbol);
+
 // TMDS data for a duplicated color pixel ("bit balanced" double pixels).
 // 16 entries, matching the LORES color palette
 extern uint32_t tmds_lorescolor[3*16];
 
+// LORES colors of the 16 DHGR dot patterns, interleaved (red, green, blue, padding)
+extern uint32_t tmds_dhgr_lores_rgb[4*16];
+
 extern uint32_t tmds_hires_color_patterns_red[2*256];
 extern uint32_t tmds_hires_color_patterns_green[2*256];
 extern uint32_t tmds_hires_color_patterns_blue[2*256];
+// same symbols, interleaved per dot pattern (red, green, blue, padding), generated by tools/tmds_table_gen.py
+#define TMDS_HIRES_RGB_STRIDE 4
+extern uint32_t tmds_hires_color_patterns_rgb[2*256*TMDS_HIRES_RGB_STRIDE];
 
 extern uint32_t tmds_dhgr_red[16*16];
 extern uint32_t tmds_dhgr_green[16*16];
 extern uint32_t tmds_dhgr_blue[16*16];
 
 extern void tmds_color_load(void);
+extern void tmds_color_load_text(void);
 extern void tmds_color_load_lores(uint color_style);
 extern void tmds_color_load_dhgr(uint color_style);
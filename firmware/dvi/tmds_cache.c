@@ -0,0 +1,519 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <stdlib.h>
+
+#include "applebus/buffers.h"
+#include "tmds.h"
+#include "tmds_cache.h"
+#include "debug/debug.h"
+#include "debug/profiler.h"
+
+#define NO_SLOT      0xffff
+#define BUCKET_COUNT 256
+
+typedef struct
+{
+    uint32_t mode;       // render mode
+    uint32_t hash;       // hash of the screen memory
+    uint32_t frame;      // frame when the slot was last used
+    uint16_t line;       // display line (TMDS_CACHE_NO_LINE: slot is unused)
+    uint16_t chain;      // next slot in the same hash bucket
+    uint16_t lru_prev;   // more recently used slot
+    uint16_t lru_next;   // less recently used slot
+    uint8_t  valid;      // slot contains a completely rendered scanline
+    uint8_t  busy;       // number of users (renderer/DVI queues) still holding the slot
+} tmds_cache_slot_t;
+
+uint32_t DELAYED_COPY_DATA(tmds_cache_lines);
+uint32_t DELAYED_COPY_DATA(tmds_cache_bytes);
+uint32_t DELAYED_COPY_DATA(tmds_cache_hits);
+uint32_t DELAYED_COPY_DATA(tmds_cache_misses);
+
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_mode);
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_frame);
+static uint32_t*          DELAYED_COPY_DATA(tmds_cache_base);
+static uint32_t*          DELAYED_COPY_DATA(tmds_cache_end);
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_words);
+static tmds_cache_slot_t* DELAYED_COPY_DATA(tmds_cache_slots);
+static uint16_t           DELAYED_COPY_DATA(tmds_cache_lru_head);
+static uint16_t           DELAYED_COPY_DATA(tmds_cache_lru_tail);
+static uint16_t           DELAYED_COPY_DATA(tmds_cache_bucket)[BUCKET_COUNT];
+
+// statistics of the previous tmds_cache_hit_ratio call
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_last_hits);
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_last_misses);
+
+// normal TMDS buffers, which were not needed since a cached line was sent instead
+static uint32_t*          DELAYED_COPY_DATA(tmds_cache_spare)[DVI_N_TMDS_BUFFERS];
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_spare_count);
+
+// hashes of the lines of the shadow memory (3 lines per 128 byte block, 0: not hashed)
+#define LINES_PER_BLOCK 3
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_line_hashes)[2][SHADOW_BLOCK_COUNT*LINES_PER_BLOCK];
+// the shadow memory is only written by the bus handler (not by the menu/test mode)
+static bool               DELAYED_COPY_DATA(tmds_cache_tracked);
+
+// scanlines missed by the DVI, which the renderer has skipped (follows dvi0.scanline_skip,
+// while released: the number of missed scanlines still to skip, negative)
+static uint32_t           DELAYED_COPY_DATA(tmds_cache_skipped);
+
+// profiling: cycle counter when the last buffer was taken, cycles waited for buffers, slowest scanline
+static uint32_t           DELAYED_COPY_DATA(tmds_profile_last);
+static uint32_t           DELAYED_COPY_DATA(tmds_profile_wait);
+static uint32_t           DELAYED_COPY_DATA(tmds_profile_line_max);
+
+static inline bool is_cached_line(uint32_t* tmdsbuf)
+{
+    return (tmdsbuf >= tmds_cache_base)&&(tmdsbuf < tmds_cache_end);
+}
+
+static inline uint32_t* slot_buffer(uint32_t slot)
+{
+    return &tmds_cache_base[slot*tmds_cache_words];
+}
+
+static inline uint32_t bucket_index(uint32_t mode, uint32_t line, uint32_t hash)
+{
+    return ((hash ^ mode ^ line) * 0x9e3779b1u) >> 24;
+}
+
+static inline uint32_t find_slot(uint32_t line, uint32_t hash)
+{
+    uint32_t slot = tmds_cache_bucket[bucket_index(tmds_cache_mode, line, hash)];
+    while (slot != NO_SLOT)
+    {
+        tmds_cache_slot_t* s = &tmds_cache_slots[slot];
+        if ((s->line == line)&&(s->hash == hash)&&(s->mode == tmds_cache_mode))
+            break;
+        slot = s->chain;
+    }
+    return slot;
+}
+
+static inline void bucket_remove(uint32_t slot)
+{
+    tmds_cache_slot_t* s = &tmds_cache_slots[slot];
+    uint16_t* p = &tmds_cache_bucket[bucket_index(s->mode, s->line, s->hash)];
+    while (*p != slot)
+        p = &tmds_cache_slots[*p].chain;
+    *p = s->chain;
+
+    s->line  = TMDS_CACHE_NO_LINE;
+    s->valid = 0;
+}
+
+// mark slot as most recently used
+static inline void lru_touch(uint32_t slot)
+{
+    tmds_cache_slot_t* s = &tmds_cache_slots[slot];
+    s->frame = tmds_cache_frame;
+    if (slot == tmds_cache_lru_head)
+        return;
+
+    // unlink
+    tmds_cache_slots[s->lru_prev].lru_next = s->lru_next;
+    if (s->lru_next == NO_SLOT)
+        tmds_cache_lru_tail = s->lru_prev;
+    else
+        tmds_cache_slots[s->lru_next].lru_prev = s->lru_prev;
+
+    // insert at head
+    s->lru_prev = NO_SLOT;
+    s->lru_next = tmds_cache_lru_head;
+    tmds_cache_slots[tmds_cache_lru_head].lru_prev = slot;
+    tmds_cache_lru_head = slot;
+}
+
+// A buffer returned by the DVI: returns the TMDS buffer which is available again.
+// Cached lines are just released, a spare buffer is used instead. There is
+// always a spare, since the DVI queues hold at most DVI_N_TMDS_BUFFERS entries.
+static inline uint32_t* tmds_cache_returned(uint32_t* tmdsbuf)
+{
+    if (is_cached_line(tmdsbuf))
+    {
+        tmds_cache_slots[(tmdsbuf - tmds_cache_base) / tmds_cache_words].busy--;
+        return tmds_cache_spare[--tmds_cache_spare_count];
+    }
+    return tmdsbuf;
+}
+
+// Take one buffer from the DVI free queue (NULL: none available, when not waiting).
+// The time between taking two buffers is the time needed for rendering a
+// scanline (or a pair of scanlines, for renderers preparing two at once).
+static inline uint32_t* tmds_cache_take_free(bool wait)
+{
+    uint32_t* tmdsbuf;
+    uint32_t start = CYCLE_COUNTER_READ();
+
+    if (wait)
+        queue_spsc_remove_blocking_u32(&dvi0.q_tmds_free, &tmdsbuf);
+    else
+    if (!queue_spsc_try_remove_u32(&dvi0.q_tmds_free, &tmdsbuf))
+        return NULL;
+
+    uint32_t busy = CYCLE_COUNTER_ELAPSED(tmds_profile_last, start);
+    if (busy > tmds_profile_line_max)
+        tmds_profile_line_max = busy;
+    tmds_profile_last  = CYCLE_COUNTER_READ();
+    tmds_profile_wait += CYCLE_COUNTER_ELAPSED(start, tmds_profile_last);
+    return tmds_cache_returned(tmdsbuf);
+}
+
+// take a buffer for a scanline: index lines waiting for expansion precede it
+static inline uint32_t* tmds_cache_take(void)
+{
+    tmds_index_flush();
+    return tmds_cache_take_free(true);
+}
+
+#ifdef FEATURE_INDEXED_LINES
+uint32_t* DELAYED_COPY_CODE(tmds_cache_take_buffer)(bool wait)
+{
+    return tmds_cache_take_free(wait);
+}
+#endif
+
+void DELAYED_COPY_CODE(tmds_cache_init)(void)
+{
+    uint32_t bytes_per_line = DVI_SCANLINE_WORDS*sizeof(uint32_t) + sizeof(tmds_cache_slot_t);
+    uint32_t free_heap      = getFreeHeap();
+    uint32_t lines          = 0;
+
+    if (free_heap > TMDS_CACHE_HEAP_RESERVE)
+    {
+        lines = (free_heap - TMDS_CACHE_HEAP_RESERVE) / bytes_per_line;
+        if (lines > TMDS_CACHE_MAX_LINES)
+            lines = TMDS_CACHE_MAX_LINES;
+    }
+
+    // a cache smaller than the DVI queues (plus the lines being rendered) would never hit
+    if (lines <= DVI_N_TMDS_BUFFERS+2)
+        lines = 0;
+
+    tmds_cache_base = NULL;
+    while ((lines > 0)&&(tmds_cache_base == NULL))
+    {
+        tmds_cache_base = malloc(lines * bytes_per_line);
+        if (tmds_cache_base == NULL)
+            lines--;
+    }
+
+    tmds_cache_lines       = lines;
+    tmds_cache_bytes       = lines * bytes_per_line;
+    tmds_cache_words       = DVI_SCANLINE_WORDS;
+    tmds_cache_end         = tmds_cache_base + lines*tmds_cache_words;
+    tmds_cache_slots       = (tmds_cache_slot_t*) tmds_cache_end;
+    tmds_cache_spare_count = 0;
+    tmds_cache_hits        = 0;
+    tmds_cache_misses      = 0;
+    tmds_cache_last_hits   = 0;
+    tmds_cache_last_misses = 0;
+    tmds_cache_skipped    += dvi0.scanline_skip;
+
+    // initialize with black pixels (the 640 pixel renderers do not cover the border at 720 pixels)
+    for (uint32_t i=0;i<lines*tmds_cache_words;i++)
+        tmds_cache_base[i] = TMDS_SYMBOL_0_0;
+
+    for (uint32_t i=0;i<lines;i++)
+    {
+        tmds_cache_slot_t* s = &tmds_cache_slots[i];
+        s->line     = TMDS_CACHE_NO_LINE;
+        s->frame    = tmds_cache_frame-1;
+        s->valid    = 0;
+        s->busy     = 0;
+        s->lru_prev = (i == 0)       ? NO_SLOT : i-1;
+        s->lru_next = (i+1 == lines) ? NO_SLOT : i+1;
+    }
+    tmds_cache_lru_head = (lines) ? 0       : NO_SLOT;
+    tmds_cache_lru_tail = (lines) ? lines-1 : NO_SLOT;
+
+    for (uint32_t i=0;i<BUCKET_COUNT;i++)
+        tmds_cache_bucket[i] = NO_SLOT;
+}
+
+void DELAYED_COPY_CODE(tmds_cache_release)(void)
+{
+    bool busy;
+
+    // wait until the DVI returned all cached lines
+    do
+    {
+        busy = false;
+        for (uint32_t i=0;i<tmds_cache_lines;i++)
+        {
+            busy |= (tmds_cache_slots[i].busy != 0);
+        }
+        if (busy)
+        {
+            uint32_t* tmdsbuf = tmds_cache_take();
+            tmds_cache_spare[tmds_cache_spare_count++] = tmdsbuf;
+        }
+    } while (busy);
+
+    // hand the spare buffers back to the DVI (dvi_destroy expects all buffers in the queues).
+    // The DVI interrupt is the producer of the free queue, so keep it out while adding.
+    while (tmds_cache_spare_count > 0)
+    {
+        uint32_t irq_state = save_and_disable_interrupts();
+        if (queue_spsc_try_add_u32(&dvi0.q_tmds_free, &tmds_cache_spare[tmds_cache_spare_count-1]))
+            tmds_cache_spare_count--;
+        restore_interrupts(irq_state);
+    }
+
+    free(tmds_cache_base);
+    tmds_cache_base  = NULL;
+    tmds_cache_end   = NULL;
+    tmds_cache_slots = NULL;
+    tmds_cache_lines = 0;
+    tmds_cache_bytes = 0;
+
+    // scanlines still to skip, when the cache is allocated again (dvi_init restarts the counting)
+    tmds_cache_skipped -= dvi0.scanline_skip;
+}
+
+void DELAYED_COPY_CODE(tmds_cache_profile)(uint32_t* pWaitCycles, uint32_t* pLineMax)
+{
+    *pWaitCycles = tmds_profile_wait;
+    *pLineMax    = tmds_profile_line_max;
+    tmds_profile_wait     = 0;
+    tmds_profile_line_max = 0;
+}
+
+void DELAYED_COPY_CODE(tmds_cache_invalidate)(void)
+{
+    for (uint32_t i=0;i<tmds_cache_lines;i++)
+    {
+        tmds_cache_slots[i].line  = TMDS_CACHE_NO_LINE;
+        tmds_cache_slots[i].valid = 0;
+    }
+    for (uint32_t i=0;i<BUCKET_COUNT;i++)
+        tmds_cache_bucket[i] = NO_SLOT;
+}
+
+// drop the hashes of the lines in the blocks written since the previous frame
+static inline void tmds_cache_clear_hashes(uint32_t* hashes, volatile uint8_t* dirty, bool tracked)
+{
+    for (uint32_t block=0;block<SHADOW_BLOCK_COUNT;block++)
+    {
+        if ((dirty[block])||(!tracked))
+        {
+            dirty[block] = 0;
+            for (uint32_t i=0;i<LINES_PER_BLOCK;i++)
+                hashes[block*LINES_PER_BLOCK+i] = 0;
+        }
+    }
+}
+
+void DELAYED_COPY_CODE(tmds_cache_start_frame)(uint32_t mode)
+{
+    tmds_cache_mode = mode;
+    tmds_cache_frame++;
+
+    // The menu (and the test patterns) write the shadow memory directly,
+    // bypassing the write tracking: no hashes are kept while it is shown.
+#ifdef FEATURE_TEST
+    tmds_cache_tracked = false;
+#else
+    tmds_cache_tracked = !IS_SOFTSWITCH(SOFTSW_MENU_ENABLE);
+#endif
+    tmds_cache_clear_hashes(tmds_cache_line_hashes[0], screen_dirty_main, tmds_cache_tracked);
+    tmds_cache_clear_hashes(tmds_cache_line_hashes[1], screen_dirty_aux,  tmds_cache_tracked);
+
+    // clear the flags before reading any screen memory
+    __dmb();
+}
+
+uint32_t DELAYED_COPY_CODE(tmds_cache_line_hash)(uint32_t hash, const volatile void* data)
+{
+    uint32_t* kept = NULL;
+
+    if (tmds_cache_tracked)
+    {
+        // line of the shadow memory (not a copy of the frame latch, not the splash screen...)
+        uintptr_t offset = (uintptr_t) data - (uintptr_t) apple_memory;
+        uint32_t  bank   = 0;
+        if (offset >= SHADOW_MEMORY_SIZE)
+        {
+            offset = (uintptr_t) data - (uintptr_t) aux_memory;
+            bank   = 1;
+        }
+        uint32_t block = offset >> SHADOW_BLOCK_SHIFT;
+        uint32_t index = (offset & ((1u << SHADOW_BLOCK_SHIFT)-1)) / 40;
+        if ((offset < SHADOW_MEMORY_SIZE)&&(offset == (block << SHADOW_BLOCK_SHIFT) + index*40)&&(index < LINES_PER_BLOCK))
+        {
+            kept = &tmds_cache_line_hashes[bank][block*LINES_PER_BLOCK+index];
+        }
+    }
+
+    uint32_t line_hash = (kept) ? *kept : 0;
+    if (line_hash == 0)
+    {
+        line_hash = tmds_cache_hash(0, data, 40/4);
+        // 0 marks lines which were not hashed
+        line_hash |= (line_hash == 0);
+        if (kept)
+            *kept = line_hash;
+    }
+
+    hash = (hash ^ line_hash) * 0x9e3779b1u;
+    return hash ^ (hash >> 15);
+}
+
+void DELAYED_COPY_CODE(tmds_cache_set_mode)(uint32_t mode)
+{
+    tmds_cache_mode = mode;
+}
+
+bool DELAYED_COPY_CODE(tmds_cache_skip_line)(void)
+{
+    // only the DVI IRQ counts up, only the renderer follows
+    if (tmds_cache_skipped == dvi0.scanline_skip)
+        return false;
+    tmds_cache_skipped++;
+    return true;
+}
+
+uint32_t DELAYED_COPY_CODE(tmds_cache_hit_ratio)(void)
+{
+    uint32_t hits   = tmds_cache_hits   - tmds_cache_last_hits;
+    uint32_t misses = tmds_cache_misses - tmds_cache_last_misses;
+    tmds_cache_last_hits   = tmds_cache_hits;
+    tmds_cache_last_misses = tmds_cache_misses;
+    if (hits+misses == 0)
+        return 0;
+    return (uint32_t) (((uint64_t) hits*100) / (hits+misses));
+}
+
+static inline void tmds_cache_submit(uint32_t slot)
+{
+    // we still need to take a buffer from the DVI, to keep the queues balanced
+    tmds_cache_spare[tmds_cache_spare_count++] = tmds_cache_take();
+
+    // a monochrome scanline still being expanded precedes the cached line
+    tmds_mono_flush();
+
+    uint32_t* tmdsbuf = slot_buffer(slot);
+    tmds_cache_slots[slot].busy++;
+    lru_touch(slot);
+    queue_spsc_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);
+    tmds_cache_hits++;
+}
+
+bool DELAYED_COPY_CODE(tmds_cache_resend)(uint32_t line, uint32_t hash)
+{
+    if (tmds_cache_lines == 0)
+        return false;
+
+    uint32_t slot = find_slot(line, hash);
+    if ((slot == NO_SLOT)||(!tmds_cache_slots[slot].valid))
+        return false;
+
+    tmds_cache_submit(slot);
+    return true;
+}
+
+bool DELAYED_COPY_CODE(tmds_cache_resend_lines)(uint32_t line, uint32_t count, uint32_t hash)
+{
+    uint16_t slots[8];
+
+    if (tmds_cache_lines == 0)
+        return false;
+
+    for (uint32_t i=0;i<count;i++)
+    {
+        slots[i] = find_slot(line+i, hash);
+        if ((slots[i] == NO_SLOT)||(!tmds_cache_slots[slots[i]].valid))
+            return false;
+    }
+
+    for (uint32_t i=0;i<count;i++)
+    {
+        tmds_cache_submit(slots[i]);
+    }
+    return true;
+}
+
+uint32_t* DELAYED_COPY_CODE(tmds_cache_get_scanline)(uint32_t line, uint32_t hash)
+{
+    uint32_t* tmdsbuf = tmds_cache_take();
+
+    if ((tmds_cache_lines == 0)||(line >= TMDS_CACHE_NO_LINE))
+        return tmdsbuf;
+
+    tmds_cache_misses++;
+
+    uint32_t slot = find_slot(line, hash);
+    if ((slot != NO_SLOT)&&(tmds_cache_slots[slot].busy))
+    {
+        // the cached line is still on display: we need a new slot
+        bucket_remove(slot);
+        slot = NO_SLOT;
+    }
+
+    if (slot == NO_SLOT)
+    {
+        // Replace the least recently used slot, which is not in use. Slots used
+        // in the current frame are never replaced: when the cache is smaller than
+        // the screen, the upper lines stay cached (instead of replacing every line
+        // before its next use).
+        slot = tmds_cache_lru_tail;
+        while ((slot != NO_SLOT)&&(tmds_cache_slots[slot].busy))
+            slot = tmds_cache_slots[slot].lru_prev;
+        if ((slot == NO_SLOT)||(tmds_cache_slots[slot].frame == tmds_cache_frame))
+            return tmdsbuf;
+
+        tmds_cache_slot_t* s = &tmds_cache_slots[slot];
+        if (s->line != TMDS_CACHE_NO_LINE)
+            bucket_remove(slot);
+
+        uint32_t bucket = bucket_index(tmds_cache_mode, line, hash);
+        s->mode  = tmds_cache_mode;
+        s->hash  = hash;
+        s->line  = line;
+        s->chain = tmds_cache_bucket[bucket];
+        tmds_cache_bucket[bucket] = slot;
+    }
+
+    // render directly into the cached line
+    tmds_cache_slots[slot].valid = 0;
+    tmds_cache_slots[slot].busy  = 1;
+    lru_touch(slot);
+    tmds_cache_spare[tmds_cache_spare_count++] = tmdsbuf;
+    return slot_buffer(slot);
+}
+
+void DELAYED_COPY_CODE(tmds_cache_send_scanline)(uint32_t* tmdsbuf)
+{
+    // keep the order of the scanlines
+    tmds_mono_flush();
+
+    if (is_cached_line(tmdsbuf))
+    {
+        // the DVI queue takes over from the renderer: the slot stays busy
+        tmds_cache_slots[(tmdsbuf - tmds_cache_base) / tmds_cache_words].valid = 1;
+    }
+    queue_spsc_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);
+}
@@ -0,0 +1,129 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// TMDS line cache: fully encoded scanlines of the Apple II screen area are kept
+// in a pool of buffers, keyed by the render mode, the display line and a hash
+// of the screen memory (which also covers the memory page). Scanlines found in
+// the pool are handed to the DVI DMA again, instead of being rendered and TMDS
+// encoded. The pool is managed as an LRU cache, so lines of both pages remain
+// cached when a program flips pages.
+//
+// Cached scanlines circulate through the same DVI queues as the normal TMDS
+// buffers. Every scanline sent to the DVI is preceded by taking one buffer
+// from the DVI free queue, so the queues never hold more than
+// DVI_N_TMDS_BUFFERS entries. Normal buffers, which were not needed since a
+// cached scanline was sent instead, are kept as spares by the renderer.
+
+// maximum number of cached scanlines (both pages of the 192 line screen area)
+#define TMDS_CACHE_MAX_LINES    (2*192)
+
+// line number for scanlines outside of the Apple II screen area (never cached)
+#define TMDS_CACHE_NO_LINE      0xffff
+
+// heap to keep available for other purposes, when sizing the line cache
+#define TMDS_CACHE_HEAP_RESERVE (16*1024)
+
+// Resulting cache size: the heap left after the DVI_N_TMDS_BUFFERS (8) scanline
+// buffers and the reserve, divided by the line size (scanline plus 24 bytes of slot):
+// - RP2040: the heap is what SRAM0-3 leave after code and data of core 0 and
+//   core 1 (see getTotalHeap). A line takes 3864 bytes (640 pixels) or 4344 bytes
+//   (720 pixels), so the cache needs a heap of 88KB (640) or 97KB (720) to get past
+//   its minimum of DVI_N_TMDS_BUFFERS+3 lines, plus 3.8KB (4.2KB) per further line.
+// - RP2350: SRAM4-7 without core 1's data and code (at most 64KB), so at least
+//   192KB of heap: 38 lines (640) or 33 lines (720). With FEATURE_HSTX (664/744
+//   bytes per line): 263 or 234 lines.
+// Every KB which core 1 does not need (see SHADOW_SAVED_BYTES) goes to the heap.
+// FEATURE_FRAME_LATCH allocates its memory first. FEATURE_INDEXED_LINES takes its
+// memory from the line cache, while a mode renders index lines (see tmds_index.h).
+
+// number of cached scanlines and the RAM used for them
+extern uint32_t tmds_cache_lines;
+extern uint32_t tmds_cache_bytes;
+
+// statistics: scanlines resent from/rendered into the cache
+extern uint32_t tmds_cache_hits;
+extern uint32_t tmds_cache_misses;
+
+// hash screen memory data (also used to chain several memory areas)
+static inline uint32_t tmds_cache_hash(uint32_t hash, const volatile void* data, uint32_t words)
+{
+    const uint32_t* p = (const uint32_t*) data;
+    // the memory address is part of the hash, so different pages never share a scanline
+    hash ^= (uint32_t)(uintptr_t) data;
+    for (uint32_t i=0;i<words;i++)
+    {
+        hash = (hash ^ p[i]) * 0x9e3779b1u;
+        hash ^= hash >> 15;
+    }
+    return hash;
+}
+
+// Hash of a 40 byte line of screen memory (a text/lores row or a HGR line),
+// chained to the given hash. Lines of the shadow memory are only hashed once:
+// the hash is kept until the bus handler writes to the memory block of the
+// line (see screen_dirty_main/aux), which tmds_cache_start_frame checks.
+extern uint32_t tmds_cache_line_hash(uint32_t hash, const volatile void* data);
+
+// allocate the line cache (after dvi_init)
+extern void      tmds_cache_init(void);
+// return all buffers to the DVI and free the line cache (before dvi_destroy)
+extern void      tmds_cache_release(void);
+// invalidate all cached lines
+extern void      tmds_cache_invalidate(void);
+// start a new frame, with the key of the current render mode (soft switches, flags, colors...),
+// and drop the kept hashes of the screen lines written since the previous frame
+extern void      tmds_cache_start_frame(uint32_t mode);
+// change the key of the render mode within a frame (display mode changes mid-frame)
+extern void      tmds_cache_set_mode(uint32_t mode);
+// hit ratio in percent (since the previous call)
+extern uint32_t  tmds_cache_hit_ratio(void);
+// CPU cycles waited for free TMDS buffers and of the slowest scanline (since the previous call)
+extern void      tmds_cache_profile(uint32_t* pWaitCycles, uint32_t* pLineMax);
+
+// resend the cached scanline of the given display line, if available
+extern bool      tmds_cache_resend(uint32_t line, uint32_t hash);
+// resend cached scanlines for a block of display lines (max 8), only when all are available
+extern bool      tmds_cache_resend_lines(uint32_t line, uint32_t count, uint32_t hash);
+
+// The DVI missed a scanline entirely (see dvi0.scanline_skip): the renderer skips
+// the next scanline it can (instead of rendering it), so the following scanlines
+// are displayed at their vertical position again. Call before getting a buffer.
+extern bool      tmds_cache_skip_line(void);
+
+// get a TMDS buffer for rendering the given display line (or TMDS_CACHE_NO_LINE)
+extern uint32_t* tmds_cache_get_scanline(uint32_t line, uint32_t hash);
+// send a rendered TMDS buffer to the DVI
+extern void      tmds_cache_send_scanline(uint32_t* tmdsbuf);
+
+#ifdef FEATURE_INDEXED_LINES
+// take a TMDS buffer returned by the DVI, for expanding an index line (NULL: none
+// available, when not waiting). Renderers use tmds_cache_get_scanline instead.
+extern uint32_t* tmds_cache_take_buffer(bool wait);
+#endif
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "tmds.h"
+#include "hstx_line.h"
 #include "config/config.h"
 #include "util/dmacopy.h"
 
@@ -363,5 +364,10 @@ void DELAYED_COPY_CODE(tmds_color_load_dhgr)(uint color_style)
     memcpy32(tmds_dhgr_red,   pSource,           sizeof(tmds_dhgr_red));
     memcpy32(tmds_dhgr_green, &pSource[16*16],   sizeof(tmds_dhgr_green));
     memcpy32(tmds_dhgr_blue,  &pSource[16*16*2], sizeof(tmds_dhgr_blue));
+#ifdef FEATURE_HSTX
+    hstx_convert_pairs(tmds_dhgr_red,   16*16, 1, HSTX_CHANNEL_RED);
+    hstx_convert_pairs(tmds_dhgr_green, 16*16, 1, HSTX_CHANNEL_GREEN);
+    hstx_convert_pairs(tmds_dhgr_blue,  16*16, 1, HSTX_CHANNEL_BLUE);
+#endif
 }
 
@@ -0,0 +1,521 @@
+// Generated by tools/tmds_table_gen.py from tmds_hires.c - do not edit:
+//   python3 tools/tmds_table_gen.py hires firmware/dvi/tmds_hires.c > firmware/dvi/tmds_hires_rgb.c
+
+#include "tmds.h"
+#include "config/config.h"
+
+// hires TMDS color patterns, interleaved: red, green, blue
+uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_rgb)[2*256*TMDS_HIRES_RGB_STRIDE] = {
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x00
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x01
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x02
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x03
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x04
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x05
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x06
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x07
+	0x7fd00, 0x7fd00, 0xdbd01, 0, // even 0x08
+	0xded01, 0xf9d01, 0x061fe, 0, // even 0x09
+	0xded01, 0xded01, 0xded01, 0, // even 0x0a
+	0x061fe, 0x231fc, 0x061fe, 0, // even 0x0b
+	0x7fd00, 0xded01, 0xbfd00, 0, // even 0x0c
+	0xf1d03, 0x231fc, 0xbfd00, 0, // even 0x0d
+	0xded01, 0xbfd00, 0xdbd01, 0, // even 0x0e
+	0xbfd00, 0xbfd00, 0xbfd00, 0, // even 0x0f
+	0xc0e8f, 0x7fd00, 0xc0e8f, 0, // even 0x10
+	0x9c671, 0x7fd00, 0x9c671, 0, // even 0x11
+	0x3fa18, 0x71d1c, 0xc0de3, 0, // even 0x12
+	0x3fa18, 0x71d1c, 0xc0de3, 0, // even 0x13
+	0x71d38, 0x71d38, 0x71d38, 0, // even 0x14
+	0x71d38, 0x71d38, 0x71d38, 0, // even 0x15
+	0x87639, 0x87639, 0xc0de3, 0, // even 0x16
+	0x87639, 0x87639, 0xc0de3, 0, // even 0x17
+	0x8e639, 0x78d1c, 0xbfa01, 0, // even 0x18
+	0x8e639, 0x78d1c, 0xbfa01, 0, // even 0x19
+	0x3fa18, 0x9cd38, 0xbfa01, 0, // even 0x1a
+	0x3fa18, 0x9cd38, 0xbfa01, 0, // even 0x1b
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0x1c
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0x1d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x1e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x1f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x20
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x21
+	0x78d1c, 0x78d1c, 0x7fd00, 0, // even 0x22
+	0x8e5e1, 0x71d1c, 0x7fd00, 0, // even 0x23
+	0x7fd00, 0x4e273, 0x7fd00, 0, // even 0x24
+	0xf9d01, 0x4e273, 0xf1d03, 0, // even 0x25
+	0x7fd00, 0x8761d, 0x78d1c, 0, // even 0x26
+	0xded01, 0x8761d, 0xc0de3, 0, // even 0x27
+	0xc0de3, 0xc0de3, 0x8e639, 0, // even 0x28
+	0x63d1c, 0x78d1c, 0x87639, 0, // even 0x29
+	0x63d70, 0x63d70, 0x63d70, 0, // even 0x2a
+	0x39d70, 0x9cd70, 0x39d70, 0, // even 0x2b
+	0xc0de3, 0x5c23b, 0x3fa18, 0, // even 0x2c
+	0x71d1c, 0x9c639, 0x3fa18, 0, // even 0x2d
+	0x63d70, 0xbfa01, 0x8e639, 0, // even 0x2e
+	0x3f170, 0x3fe01, 0x3f2c4, 0, // even 0x2f
+	0xc0d8f, 0xc0de3, 0xc0dc7, 0, // even 0x30
+	0x9cd70, 0xc0de3, 0x9cd38, 0, // even 0x31
+	0xbfa01, 0x71d38, 0x7fd00, 0, // even 0x32
+	0xbfa01, 0x71d38, 0x7fd00, 0, // even 0x33
+	0x4e273, 0x4e273, 0x71d1c, 0, // even 0x34
+	0x4e273, 0x4e273, 0x71d1c, 0, // even 0x35
+	0x8761d, 0x8761d, 0x7fd00, 0, // even 0x36
+	0x8761d, 0x8761d, 0x7fd00, 0, // even 0x37
+	0x8e639, 0x78d38, 0xbfa01, 0, // even 0x38
+	0x8e639, 0x78d38, 0xbfa01, 0, // even 0x39
+	0xbfa01, 0x9c671, 0xbfa01, 0, // even 0x3a
+	0xbfa01, 0x9c671, 0xbfa01, 0, // even 0x3b
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x3c
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x3d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x3e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x3f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x40
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x41
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x42
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x43
+	0x7fd00, 0x71d38, 0x7fd00, 0, // even 0x44
+	0xf9d01, 0x71d38, 0xf9d01, 0, // even 0x45
+	0x7fd00, 0x87639, 0x78d1c, 0, // even 0x46
+	0xded01, 0x87639, 0xc0de3, 0, // even 0x47
+	0x7fd00, 0xc0de3, 0x8e639, 0, // even 0x48
+	0xded01, 0x78d1c, 0x3f2c4, 0, // even 0x49
+	0x5c273, 0x63d70, 0x5c23b, 0, // even 0x4a
+	0x87671, 0x9cd70, 0x87639, 0, // even 0x4b
+	0x7fd00, 0x63d70, 0xbfa01, 0, // even 0x4c
+	0xf1d03, 0x9cd70, 0xbfa01, 0, // even 0x4d
+	0x5c273, 0x3fa18, 0x8e639, 0, // even 0x4e
+	0x3f28c, 0x3fa18, 0x3f2c4, 0, // even 0x4f
+	0xc0e8f, 0xc0de3, 0xc0e8f, 0, // even 0x50
+	0x9c671, 0xc0de3, 0x9c671, 0, // even 0x51
+	0x3fa18, 0x71d38, 0xc0de3, 0, // even 0x52
+	0x3fa18, 0x71d38, 0xc0de3, 0, // even 0x53
+	0x71d38, 0x71d38, 0x71d38, 0, // even 0x54
+	0x71d38, 0x71d38, 0x71d38, 0, // even 0x55
+	0x87639, 0x87639, 0xc0de3, 0, // even 0x56
+	0x87639, 0x87639, 0xc0de3, 0, // even 0x57
+	0x8ed70, 0x78d38, 0xbfa01, 0, // even 0x58
+	0x8ed70, 0x78d38, 0xbfa01, 0, // even 0x59
+	0x3fa18, 0x9c671, 0xbfa01, 0, // even 0x5a
+	0x3fa18, 0x9c671, 0xbfa01, 0, // even 0x5b
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0x5c
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0x5d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x5e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x5f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x60
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x61
+	0x78d1c, 0x78d38, 0x7fd00, 0, // even 0x62
+	0x8e5e1, 0x71d38, 0x7fd00, 0, // even 0x63
+	0x7fd00, 0x4e273, 0x7fd00, 0, // even 0x64
+	0xf9d01, 0x4e273, 0xf1d03, 0, // even 0x65
+	0x7fd00, 0x8761d, 0x78d1c, 0, // even 0x66
+	0xded01, 0x8761d, 0xc0de3, 0, // even 0x67
+	0xc0de3, 0x78d38, 0x8e639, 0, // even 0x68
+	0x63d1c, 0x78d38, 0x87639, 0, // even 0x69
+	0x63d70, 0x5c23b, 0x63d70, 0, // even 0x6a
+	0x39d70, 0x9c639, 0x39d70, 0, // even 0x6b
+	0xc0de3, 0x5c23b, 0x3fa18, 0, // even 0x6c
+	0x71d1c, 0x9c639, 0x3fa18, 0, // even 0x6d
+	0x63d70, 0xbfa01, 0x8e639, 0, // even 0x6e
+	0x3f170, 0x3fe01, 0x3f2c4, 0, // even 0x6f
+	0xc0d8f, 0xc0dc7, 0xc0dc7, 0, // even 0x70
+	0x9cd70, 0xc0dc7, 0x9cd38, 0, // even 0x71
+	0xbfa01, 0x4e273, 0x7fd00, 0, // even 0x72
+	0xbfa01, 0x4e273, 0x7fd00, 0, // even 0x73
+	0x4e273, 0x4e273, 0x71d1c, 0, // even 0x74
+	0x4e273, 0x4e273, 0x71d1c, 0, // even 0x75
+	0x8761d, 0x8761d, 0x7fd00, 0, // even 0x76
+	0x8761d, 0x8761d, 0x7fd00, 0, // even 0x77
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x78
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x79
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x7a
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x7b
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x7c
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x7d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x7e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x7f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x80
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x81
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x82
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x83
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x84
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x85
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x86
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0x87
+	0x7fd00, 0x7fd00, 0x8e639, 0, // even 0x88
+	0xded01, 0xf9d01, 0x87639, 0, // even 0x89
+	0x5c273, 0x5c273, 0x63d70, 0, // even 0x8a
+	0x87671, 0x9c671, 0x39d70, 0, // even 0x8b
+	0x7fd00, 0x63d70, 0xbfa01, 0, // even 0x8c
+	0xf1d03, 0x9cd70, 0xbfa01, 0, // even 0x8d
+	0x5c273, 0x3fa18, 0x8e639, 0, // even 0x8e
+	0x3f28c, 0x3fa18, 0x3f2c4, 0, // even 0x8f
+	0xc0e8f, 0x7fd00, 0xc0d8f, 0, // even 0x90
+	0x9c671, 0x7fd00, 0x9cd70, 0, // even 0x91
+	0x3fa18, 0x71d38, 0xc0dc7, 0, // even 0x92
+	0x3fa18, 0x71d38, 0xc0dc7, 0, // even 0x93
+	0x71d38, 0x71d38, 0x4e273, 0, // even 0x94
+	0x71d38, 0x71d38, 0x4e273, 0, // even 0x95
+	0x87639, 0x87639, 0xc0dc7, 0, // even 0x96
+	0x87639, 0x87639, 0xc0dc7, 0, // even 0x97
+	0x8e639, 0x78d1c, 0xbfa01, 0, // even 0x98
+	0x8e639, 0x78d1c, 0xbfa01, 0, // even 0x99
+	0x3fa18, 0x9cd38, 0xbfa01, 0, // even 0x9a
+	0x3fa18, 0x9cd38, 0xbfa01, 0, // even 0x9b
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0x9c
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0x9d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x9e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0x9f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xa0
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xa1
+	0x78d38, 0x78d38, 0xc0de3, 0, // even 0xa2
+	0x8ed38, 0x71d38, 0xc0de3, 0, // even 0xa3
+	0xc0de3, 0x4e273, 0xc0de3, 0, // even 0xa4
+	0x78d1c, 0x4e273, 0x71d1c, 0, // even 0xa5
+	0xc0de3, 0x8761d, 0x78d38, 0, // even 0xa6
+	0x63d1c, 0x8761d, 0xc0dc7, 0, // even 0xa7
+	0xc0de3, 0xc0de3, 0x8e639, 0, // even 0xa8
+	0x63d1c, 0x78d1c, 0x87639, 0, // even 0xa9
+	0x63d70, 0x63d70, 0x63d70, 0, // even 0xaa
+	0x39d70, 0x9cd70, 0x39d70, 0, // even 0xab
+	0xc0de3, 0x5c23b, 0x3fa18, 0, // even 0xac
+	0x71d1c, 0x9c639, 0x3fa18, 0, // even 0xad
+	0x63d70, 0xbfa01, 0x8e639, 0, // even 0xae
+	0x3f170, 0x3fe01, 0x3f2c4, 0, // even 0xaf
+	0xc0d8f, 0xc0de3, 0xc0d8f, 0, // even 0xb0
+	0x9cd70, 0xc0de3, 0x9cd70, 0, // even 0xb1
+	0xbfa01, 0x71d38, 0xc0dc7, 0, // even 0xb2
+	0xbfa01, 0x71d38, 0xc0dc7, 0, // even 0xb3
+	0x4e273, 0x4e273, 0x4e273, 0, // even 0xb4
+	0x4e273, 0x4e273, 0x4e273, 0, // even 0xb5
+	0x8761d, 0x8761d, 0xc0dc7, 0, // even 0xb6
+	0x8761d, 0x8761d, 0xc0dc7, 0, // even 0xb7
+	0x8e639, 0x78d38, 0xbfa01, 0, // even 0xb8
+	0x8e639, 0x78d38, 0xbfa01, 0, // even 0xb9
+	0xbfa01, 0x9c671, 0xbfa01, 0, // even 0xba
+	0xbfa01, 0x9c671, 0xbfa01, 0, // even 0xbb
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xbc
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xbd
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xbe
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xbf
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xc0
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xc1
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xc2
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xc3
+	0x7fd00, 0x71d38, 0xc0dc7, 0, // even 0xc4
+	0xf9d01, 0x71d38, 0x78d38, 0, // even 0xc5
+	0x7fd00, 0x87639, 0x78671, 0, // even 0xc6
+	0xded01, 0x87639, 0xc0e8f, 0, // even 0xc7
+	0x7fd00, 0xc0de3, 0x8e639, 0, // even 0xc8
+	0xded01, 0x78d1c, 0x3f2c4, 0, // even 0xc9
+	0x5c273, 0x63d70, 0x5c23b, 0, // even 0xca
+	0x87671, 0x9cd70, 0x87639, 0, // even 0xcb
+	0x7fd00, 0x63d70, 0xbfa01, 0, // even 0xcc
+	0xf1d03, 0x9cd70, 0xbfa01, 0, // even 0xcd
+	0x5c273, 0x3fa18, 0x8e639, 0, // even 0xce
+	0x3f28c, 0x3fa18, 0x3f2c4, 0, // even 0xcf
+	0xc0e8f, 0xc0de3, 0xc0d8f, 0, // even 0xd0
+	0x9c671, 0xc0de3, 0x9cd70, 0, // even 0xd1
+	0x3fa18, 0x71d38, 0xc0dc7, 0, // even 0xd2
+	0x3fa18, 0x71d38, 0xc0dc7, 0, // even 0xd3
+	0x71d38, 0x71d38, 0x4e273, 0, // even 0xd4
+	0x71d38, 0x71d38, 0x4e273, 0, // even 0xd5
+	0x87639, 0x87639, 0xc0dc7, 0, // even 0xd6
+	0x87639, 0x87639, 0xc0dc7, 0, // even 0xd7
+	0x8ed70, 0x78d38, 0xbfa01, 0, // even 0xd8
+	0x8ed70, 0x78d38, 0xbfa01, 0, // even 0xd9
+	0x3fa18, 0x9c671, 0xbfa01, 0, // even 0xda
+	0x3fa18, 0x9c671, 0xbfa01, 0, // even 0xdb
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0xdc
+	0x9c671, 0x9c671, 0xbfa01, 0, // even 0xdd
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xde
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xdf
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xe0
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // even 0xe1
+	0x78d38, 0x78671, 0xc0de3, 0, // even 0xe2
+	0x8ed38, 0x4e273, 0xc0de3, 0, // even 0xe3
+	0xc0de3, 0x4e273, 0xc0de3, 0, // even 0xe4
+	0x78d1c, 0x4e273, 0x71d1c, 0, // even 0xe5
+	0xc0de3, 0x8761d, 0x78d38, 0, // even 0xe6
+	0x63d1c, 0x8761d, 0xc0dc7, 0, // even 0xe7
+	0xc0de3, 0x78d38, 0x8e639, 0, // even 0xe8
+	0x63d1c, 0x78d38, 0x87639, 0, // even 0xe9
+	0x63d70, 0x5c23b, 0x63d70, 0, // even 0xea
+	0x39d70, 0x9c639, 0x39d70, 0, // even 0xeb
+	0xc0de3, 0x5c23b, 0x3fa18, 0, // even 0xec
+	0x71d1c, 0x9c639, 0x3fa18, 0, // even 0xed
+	0x63d70, 0xbfa01, 0x8e639, 0, // even 0xee
+	0x3f170, 0x3fe01, 0x3f2c4, 0, // even 0xef
+	0x402ff, 0x402ff, 0x402ff, 0, // even 0xf0
+	0x232fc, 0x402ff, 0x232fc, 0, // even 0xf1
+	0x806fe, 0x242fe, 0x402ff, 0, // even 0xf2
+	0x806fe, 0x242fe, 0x402ff, 0, // even 0xf3
+	0x242fe, 0x242fe, 0xf1e03, 0, // even 0xf4
+	0x242fe, 0x242fe, 0xf1e03, 0, // even 0xf5
+	0x062fe, 0x062fe, 0x402ff, 0, // even 0xf6
+	0x062fe, 0x062fe, 0x402ff, 0, // even 0xf7
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xf8
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xf9
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xfa
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xfb
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xfc
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xfd
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xfe
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // even 0xff
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x00
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x01
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x02
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x03
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x04
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x05
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x06
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x07
+	0xf9d01, 0xf9d01, 0x7fd00, 0, // odd  0x08
+	0x7fd00, 0xdbd01, 0xf9d01, 0, // odd  0x09
+	0xded01, 0xded01, 0xded01, 0, // odd  0x0a
+	0xded01, 0x061fe, 0xded01, 0, // odd  0x0b
+	0xbfd00, 0xf1d03, 0x7fd00, 0, // odd  0x0c
+	0x061fe, 0xdbd01, 0x7fd00, 0, // odd  0x0d
+	0xbfd00, 0x231fc, 0x061fe, 0, // odd  0x0e
+	0xbfd00, 0xbfd00, 0xbfd00, 0, // odd  0x0f
+	0x7fd00, 0xc0dc7, 0x7fd00, 0, // odd  0x10
+	0x7fd00, 0x71d38, 0x7fd00, 0, // odd  0x11
+	0x7fd00, 0x5c273, 0x87639, 0, // odd  0x12
+	0x7fd00, 0x5c273, 0x87639, 0, // odd  0x13
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x14
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x15
+	0x9c671, 0x9c671, 0x3f2c4, 0, // odd  0x16
+	0x9c671, 0x9c671, 0x3f2c4, 0, // odd  0x17
+	0x7fd00, 0x8761d, 0x78d1c, 0, // odd  0x18
+	0x7fd00, 0x8761d, 0x78d1c, 0, // odd  0x19
+	0x5c273, 0x3f170, 0xdbe01, 0, // odd  0x1a
+	0x5c273, 0x3f170, 0xdbe01, 0, // odd  0x1b
+	0x87639, 0x8761d, 0x7fd00, 0, // odd  0x1c
+	0x87639, 0x8761d, 0x7fd00, 0, // odd  0x1d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x1e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x1f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x20
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x21
+	0x7fd00, 0x7fd00, 0x8e639, 0, // odd  0x22
+	0x7fd00, 0x231fc, 0x87639, 0, // odd  0x23
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0x24
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0x25
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0x26
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0x27
+	0x63d70, 0x63d70, 0x63d70, 0, // odd  0x28
+	0x63d70, 0x39d70, 0x8ed70, 0, // odd  0x29
+	0x63d70, 0x63d70, 0x63d70, 0, // odd  0x2a
+	0x63d70, 0x39d70, 0x8ed70, 0, // odd  0x2b
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0x2c
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0x2d
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0x2e
+	0x3fe01, 0x3f28c, 0x3fe01, 0, // odd  0x2f
+	0x7fd00, 0xc0d8f, 0x7fa01, 0, // odd  0x30
+	0x7fd00, 0x63d70, 0xbfa01, 0, // odd  0x31
+	0x7fd00, 0x63d70, 0xbfa01, 0, // odd  0x32
+	0x7fd00, 0x63d70, 0xbfa01, 0, // odd  0x33
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x34
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x35
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x36
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x37
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0x38
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0x39
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0x3a
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0x3b
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x3c
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x3d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x3e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x3f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x40
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x41
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x42
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x43
+	0x9c671, 0x7fd00, 0x9c671, 0, // odd  0x44
+	0x4e273, 0xf9d01, 0x4e273, 0, // odd  0x45
+	0x8ed70, 0x78d1c, 0x3fa18, 0, // odd  0x46
+	0x9cd70, 0x71d1c, 0x3fa18, 0, // odd  0x47
+	0xbfa01, 0x71d38, 0x7fd00, 0, // odd  0x48
+	0xb9e03, 0x8ed38, 0x7fd00, 0, // odd  0x49
+	0xbfa01, 0x9c671, 0x87639, 0, // odd  0x4a
+	0xbfa01, 0x87671, 0x87639, 0, // odd  0x4b
+	0xbfa01, 0x71d38, 0x7fd00, 0, // odd  0x4c
+	0xb9e03, 0x8ed38, 0x7fd00, 0, // odd  0x4d
+	0xbfa01, 0x9c671, 0x87639, 0, // odd  0x4e
+	0x3fe01, 0x3f28c, 0x3f2c4, 0, // odd  0x4f
+	0xc0dc7, 0xc0dc7, 0xc0dc7, 0, // odd  0x50
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x51
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0x52
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0x53
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x54
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x55
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0x56
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0x57
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0x58
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0x59
+	0xbfa01, 0xbfa01, 0x87639, 0, // odd  0x5a
+	0xbfa01, 0xbfa01, 0x87639, 0, // odd  0x5b
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0x5c
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0x5d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x5e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x5f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x60
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x61
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0x62
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0x63
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0x64
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0x65
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0x66
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0x67
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0x68
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0x69
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0x6a
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0x6b
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0x6c
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0x6d
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0x6e
+	0x3fe01, 0x3f28c, 0x3fe01, 0, // odd  0x6f
+	0xc0e8f, 0xc0e8f, 0x7fa01, 0, // odd  0x70
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x71
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x72
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x73
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x74
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x75
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x76
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0x77
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x78
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x79
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x7a
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x7b
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x7c
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x7d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x7e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x7f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x80
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x81
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x82
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x83
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x84
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x85
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x86
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0x87
+	0x78d1c, 0x78d1c, 0x7fd00, 0, // odd  0x88
+	0xc0de3, 0x8e5e1, 0xf9d01, 0, // odd  0x89
+	0x5c273, 0x5c273, 0x5c273, 0, // odd  0x8a
+	0x5c273, 0x87671, 0x5c273, 0, // odd  0x8b
+	0x3fa18, 0x71d38, 0x7fd00, 0, // odd  0x8c
+	0x8761d, 0x8ed38, 0x7fd00, 0, // odd  0x8d
+	0x3fa18, 0x9c671, 0x87639, 0, // odd  0x8e
+	0x3fa18, 0x3f28c, 0x3f2c4, 0, // odd  0x8f
+	0x7fd00, 0xc0dc7, 0x7fd00, 0, // odd  0x90
+	0x7fd00, 0x71d38, 0x7fd00, 0, // odd  0x91
+	0x7fd00, 0x5c273, 0x87639, 0, // odd  0x92
+	0x7fd00, 0x5c273, 0x87639, 0, // odd  0x93
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x94
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0x95
+	0x9c671, 0x9c671, 0x3f2c4, 0, // odd  0x96
+	0x9c671, 0x9c671, 0x3f2c4, 0, // odd  0x97
+	0x7fd00, 0x8761d, 0x78d1c, 0, // odd  0x98
+	0x7fd00, 0x8761d, 0x78d1c, 0, // odd  0x99
+	0x5c273, 0x3f170, 0xdbe01, 0, // odd  0x9a
+	0x5c273, 0x3f170, 0xdbe01, 0, // odd  0x9b
+	0x87639, 0x8761d, 0x7fd00, 0, // odd  0x9c
+	0x87639, 0x8761d, 0x7fd00, 0, // odd  0x9d
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x9e
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0x9f
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xa0
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xa1
+	0x7fd00, 0x7fd00, 0x8e639, 0, // odd  0xa2
+	0x7fd00, 0x231fc, 0x87639, 0, // odd  0xa3
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0xa4
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0xa5
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0xa6
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0xa7
+	0x63d70, 0x63d70, 0x63d70, 0, // odd  0xa8
+	0x63d70, 0x39d70, 0x8ed70, 0, // odd  0xa9
+	0x63d70, 0x63d70, 0x63d70, 0, // odd  0xaa
+	0x63d70, 0x39d70, 0x8ed70, 0, // odd  0xab
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0xac
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0xad
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0xae
+	0x3fe01, 0x3f28c, 0x3fe01, 0, // odd  0xaf
+	0x7fd00, 0xc0d8f, 0x7fa01, 0, // odd  0xb0
+	0x7fd00, 0x63d70, 0xbfa01, 0, // odd  0xb1
+	0x7fd00, 0x63d70, 0xbfa01, 0, // odd  0xb2
+	0x7fd00, 0x63d70, 0xbfa01, 0, // odd  0xb3
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0xb4
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0xb5
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0xb6
+	0x9c671, 0x9c671, 0xbfa01, 0, // odd  0xb7
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0xb8
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0xb9
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0xba
+	0x63d70, 0xbfa01, 0x8e639, 0, // odd  0xbb
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xbc
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xbd
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xbe
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xbf
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xc0
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xc1
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xc2
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xc3
+	0x9c671, 0x7fd00, 0x9c671, 0, // odd  0xc4
+	0x4e273, 0xf9d01, 0x4e273, 0, // odd  0xc5
+	0x8ed70, 0x78d1c, 0x3fa18, 0, // odd  0xc6
+	0x9cd70, 0x71d1c, 0x3fa18, 0, // odd  0xc7
+	0xbfa01, 0x71d38, 0x7fd00, 0, // odd  0xc8
+	0xb9e03, 0x8ed38, 0x7fd00, 0, // odd  0xc9
+	0xbfa01, 0x9c671, 0x87639, 0, // odd  0xca
+	0xbfa01, 0x87671, 0x87639, 0, // odd  0xcb
+	0xbfa01, 0x71d38, 0x7fd00, 0, // odd  0xcc
+	0xb9e03, 0x8ed38, 0x7fd00, 0, // odd  0xcd
+	0xbfa01, 0x9c671, 0x87639, 0, // odd  0xce
+	0x3fe01, 0x3f28c, 0x3f2c4, 0, // odd  0xcf
+	0xc0dc7, 0xc0dc7, 0xc0dc7, 0, // odd  0xd0
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0xd1
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0xd2
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0xd3
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0xd4
+	0x71d38, 0x71d38, 0x71d38, 0, // odd  0xd5
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0xd6
+	0x9c671, 0x9c671, 0x3fa18, 0, // odd  0xd7
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0xd8
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0xd9
+	0xbfa01, 0xbfa01, 0x87639, 0, // odd  0xda
+	0xbfa01, 0xbfa01, 0x87639, 0, // odd  0xdb
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0xdc
+	0x8761d, 0x8761d, 0x7fd00, 0, // odd  0xdd
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xde
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xdf
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xe0
+	0x7fd00, 0x7fd00, 0x7fd00, 0, // odd  0xe1
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0xe2
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0xe3
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0xe4
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0xe5
+	0x8e639, 0x78d1c, 0xbfa01, 0, // odd  0xe6
+	0x9c639, 0x71d1c, 0xbfa01, 0, // odd  0xe7
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0xe8
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0xe9
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0xea
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0xeb
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0xec
+	0xbfa01, 0x87671, 0xbfa01, 0, // odd  0xed
+	0xbfa01, 0x9c671, 0xbfa01, 0, // odd  0xee
+	0x3fe01, 0x3f28c, 0x3fe01, 0, // odd  0xef
+	0x402ff, 0x402ff, 0x402ff, 0, // odd  0xf0
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf1
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf2
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf3
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf4
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf5
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf6
+	0x232fc, 0x232fc, 0x806fe, 0, // odd  0xf7
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xf8
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xf9
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xfa
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xfb
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xfc
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xfd
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xfe
+	0xbfe00, 0xbfe00, 0xbfe00, 0, // odd  0xff
+};
@@ -0,0 +1,233 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include "tmds.h"
+#include "tmds_index.h"
+#include "debug/debug.h"
+
+#ifdef FEATURE_INDEXED_LINES
+
+uint32_t DELAYED_COPY_DATA(tmds_index_lines);
+uint32_t DELAYED_COPY_DATA(tmds_index_bytes);
+
+// index lines (one block) and the pool of lines which are neither waiting nor being rendered
+static uint8_t*  DELAYED_COPY_DATA(tmds_index_base);
+static uint32_t  DELAYED_COPY_DATA(tmds_index_line_bytes);
+static uint8_t*  DELAYED_COPY_DATA(tmds_index_pool)[TMDS_INDEX_LINES];
+static uint32_t  DELAYED_COPY_DATA(tmds_index_pool_count);
+
+// sent index lines waiting for expansion (ring, oldest first)
+static uint8_t*  DELAYED_COPY_DATA(tmds_index_waiting)[TMDS_INDEX_LINES];
+static uint32_t  DELAYED_COPY_DATA(tmds_index_waiting_first);
+static uint32_t  DELAYED_COPY_DATA(tmds_index_waiting_count);
+
+// a renderer asked for an index line in the current frame, frames since the last
+// request, and the heap was too small for them (until the next tmds_index_init)
+static bool      DELAYED_COPY_DATA(tmds_index_wanted);
+static uint32_t  DELAYED_COPY_DATA(tmds_index_idle);
+static bool      DELAYED_COPY_DATA(tmds_index_no_heap);
+
+static inline void tmds_index_expand(uint32_t* tmdsbuf, const uint8_t* pairs)
+{
+    dvi_scanline_rgb(tmdsbuf, red, green, blue);
+    const uint32_t* words = (const uint32_t*) pairs;
+
+    // four pixel pairs per word
+    for (uint32_t i=0;i<DVI_WORDS_PER_CHANNEL/4;i++)
+    {
+        uint32_t data = words[i];
+        for (uint32_t j=0;j<4;j++)
+        {
+            uint32_t pair = data & 0xff;
+            dvi_add_pixel_pair(red, green, blue, tmds_dhgr_red[pair], tmds_dhgr_green[pair], tmds_dhgr_blue[pair]);
+            data >>= 8;
+        }
+    }
+}
+
+// Expand the oldest waiting index line into a TMDS buffer returned by the DVI,
+// and send it. Without waiting, nothing is done unless a buffer is available.
+static bool DELAYED_COPY_CODE(tmds_index_send_next)(bool wait)
+{
+    uint32_t* tmdsbuf = tmds_cache_take_buffer(wait);
+    if (tmdsbuf == NULL)
+        return false;
+
+    uint8_t* pairs = tmds_index_waiting[tmds_index_waiting_first];
+    if (++tmds_index_waiting_first == TMDS_INDEX_LINES)
+        tmds_index_waiting_first = 0;
+    tmds_index_waiting_count--;
+
+    tmds_index_expand(tmdsbuf, pairs);
+    queue_spsc_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);
+    tmds_index_pool[tmds_index_pool_count++] = pairs;
+    return true;
+}
+
+// expand waiting index lines, as long as the DVI has returned buffers for them
+static inline void tmds_index_pump(void)
+{
+    while ((tmds_index_waiting_count > 0)&&(tmds_index_send_next(false)))
+    {
+    }
+}
+
+void DELAYED_COPY_CODE(tmds_index_flush)(void)
+{
+    while (tmds_index_waiting_count > 0)
+        tmds_index_send_next(true);
+}
+
+// allocate the index lines, from the heap the line cache gives up
+static void DELAYED_COPY_CODE(tmds_index_alloc)(void)
+{
+    tmds_cache_release();
+
+    uint32_t free_heap = getFreeHeap();
+    uint32_t lines     = 0;
+    if (free_heap > TMDS_INDEX_HEAP_RESERVE)
+    {
+        lines = (free_heap - TMDS_INDEX_HEAP_RESERVE) / tmds_index_line_bytes;
+        if (lines > TMDS_INDEX_LINES)
+            lines = TMDS_INDEX_LINES;
+    }
+
+    tmds_index_base = NULL;
+    while ((lines >= TMDS_INDEX_MIN_LINES)&&(tmds_index_base == NULL))
+    {
+        tmds_index_base = malloc(lines*tmds_index_line_bytes);
+        if (tmds_index_base == NULL)
+            lines--;
+    }
+
+    if (tmds_index_base)
+    {
+        tmds_index_lines = lines;
+        tmds_index_bytes = lines*tmds_index_line_bytes;
+        for (uint32_t i=0;i<lines;i++)
+        {
+            tmds_index_pool[tmds_index_pool_count++] = tmds_index_base + i*tmds_index_line_bytes;
+        }
+    }
+    else
+    {
+        // keep rendering TMDS directly, without trying again every frame
+        tmds_index_no_heap = true;
+    }
+
+    tmds_cache_init();
+}
+
+// free the index lines and give their memory back to the line cache
+static void DELAYED_COPY_CODE(tmds_index_free)(bool resize_cache)
+{
+    if (!tmds_index_base)
+        return;
+
+    tmds_index_flush();
+    if (resize_cache)
+        tmds_cache_release();
+
+    free(tmds_index_base);
+    tmds_index_base       = NULL;
+    tmds_index_pool_count = 0;
+    tmds_index_lines      = 0;
+    tmds_index_bytes      = 0;
+
+    if (resize_cache)
+        tmds_cache_init();
+}
+
+void DELAYED_COPY_CODE(tmds_index_init)(void)
+{
+    tmds_index_line_bytes    = DVI_X_RESOLUTION/2;
+    tmds_index_base          = NULL;
+    tmds_index_pool_count    = 0;
+    tmds_index_waiting_first = 0;
+    tmds_index_waiting_count = 0;
+    tmds_index_lines         = 0;
+    tmds_index_bytes         = 0;
+    tmds_index_wanted        = false;
+    tmds_index_idle          = 0;
+    tmds_index_no_heap       = false;
+}
+
+void DELAYED_COPY_CODE(tmds_index_release)(void)
+{
+    // the line cache is released next
+    tmds_index_free(false);
+}
+
+void DELAYED_COPY_CODE(tmds_index_start_frame)(void)
+{
+    if (tmds_index_wanted)
+        tmds_index_idle = 0;
+    else
+    if (tmds_index_idle < TMDS_INDEX_IDLE_FRAMES)
+        tmds_index_idle++;
+
+    if ((tmds_index_base)&&(tmds_index_idle == TMDS_INDEX_IDLE_FRAMES))
+        tmds_index_free(true);
+    else
+    if ((!tmds_index_base)&&(tmds_index_wanted)&&(!tmds_index_no_heap))
+        tmds_index_alloc();
+
+    tmds_index_wanted = false;
+}
+
+uint32_t DELAYED_COPY_CODE(tmds_index_queued)(void)
+{
+    return tmds_index_waiting_count;
+}
+
+uint8_t* DELAYED_COPY_CODE(tmds_index_line)(void)
+{
+    tmds_index_wanted = true;
+    if (!tmds_index_base)
+        return NULL;
+
+    // all lines waiting: the oldest one must be displayed first
+    tmds_index_pump();
+    if (tmds_index_pool_count == 0)
+        tmds_index_send_next(true);
+    return tmds_index_pool[--tmds_index_pool_count];
+}
+
+void DELAYED_COPY_CODE(tmds_index_send_scanline)(uint8_t* pairs)
+{
+    // a monochrome scanline still being expanded precedes the index line
+    tmds_mono_flush();
+
+    uint32_t last = tmds_index_waiting_first + tmds_index_waiting_count;
+    if (last >= TMDS_INDEX_LINES)
+        last -= TMDS_INDEX_LINES;
+    tmds_index_waiting[last] = pairs;
+    tmds_index_waiting_count++;
+
+    tmds_index_pump();
+}
+
+#endif // FEATURE_INDEXED_LINES
@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Palette-indexed scanlines (FEATURE_INDEXED_LINES): renderers producing at
+// most 16 colors may render a compact 4bpp line instead of the TMDS symbols.
+// Each byte is a pixel pair (first pixel in the low nibble) of the DHGR palette,
+// and is expanded with the DHGR pair tables (tmds_dhgr_red/green/blue), which
+// provide "bit balanced" symbols for any two colors. The line covers the full
+// DVI_X_RESOLUTION (black borders are index 0). An index line (360 bytes at 720
+// pixels) costs a twelfth of a TMDS buffer.
+//
+// Sent index lines wait in a queue of up to TMDS_INDEX_LINES lines, and core 0
+// expands them into the TMDS buffers returned by the DVI, in order: whenever a
+// buffer is available while further index lines are rendered, and all of them
+// before a buffer is taken for any other scanline (so all other scanlines are
+// sent while no index line is waiting). The DVI interrupt only ever sees TMDS
+// buffers. The renderer can work far more lines ahead of the output, and a slow
+// line is absorbed by the queue: afterwards, only the cheaper expansion has to
+// catch up. Index lines are not cached.
+//
+// The index lines only take heap while they are used: when a frame asks for
+// them (currently the DHGR color renderer with artifacts, IFLAGS_INTERP_DHGR),
+// the line cache makes room for them at the start of the next frame, and gets
+// the memory back after TMDS_INDEX_IDLE_FRAMES frames without index lines.
+// Until then (and without the heap for them), renderers encode TMDS directly.
+
+#ifdef FEATURE_INDEXED_LINES
+
+// maximum number of pixels per index line
+#define TMDS_INDEX_MAX_PIXELS 720
+// maximum number of index lines (waiting or being rendered)
+#define TMDS_INDEX_LINES 128
+// fewer index lines would hardly let the renderer work further ahead than the TMDS buffers
+#define TMDS_INDEX_MIN_LINES DVI_N_TMDS_BUFFERS
+// heap to keep available, when sizing the index lines (the line cache is sized after them)
+#define TMDS_INDEX_HEAP_RESERVE (16*1024)
+// frames without index lines, before their memory goes back to the line cache
+#define TMDS_INDEX_IDLE_FRAMES 60
+
+// number of allocated index lines (0: currently not used, or the heap was too
+// small) and the RAM used for them
+extern uint32_t tmds_index_lines;
+extern uint32_t tmds_index_bytes;
+
+// reset (after dvi_init, nothing is allocated until a frame uses index lines)
+extern void     tmds_index_init(void);
+// send the waiting index lines and free them (before tmds_cache_release)
+extern void     tmds_index_release(void);
+// allocate/free the index lines, as the previous frames used them (before tmds_cache_start_frame)
+extern void     tmds_index_start_frame(void);
+// get the index line for rendering the next scanline (DVI_X_RESOLUTION/2 bytes,
+// word aligned). NULL: no index lines (yet), render the TMDS symbols directly.
+extern uint8_t* tmds_index_line(void);
+// send the index line (from tmds_index_line)
+extern void     tmds_index_send_scanline(uint8_t* pairs);
+// expand and send all waiting index lines (before taking a buffer for any other scanline)
+extern void     tmds_index_flush(void);
+// number of index lines waiting for expansion
+extern uint32_t tmds_index_queued(void);
+
+#else
+
+#define tmds_index_init()
+#define tmds_index_release()
+#define tmds_index_start_frame()
+#define tmds_index_line() ((uint8_t*) NULL)
+#define tmds_index_send_scanline(pairs)
+#define tmds_index_flush()
+#define tmds_index_queued() 0
+
+#endif
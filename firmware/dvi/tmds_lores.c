@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "tmds.h"
+#include "hstx_line.h"
 #include "config/config.h"
 #include "util/dmacopy.h"
 
@@ -30,6 +31,9 @@ SOFTWARE.
 // (each symbol covers two pixels and is encoded with a perfect 'bit balance').
 uint32_t __attribute__((section (".appledata."))) tmds_lorescolor[3*16];
 
+// LORES colors in DHGR dot order (DHGR dot patterns are the LORES colors, rotated right by one bit)
+uint32_t __attribute__((section (".appledata."))) tmds_dhgr_lores_rgb[4*16];
+
 // default: initial A2DVI color palette...
 // gray1 != gray2
 const uint32_t __in_flash("chr_rom") tmds_lores_default[3*16] =
@@ -118,4 +122,18 @@ void DELAYED_COPY_CODE(tmds_color_load_lores)(uint color_style)
             break;
     }
     memcpy32(tmds_lorescolor, pSource, sizeof(tmds_lorescolor));
+#ifdef FEATURE_HSTX
+    hstx_convert_pairs(&tmds_lorescolor[0], 16, 3, HSTX_CHANNEL_RED);
+    hstx_convert_pairs(&tmds_lorescolor[1], 16, 3, HSTX_CHANNEL_GREEN);
+    hstx_convert_pairs(&tmds_lorescolor[2], 16, 3, HSTX_CHANNEL_BLUE);
+#endif
+
+    for (uint dots=0;dots<16;dots++)
+    {
+        uint color = ((dots << 1) | (dots >> 3)) & 0xf;
+        tmds_dhgr_lores_rgb[dots*4+0] = tmds_lorescolor[color*3+0];
+        tmds_dhgr_lores_rgb[dots*4+1] = tmds_lorescolor[color*3+1];
+        tmds_dhgr_lores_rgb[dots*4+2] = tmds_lorescolor[color*3+2];
+        tmds_dhgr_lores_rgb[dots*4+3] = 0;
+    }
 }
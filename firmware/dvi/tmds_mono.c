@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "tmds.h"
+#include "tmds_mono.h"
+#include "config/config.h"
+#include "render/render_kernels.h"
+
+// 1bpp lines: one is rendered, while the other is expanded by the hardware encoder
+static uint32_t  DELAYED_COPY_DATA(tmds_mono_bits)[2][TMDS_MONO_MAX_PIXELS/32];
+static uint32_t  DELAYED_COPY_DATA(tmds_mono_index);
+// scanline expanded by the hardware encoder, which still needs to be sent
+static uint32_t* DELAYED_COPY_DATA(tmds_mono_pending);
+// hardware encoder is available
+static bool      DELAYED_COPY_DATA(tmds_mono_hw);
+
+uint32_t* DELAYED_COPY_CODE(tmds_mono_line)(void)
+{
+    return tmds_mono_bits[tmds_mono_index];
+}
+
+#ifdef FEATURE_HSTX
+void DELAYED_COPY_CODE(tmds_mono_send_scanline)(uint32_t* tmdsbuf, uint32_t xofs, uint32_t pixels, uint32_t color)
+{
+    // RGB332 pixels: the offset in pixel pairs is always even (whole words)
+    render_kernel_mono(tmdsbuf + xofs/2, tmds_mono_bits[tmds_mono_index], pixels, tmds_mono_rgb332[color]);
+    tmds_cache_send_scanline(tmdsbuf);
+}
+#else
+static inline void tmds_mono_expand(uint32_t* tmdsbuf, const uint32_t* bits, uint32_t pixels, uint32_t level)
+{
+    render_kernel_mono(tmdsbuf, bits, pixels, tmds_mono_nibble[level]);
+}
+
+void DELAYED_COPY_CODE(tmds_mono_send_scanline)(uint32_t* tmdsbuf, uint32_t xofs, uint32_t pixels, uint32_t color)
+{
+    uint32_t* bits = tmds_mono_bits[tmds_mono_index];
+    uint32_t* channel[3];
+    uint32_t  level[3];
+
+    // channels of the scanline are blue, green, red - the colors are defined as red, green, blue
+    for (uint32_t ch=0;ch<3;ch++)
+    {
+        channel[ch] = tmdsbuf + ch*DVI_WORDS_PER_CHANNEL + xofs;
+        level[ch]   = tmds_mono_level(tmds_mono_double_pixel[color*3+2-ch]);
+    }
+
+    if (tmds_mono_hw)
+    {
+        uint32_t* encode  = NULL;
+        uint32_t* half    = NULL;
+        uint32_t* copy[2] = {NULL, NULL};
+        uint32_t* fill[2] = {NULL, NULL};
+        uint32_t  copies  = 0;
+        uint32_t  fills   = 0;
+
+        for (uint32_t ch=0;ch<3;ch++)
+        {
+            if (level[ch] == 0)
+                fill[fills++] = channel[ch];
+            else
+            if (level[ch] == 1)
+                half = channel[ch];
+            else
+            if (encode == NULL)
+                encode = channel[ch];
+            else
+                copy[copies++] = channel[ch];
+        }
+
+        if (encode)
+        {
+            // the PIO encodes full words: pixels beyond the end of the line are black
+            uint32_t words = (pixels+31)/32;
+            if (pixels & 31)
+                bits[words-1] &= (1u << (pixels & 31)) - 1;
+
+            // one scanline at a time: the previous one is complete when its DMA chain finished
+            tmds_mono_flush();
+            tmds_mono_pio_start(bits, words, encode, copy, fill, words*16);
+            if (half)
+                tmds_mono_expand(half, bits, pixels, 1);
+
+            // the scanline is sent later, the next line is rendered into the other buffer
+            tmds_mono_pending = tmdsbuf;
+            tmds_mono_index ^= 1;
+            return;
+        }
+    }
+
+    for (uint32_t ch=0;ch<3;ch++)
+    {
+        tmds_mono_expand(channel[ch], bits, pixels, level[ch]);
+    }
+    tmds_cache_send_scanline(tmdsbuf);
+}
+#endif // FEATURE_HSTX
+
+void DELAYED_COPY_CODE(tmds_mono_flush)(void)
+{
+    uint32_t* tmdsbuf = tmds_mono_pending;
+    if (tmdsbuf == NULL)
+        return;
+
+    tmds_mono_pending = NULL;
+    while (tmds_mono_pio_busy())
+    {
+    }
+    tmds_cache_send_scanline(tmdsbuf);
+}
+
+void DELAYED_COPY_CODE(tmds_mono_init)(void)
+{
+    tmds_mono_pending = NULL;
+    tmds_mono_hw      = tmds_mono_pio_init();
+}
+
+void DELAYED_COPY_CODE(tmds_mono_release)(void)
+{
+    tmds_mono_flush();
+    if (tmds_mono_hw)
+        tmds_mono_pio_release();
+    tmds_mono_hw = false;
+}
@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Monochrome scanlines: the renderers only produce a packed 1bpp line (first
+// pixel in the least significant bit), which is expanded to the TMDS symbols of
+// the selected color (white/green/amber...).
+//
+// The expansion is done by libdvi's tmds_encode_1bpp PIO program, on a spare
+// state machine of the DVI PIO, fed and drained by DMA. The PIO encodes one
+// channel with full intensity, the DMA copies it to the other full intensity
+// channels and fills the unused channels with black. A half intensity channel
+// (green of amber) is still expanded by the CPU, while the DMA is running.
+// Without a spare state machine (or DMA channel), the CPU expands all channels.
+// HSTX builds (RGB332 scanlines) always expand the line on the CPU, with a
+// table of four RGB332 pixels per 4bit pattern (tmds_mono_rgb332).
+//
+// The expansion of a scanline runs while the next line is rendered: the
+// scanline is sent to the DVI when the next scanline is sent (any scanline,
+// also cached ones), or at the end of the frame.
+
+// maximum number of pixels per 1bpp line
+#define TMDS_MONO_MAX_PIXELS 640
+
+// get the 1bpp line buffer for rendering the next monochrome scanline
+extern uint32_t* tmds_mono_line(void);
+
+// expand the 1bpp line (from tmds_mono_line) into the scanline, starting at the given word offset
+// of each channel (pixel pair offset), and send the scanline to the DVI (pixels: multiple of 4)
+extern void tmds_mono_send_scanline(uint32_t* tmdsbuf, uint32_t xofs, uint32_t pixels, uint32_t color);
+// wait for the pending scanline and send it to the DVI
+extern void tmds_mono_flush(void);
+
+// claim the PIO state machine and DMA channels (after dvi_init)
+extern void tmds_mono_init(void);
+// send the pending scanline and release the PIO state machine and DMA channels (before dvi_destroy)
+extern void tmds_mono_release(void);
+
+// hardware encoder (tmds_mono_pio.c): the PIO encodes the 1bpp pixels (padded to full words)
+// into the channel at 'encode', which is then copied to the 'copy' channels, and black is
+// written to the 'fill' channels ('count' words each, unused entries are NULL)
+extern bool tmds_mono_pio_init(void);
+extern void tmds_mono_pio_release(void);
+extern void tmds_mono_pio_start(const uint32_t* bits, uint32_t words, uint32_t* encode, uint32_t* copy[2], uint32_t* fill[2], uint32_t count);
+extern bool tmds_mono_pio_busy(void);
+
+// collects bits for a 1bpp line
+typedef struct
+{
+    uint32_t* line;
+    uint64_t  bits;
+    uint32_t  count;
+} tmds_mono_writer_t;
+
+static inline void tmds_mono_begin(tmds_mono_writer_t* w)
+{
+    w->line  = tmds_mono_line();
+    w->bits  = 0;
+    w->count = 0;
+}
+
+// append up to 32 pixels
+static inline void tmds_mono_put(tmds_mono_writer_t* w, uint32_t bits, uint32_t count)
+{
+    w->bits  |= ((uint64_t) bits) << w->count;
+    w->count += count;
+    if (w->count >= 32)
+    {
+        *(w->line++) = (uint32_t) w->bits;
+        w->bits >>= 32;
+        w->count -= 32;
+    }
+}
+
+// store the remaining pixels
+static inline void tmds_mono_end(tmds_mono_writer_t* w)
+{
+    if (w->count)
+        *(w->line) = (uint32_t) w->bits;
+}
+
+// double each of the 7 pixels (40 column text)
+static inline uint32_t tmds_mono_double7(uint32_t bits)
+{
+    bits = (bits | (bits << 4)) & 0x0f0f;
+    bits = (bits | (bits << 2)) & 0x3333;
+    bits = (bits | (bits << 1)) & 0x5555;
+    return bits | (bits << 1);
+}
@@ -0,0 +1,227 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "tmds.h"
+#include "tmds_mono.h"
+#include "config/config.h"
+
+#ifdef FEATURE_HSTX
+
+// HSTX builds: there is no DVI PIO (and the scanlines hold channel values
+// instead of TMDS symbols), so the CPU expands the monochrome lines.
+bool DELAYED_COPY_CODE(tmds_mono_pio_init)(void)    { return false; }
+void DELAYED_COPY_CODE(tmds_mono_pio_release)(void) {}
+bool DELAYED_COPY_CODE(tmds_mono_pio_busy)(void)    { return false; }
+void DELAYED_COPY_CODE(tmds_mono_pio_start)(const uint32_t* bits, uint32_t words, uint32_t* encode, uint32_t* copy[2], uint32_t* fill[2], uint32_t count) {}
+
+#else
+
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+
+#include "tmds_encode_1bpp.pio.h"
+
+// The libdvi encoder uses position dependent symbols, so pixel pairs are always
+// bit balanced: 0x100/0x200 for even pixels, 0x1ff/0x2ff for odd pixels. These
+// match the TMDS_SYMBOL_x_y pairs, except for a pair with only the first pixel
+// set, which is FF/01 (instead of FE/00). Both are displayed identically.
+//
+// DMA: a TX channel feeds the 1bpp words to the state machine. A data channel
+// is loaded by a control channel from a list of control blocks: draining the
+// RX FIFO to the encoded channel, copying/filling the other channels and
+// finally a null block, which stops the chain.
+
+typedef struct
+{
+    const volatile void* read;
+    volatile void*       write;
+    uint32_t             count;
+    uint32_t             ctrl;
+} tmds_mono_dma_block_t;
+
+// encoding, 2 copies/fills, null block
+#define TMDS_MONO_DMA_BLOCKS 4
+
+static PIO                    DELAYED_COPY_DATA(tmds_mono_pio);
+static int                    DELAYED_COPY_DATA(tmds_mono_sm);
+static uint                   DELAYED_COPY_DATA(tmds_mono_offset);
+static int                    DELAYED_COPY_DATA(tmds_mono_tx_channel);
+static int                    DELAYED_COPY_DATA(tmds_mono_data_channel);
+static int                    DELAYED_COPY_DATA(tmds_mono_ctrl_channel);
+static uint32_t               DELAYED_COPY_DATA(tmds_mono_ctrl_encode);
+static uint32_t               DELAYED_COPY_DATA(tmds_mono_ctrl_copy);
+static uint32_t               DELAYED_COPY_DATA(tmds_mono_ctrl_fill);
+static tmds_mono_dma_block_t  DELAYED_COPY_DATA(tmds_mono_blocks)[TMDS_MONO_DMA_BLOCKS];
+static tmds_mono_dma_block_t* DELAYED_COPY_DATA(tmds_mono_blocks_end);
+static uint32_t               DELAYED_COPY_DATA(tmds_mono_black) = TMDS_SYMBOL_0_0;
+
+// control word of the data channel
+static uint32_t tmds_mono_dma_ctrl(bool read_increment, uint dreq)
+{
+    dma_channel_config cfg = dma_channel_get_default_config(tmds_mono_data_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, read_increment);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_dreq(&cfg, dreq);
+    channel_config_set_chain_to(&cfg, tmds_mono_ctrl_channel);
+    return channel_config_get_ctrl_value(&cfg);
+}
+
+bool DELAYED_COPY_CODE(tmds_mono_pio_init)(void)
+{
+    // spare state machine of the DVI serialiser's PIO
+    PIO pio = dvi0.ser_cfg->pio;
+    int sm  = pio_claim_unused_sm(pio, false);
+    if (sm < 0)
+        return false;
+    if (!pio_can_add_program(pio, &tmds_encode_1bpp_program))
+    {
+        pio_sm_unclaim(pio, sm);
+        return false;
+    }
+
+    int channels[3];
+    for (uint i=0;i<3;i++)
+    {
+        channels[i] = dma_claim_unused_channel(false);
+        if (channels[i] < 0)
+        {
+            while (i > 0)
+                dma_channel_unclaim(channels[--i]);
+            pio_sm_unclaim(pio, sm);
+            return false;
+        }
+    }
+
+    tmds_mono_pio          = pio;
+    tmds_mono_sm           = sm;
+    tmds_mono_tx_channel   = channels[0];
+    tmds_mono_data_channel = channels[1];
+    tmds_mono_ctrl_channel = channels[2];
+
+    // same configuration as libdvi's tmds_encode_1bpp_init
+    tmds_mono_offset = pio_add_program(pio, &tmds_encode_1bpp_program);
+    pio_sm_config c = tmds_encode_1bpp_program_get_default_config(tmds_mono_offset);
+    sm_config_set_out_shift(&c, true, true, 32);
+    sm_config_set_in_shift(&c, true, true, 24);
+    pio_sm_init(pio, sm, tmds_mono_offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+
+    // TX channel: 1bpp words to the state machine
+    dma_channel_config cfg = dma_channel_get_default_config(tmds_mono_tx_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(tmds_mono_tx_channel, &cfg, &pio->txf[sm], NULL, 0, false);
+
+    // control blocks for the data channel
+    tmds_mono_ctrl_encode = tmds_mono_dma_ctrl(false, pio_get_dreq(pio, sm, false));
+    tmds_mono_ctrl_copy   = tmds_mono_dma_ctrl(true,  DREQ_FORCE);
+    tmds_mono_ctrl_fill   = tmds_mono_dma_ctrl(false, DREQ_FORCE);
+
+    // control channel: writes one block (4 words) to the data channel registers, the last one triggers
+    cfg = dma_channel_get_default_config(tmds_mono_ctrl_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, true);
+    channel_config_set_ring(&cfg, true, 4);
+    dma_channel_configure(tmds_mono_ctrl_channel, &cfg, &dma_hw->ch[tmds_mono_data_channel].read_addr,
+        tmds_mono_blocks, 4, false);
+
+    // nothing started yet: the control channel's read address is the end of the (empty) block list
+    tmds_mono_blocks_end = tmds_mono_blocks;
+
+    return true;
+}
+
+void DELAYED_COPY_CODE(tmds_mono_pio_release)(void)
+{
+    while (tmds_mono_pio_busy())
+    {
+    }
+
+    pio_sm_set_enabled(tmds_mono_pio, tmds_mono_sm, false);
+    pio_remove_program(tmds_mono_pio, &tmds_encode_1bpp_program, tmds_mono_offset);
+    pio_sm_unclaim(tmds_mono_pio, tmds_mono_sm);
+
+    dma_channel_unclaim(tmds_mono_tx_channel);
+    dma_channel_unclaim(tmds_mono_data_channel);
+    dma_channel_unclaim(tmds_mono_ctrl_channel);
+}
+
+void DELAYED_COPY_CODE(tmds_mono_pio_start)(const uint32_t* bits, uint32_t words, uint32_t* encode, uint32_t* copy[2], uint32_t* fill[2], uint32_t count)
+{
+    tmds_mono_dma_block_t* b = tmds_mono_blocks;
+
+    b->read  = &tmds_mono_pio->rxf[tmds_mono_sm];
+    b->write = encode;
+    b->count = count;
+    b->ctrl  = tmds_mono_ctrl_encode;
+    b++;
+
+    for (uint i=0;i<2;i++)
+    {
+        if (copy[i])
+        {
+            b->read  = encode;
+            b->write = copy[i];
+            b->count = count;
+            b->ctrl  = tmds_mono_ctrl_copy;
+            b++;
+        }
+    }
+
+    for (uint i=0;i<2;i++)
+    {
+        if (fill[i])
+        {
+            b->read  = &tmds_mono_black;
+            b->write = fill[i];
+            b->count = count;
+            b->ctrl  = tmds_mono_ctrl_fill;
+            b++;
+        }
+    }
+
+    // null block: a zero control word does not trigger the data channel
+    b->read  = NULL;
+    b->write = NULL;
+    b->count = 0;
+    b->ctrl  = 0;
+    tmds_mono_blocks_end = b+1;
+
+    dma_channel_set_read_addr(tmds_mono_ctrl_channel, tmds_mono_blocks, true);
+    dma_channel_transfer_from_buffer_now(tmds_mono_tx_channel, bits, words);
+}
+
+bool DELAYED_COPY_CODE(tmds_mono_pio_busy)(void)
+{
+    // the control channel has loaded the null block when all blocks are complete
+    return (dma_hw->ch[tmds_mono_ctrl_channel].read_addr != (uintptr_t) tmds_mono_blocks_end)||
+           dma_channel_is_busy(tmds_mono_ctrl_channel)||
+           dma_channel_is_busy(tmds_mono_data_channel);
+}
+
+#endif // FEATURE_HSTX
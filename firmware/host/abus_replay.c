@@ -0,0 +1,321 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host replay of recorded Apple II bus cycles.
+// Feeds the 32-bit words of a bus trace through abus_interface(), exactly as
+// the core-1 loop receives them from the abus.pio RX FIFO:
+//   bits 25..10: address bus, bit 9: R/W (1=read), bit 8: ~SELECT (0=card
+//   selected), bits 7..0: data bus (only valid for write cycles).
+// The trace file is a plain sequence of little-endian 32-bit words (see
+// tools/abus_trace_gen.py).
+// Reports the handler throughput and the margin against the 1.023MHz bus
+// clock, plus the resulting soft switches and checksums of the shadowed main
+// and aux memory, which serve as a regression reference for the soft switch
+// emulation.
+// The trace is also replayed with only the cycles pushed by the filtering PIO
+// program (abus_filter in abus.pio), which must result in the same state.
+// The margin is measured on the host CPU: it compares handler variants, but
+// is not the margin of the RP2040/RP2350.
+//
+// Usage: abus_replay <trace file> [passes] [II|IIE|IIE_ENH]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "applebus/buffers.h"
+#include "applebus/abus.h"
+#include "config/config.h"
+
+// Apple II bus clock: 1.023MHz
+#define APPLE_BUS_CYCLE_NS  (1000000000.0/1023000.0)
+
+// cycles per block, for the worst-case handler time
+#define REPLAY_BLOCK_CYCLES 1024
+
+typedef struct
+{
+    const char* name;
+    compat_t    machine;
+} replay_machine_t;
+
+static const replay_machine_t replay_machines[] =
+{
+    {"II",      MACHINE_II},
+    {"IIE",     MACHINE_IIE},
+    {"IIE_ENH", MACHINE_IIE_ENH}
+};
+
+typedef struct
+{
+    const char* name;
+    uint32_t    flag;
+} replay_softswitch_t;
+
+static const replay_softswitch_t replay_softswitches[] =
+{
+    {"TEXT",     SOFTSW_TEXT_MODE},
+    {"MIXED",    SOFTSW_MIX_MODE},
+    {"HIRES",    SOFTSW_HIRES_MODE},
+    {"PAGE2",    SOFTSW_PAGE_2},
+    {"INTCXROM", SOFTSW_INTCXROM},
+    {"80STORE",  SOFTSW_80STORE},
+    {"RAMRD",    SOFTSW_AUX_READ},
+    {"RAMWRT",   SOFTSW_AUX_WRITE},
+    {"ALTZP",    SOFTSW_AUXZP},
+    {"SLOTC3ROM",SOFTSW_SLOT3ROM},
+    {"80COL",    SOFTSW_80COL},
+    {"ALTCHAR",  SOFTSW_ALTCHAR},
+    {"DGR",      SOFTSW_DGR},
+    {"MONO",     SOFTSW_MONOCHROME},
+    {"IOUDIS",   SOFTSW_IOUDIS},
+    {"VIDEX",    SOFTSW_VIDEX_80COL},
+    {"MENU",     SOFTSW_MENU_ENABLE},
+    {"SPLASH",   SOFTSW_SHOW_SPLASH}
+};
+
+typedef struct
+{
+    uint32_t soft_switches;
+    uint32_t main_memory;
+    uint32_t aux_memory;
+    uint32_t resets;
+    uint32_t devicereg_access;
+    uint32_t vblank_reads;
+} replay_state_t;
+
+static inline uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec)*1000000000u + ts.tv_nsec;
+}
+
+static uint32_t fnv1a(const uint8_t* data, uint32_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (uint32_t i=0;i<size;i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t* load_trace(const char* filename, uint32_t* pCycles)
+{
+    FILE* f = fopen(filename, "rb");
+    if (!f)
+        return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint32_t  cycles = (size > 0) ? (uint32_t) (size / 4) : 0;
+    uint32_t* trace  = malloc((cycles+1)*4);
+    if ((trace)&&(fread(trace, 4, cycles, f) != cycles))
+    {
+        free(trace);
+        trace = NULL;
+    }
+    fclose(f);
+
+    // trace files are little-endian
+    for (uint32_t i=0;(trace)&&(i<cycles);i++)
+    {
+        const uint8_t* p = (const uint8_t*) &trace[i];
+        trace[i] = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+    }
+
+    *pCycles = cycles;
+    return trace;
+}
+
+// model of the abus_filter PIO program: is the bus cycle pushed to the FIFO?
+static bool abus_filter_push(uint32_t value)
+{
+    switch(ADDRESS_BUS_HI_NIBBLE(value))
+    {
+        case 0x0:
+        case 0x2 ... 0x5:
+            return ACCESS_WRITE(value);
+        case 0xC:
+            return true;
+        case 0xF:
+            return ACCESS_READ(value);
+        default:
+            return false;
+    }
+}
+
+// power-on state of the bus interface
+static void replay_reset(compat_t machine)
+{
+    memset(apple_memory, 0, sizeof(apple_memory));
+    memset(aux_memory,   0, sizeof(aux_memory));
+    soft_switches        = SOFTSW_TEXT_MODE | SOFTSW_V7_MODE3;
+    internal_flags       = 0;
+    last_read_address    = 0;
+    reset_counter        = 0;
+    devicereg_counter    = 0;
+    vblank_counter       = 0;
+    bus_cycle_counter    = 0;
+    set_machine(machine);
+}
+
+// replay the trace from the power-on state, returns the total time
+// (every pass starts from the power-on state, so all passes produce the same result)
+static uint64_t replay_run(const uint32_t* trace, uint32_t cycles, uint32_t passes, compat_t machine, uint64_t* pBlockMax)
+{
+    uint64_t total_ns = 0;
+    *pBlockMax = 0;
+    for (uint32_t pass=0;pass<passes;pass++)
+    {
+        replay_reset(machine);
+        for (uint32_t i=0;i<cycles;)
+        {
+            uint32_t block_end = i+REPLAY_BLOCK_CYCLES;
+            if (block_end > cycles)
+                block_end = cycles;
+            uint64_t start_ns = time_ns();
+            for (;i<block_end;i++)
+            {
+                abus_interface(trace[i]);
+                bus_cycle_counter++;
+            }
+            uint64_t block_ns = time_ns() - start_ns;
+            total_ns += block_ns;
+            if ((block_end % REPLAY_BLOCK_CYCLES == 0)&&(block_ns > *pBlockMax))
+                *pBlockMax = block_ns;
+        }
+    }
+    return total_ns;
+}
+
+static void replay_get_state(replay_state_t* pState)
+{
+    pState->soft_switches    = soft_switches;
+    pState->main_memory      = fnv1a(apple_memory, sizeof(apple_memory));
+    pState->aux_memory       = fnv1a(aux_memory,   sizeof(aux_memory));
+    pState->resets           = reset_counter;
+    pState->devicereg_access = devicereg_counter;
+    pState->vblank_reads     = vblank_counter;
+}
+
+// apple_cycles: bus cycles on the Apple II bus, words: bus cycles processed by core 1
+static void replay_report(const char* name, uint32_t apple_cycles, uint32_t words, uint32_t passes, uint64_t total_ns, uint64_t block_ns_max)
+{
+    double ns_per_cycle     = (double) total_ns / ((double) apple_cycles*passes);
+    double max_ns_per_word  = (double) block_ns_max / REPLAY_BLOCK_CYCLES;
+    printf("%-10s %10u %14.0f %12.2f %14.2f %11.1fx %11.1fx\n",
+           name, words,
+           1000000000.0/ns_per_cycle, ns_per_cycle, max_ns_per_word,
+           APPLE_BUS_CYCLE_NS/ns_per_cycle,
+           (block_ns_max) ? APPLE_BUS_CYCLE_NS/max_ns_per_word : 0.0);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <trace file> [passes] [II|IIE|IIE_ENH]\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t passes = (argc > 2) ? atoi(argv[2]) : 10;
+    const replay_machine_t* pMachine = &replay_machines[2];
+    if (passes == 0)
+        passes = 1;
+    if (argc > 3)
+    {
+        pMachine = NULL;
+        for (uint i=0;i<sizeof(replay_machines)/sizeof(replay_machines[0]);i++)
+        {
+            if (strcasecmp(argv[3], replay_machines[i].name) == 0)
+                pMachine = &replay_machines[i];
+        }
+        if (!pMachine)
+        {
+            printf("Unknown machine type: %s\n", argv[3]);
+            return 1;
+        }
+    }
+
+    uint32_t  cycles;
+    uint32_t* trace = load_trace(argv[1], &cycles);
+    if ((!trace)||(cycles == 0))
+    {
+        printf("Cannot read bus trace: %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("A2DVI bus replay: %s, %u bus cycles, %u passes, machine %s\n", argv[1], cycles, passes, pMachine->name);
+
+    // cycles pushed by the filtering PIO program
+    uint32_t  filtered_cycles = 0;
+    uint32_t* filtered = malloc(cycles*4);
+    for (uint32_t i=0;i<cycles;i++)
+    {
+        if (abus_filter_push(trace[i]))
+            filtered[filtered_cycles++] = trace[i];
+    }
+
+    replay_state_t state, filtered_state;
+    uint64_t block_ns_max;
+    uint64_t filtered_block_ns_max;
+    uint64_t filtered_ns = replay_run(filtered, filtered_cycles, passes, pMachine->machine, &filtered_block_ns_max);
+    replay_get_state(&filtered_state);
+    uint64_t total_ns    = replay_run(trace, cycles, passes, pMachine->machine, &block_ns_max);
+    replay_get_state(&state);
+
+    printf("%-10s %10s %14s %12s %14s %12s %12s\n", "PROGRAM", "PUSHED", "CYCLES/S", "NS/CYCLE", "MAX NS/PUSH", "MARGIN", "MIN MARGIN");
+    replay_report("ABUS",        cycles, cycles,          passes, total_ns,    block_ns_max);
+    replay_report("ABUS_FILTER", cycles, filtered_cycles, passes, filtered_ns, filtered_block_ns_max);
+
+    printf("SOFT SWITCHES: %08x", soft_switches);
+    for (uint i=0;i<sizeof(replay_softswitches)/sizeof(replay_softswitches[0]);i++)
+    {
+        if (soft_switches & replay_softswitches[i].flag)
+            printf(" %s", replay_softswitches[i].name);
+    }
+    printf("\n");
+    printf("MACHINE:       %u (internal flags %08x)\n", current_machine, internal_flags);
+    printf("COLOR MODE:    %u\n", color_mode);
+    printf("RESETS:        %u\n", reset_counter);
+    printf("DEVICE REGS:   %u\n", devicereg_counter);
+    printf("VBLANK READS:  %u\n", vblank_counter);
+    printf("MAIN MEMORY:   %08x\n", state.main_memory);
+    printf("AUX MEMORY:    %08x\n", state.aux_memory);
+
+    free(filtered);
+    free(trace);
+
+    if (memcmp(&state, &filtered_state, sizeof(state)) != 0)
+    {
+        printf("Filtered bus cycles result in a different state!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host implementation of the DVI scanline queues.
+// There is no serialiser: a scanline is "displayed" the moment it is sent,
+// and its buffer immediately goes back to the free queue.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dvi/tmds.h"
+#include "dvi/a2dvi.h"
+#include "dvi/tmds_index.h"
+#include "config/config.h"
+#include "render/render.h"
+#include "host_dvi.h"
+
+struct dvi_inst dvi0;
+
+host_scanline_hook_t host_scanline_hook;
+
+static uint32_t* tmds_buffers[DVI_N_TMDS_BUFFERS];
+static uintptr_t q_free_data[DVI_N_TMDS_BUFFERS+1];
+static uintptr_t q_valid_data[DVI_N_TMDS_BUFFERS+1];
+static uint32_t  host_lines_per_frame = 525;
+
+static inline uint16_t queue_inc_index(queue_t *q, uint16_t index)
+{
+    if (++index > q->element_count) // element_count + 1 slots
+        index = 0;
+    return index;
+}
+
+static inline uint32_t queue_level(queue_t *q)
+{
+    int32_t level = (int32_t) q->wptr - (int32_t) q->rptr;
+    if (level < 0)
+        level += q->element_count + 1;
+    return level;
+}
+
+static void queue_setup(queue_t *q, uintptr_t* data, uint16_t element_count)
+{
+    q->data          = data;
+    q->element_count = element_count;
+    q->rptr          = 0;
+    q->wptr          = 0;
+}
+
+bool queue_spsc_try_add_u32(queue_t *q, void *data)
+{
+    if (queue_level(q) == q->element_count)
+        return false;
+    q->data[q->wptr] = *(uintptr_t*)data;
+    q->wptr = queue_inc_index(q, q->wptr);
+    return true;
+}
+
+bool queue_spsc_try_remove_u32(queue_t *q, void *data)
+{
+    if (queue_level(q) == 0)
+        return false;
+    *(uintptr_t*)data = q->data[q->rptr];
+    q->rptr = queue_inc_index(q, q->rptr);
+    return true;
+}
+
+void queue_spsc_add_blocking_u32(queue_t *q, void *data)
+{
+    if (!queue_spsc_try_add_u32(q, data))
+        abort(); // nothing would ever drain the queue on the host
+
+    if (q == &dvi0.q_tmds_valid)
+    {
+        uint32_t* buf = NULL;
+        queue_spsc_try_remove_u32(&dvi0.q_tmds_valid, &buf);
+        if (host_scanline_hook)
+            host_scanline_hook(buf);
+        queue_spsc_try_add_u32(&dvi0.q_tmds_free, &buf);
+    }
+}
+
+void queue_spsc_remove_blocking_u32(queue_t *q, void *data)
+{
+    // a renderer holding on to all buffers would block forever on real hardware, too
+    if (!queue_spsc_try_remove_u32(q, data))
+        abort();
+}
+
+void a2dvi_dvi_enable(uint32_t video_mode)
+{
+    uint32_t x_resolution = (video_mode == Dvi640x480) ? 640 : 720;
+    host_lines_per_frame  = (video_mode == Dvi720x576) ? 624 : (video_mode == Dvi800x480) ? 500 : 525;
+    tmds_mono_release();
+    tmds_index_release();
+    tmds_cache_release();
+    DVI_INIT_RESOLUTION(x_resolution);
+
+    queue_setup(&dvi0.q_tmds_free,  q_free_data,  DVI_N_TMDS_BUFFERS);
+    queue_setup(&dvi0.q_tmds_valid, q_valid_data, DVI_N_TMDS_BUFFERS);
+
+    for (uint i=0;i<DVI_N_TMDS_BUFFERS;i++)
+    {
+        // initialized with black pixels (as by dvi_init)
+        free(tmds_buffers[i]);
+        tmds_buffers[i] = malloc(DVI_SCANLINE_WORDS*sizeof(uint32_t));
+        for (uint j=0;j<DVI_SCANLINE_WORDS;j++)
+            tmds_buffers[i][j] = TMDS_SYMBOL_0_0;
+        queue_spsc_try_add_u32(&dvi0.q_tmds_free, &tmds_buffers[i]);
+    }
+
+    render_latch_init();
+    tmds_index_init();
+    tmds_cache_init();
+    tmds_mono_init();
+}
+
+uint32_t a2dvi_lines_per_frame(void)
+{
+    return host_lines_per_frame;
+}
+
+uint32_t a2dvi_scanline_errors(uint32_t* recovered)
+{
+    if (recovered)
+        *recovered = dvi0.scanline_recovered;
+    return dvi0.scanline_errors;
+}
@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host model of the HSTX output path (see host_hstx.h).
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dvi/tmds.h"
+#include "dvi/hstx_line.h"
+#include "host_hstx.h"
+
+// RGB332 pixel from 8bit channel values
+#define RGB332(r, g, b) (((r) & 0xe0) | (((g) & 0xe0) >> 3) | (((b) & 0xc0) >> 6))
+
+#ifdef FEATURE_HSTX
+
+typedef struct
+{
+    uint32_t rot;
+    uint32_t nbits;
+    uint32_t rgb332_bits; // channel bits of an RGB332 pixel
+    uint32_t rgb332_shift; // left shift of these bits to the channel's MSBs
+} hstx_lane_cfg_t;
+
+// expander configuration of the TMDS lanes (blue, green, red)
+static const hstx_lane_cfg_t hstx_lanes[3] =
+{
+    {HSTX_RGB332_LANE0_ROT, HSTX_RGB332_LANE0_NBITS, 0x03, 6},
+    {HSTX_RGB332_LANE1_ROT, HSTX_RGB332_LANE1_NBITS, 0x1c, 3},
+    {HSTX_RGB332_LANE2_ROT, HSTX_RGB332_LANE2_NBITS, 0xe0, 0}
+};
+
+static inline uint32_t ror32(uint32_t v, uint32_t n)
+{
+    n &= 31;
+    return (n) ? (v >> n) | (v << (32-n)) : v;
+}
+
+// DVI TMDS data encoding: transition minimized 9bit code, then DC balanced
+// (inverted) depending on the running disparity of the lane
+static uint32_t tmds_encode(uint32_t d, int32_t* disparity)
+{
+    uint32_t n1   = __builtin_popcount(d);
+    bool     xnor = (n1 > 4)||((n1 == 4)&&((d & 1) == 0));
+    uint32_t q_m  = d & 1;
+    for (uint32_t i=1;i<8;i++)
+    {
+        uint32_t bit = ((q_m >> (i-1)) ^ (d >> i)) & 1;
+        q_m |= (bit ^ xnor) << i;
+    }
+    if (!xnor)
+        q_m |= 0x100;
+
+    int32_t  ones  = __builtin_popcount(q_m & 0xff);
+    int32_t  zeros = 8 - ones;
+    uint32_t q_m8  = (q_m >> 8) & 1;
+
+    if ((*disparity == 0)||(ones == zeros))
+    {
+        if (q_m8)
+        {
+            *disparity += ones - zeros;
+            return q_m;
+        }
+        *disparity += zeros - ones;
+        return 0x200 | (q_m ^ 0xff);
+    }
+
+    if (((*disparity > 0)&&(ones > zeros))||((*disparity < 0)&&(zeros > ones)))
+    {
+        *disparity += 2*q_m8 + zeros - ones;
+        return 0x200 | (q_m ^ 0xff);
+    }
+
+    *disparity += -2*(q_m8 ^ 1) + ones - zeros;
+    return q_m;
+}
+
+void host_hstx_scanline(uint8_t* rgb332, const uint32_t* tmdsbuf)
+{
+    int32_t disparity[3] = {0, 0, 0};
+    const uint8_t* pixels = (const uint8_t*) tmdsbuf;
+
+    // the HSTX expander and TMDS encoder, and the display's TMDS decoder
+    for (uint32_t x=0;x<DVI_X_RESOLUTION;x++)
+    {
+        uint32_t shifter = ror32(tmdsbuf[x/HSTX_RGB332_PIXELS], (x%HSTX_RGB332_PIXELS)*HSTX_RGB332_SHIFT);
+        uint32_t value[3];
+
+        for (uint32_t lane=0;lane<3;lane++)
+        {
+            const hstx_lane_cfg_t* cfg = &hstx_lanes[lane];
+            uint32_t mask   = (0xff << (7-cfg->nbits)) & 0xff;
+            uint32_t symbol = tmds_encode(ror32(shifter, cfg->rot) & mask, &disparity[lane]);
+            value[lane]     = hstx_tmds_decode(symbol);
+
+            // must match the rendered pixel's bits of the channel
+            uint32_t expected = (pixels[x] & cfg->rgb332_bits) << cfg->rgb332_shift;
+            if (value[lane] != expected)
+            {
+                fprintf(stderr, "HSTX model: lane %u, pixel %u: %02x instead of %02x\n", lane, x, value[lane], expected);
+                abort();
+            }
+        }
+
+        rgb332[x] = RGB332(value[2], value[1], value[0]);
+    }
+}
+
+#else
+
+void host_hstx_scanline(uint8_t* rgb332, const uint32_t* tmdsbuf)
+{
+    const uint32_t* blue  = tmdsbuf;
+    const uint32_t* green = blue  + DVI_WORDS_PER_CHANNEL;
+    const uint32_t* red   = green + DVI_WORDS_PER_CHANNEL;
+
+    for (uint32_t x=0;x<DVI_X_RESOLUTION;x++)
+    {
+        uint32_t shift = (x & 1)*10;
+        rgb332[x] = RGB332(hstx_tmds_decode((red[x/2]   >> shift) & 0x3ff),
+                           hstx_tmds_decode((green[x/2] >> shift) & 0x3ff),
+                           hstx_tmds_decode((blue[x/2]  >> shift) & 0x3ff));
+    }
+}
+
+#endif // FEATURE_HSTX
@@ -0,0 +1,43 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Model of the DVI output path, down to the pixels a display would show with
+// the HSTX output (RGB332). Compares the TMDS build with the HSTX build:
+//
+// TMDS build: the TMDS symbol pairs of the scanline are decoded (as a display
+// would), and reduced to RGB332.
+//
+// HSTX build (FEATURE_HSTX): the scanline's RGB332 pixels (sent as they are by
+// the DVI DMA) are expanded into the TMDS lanes according to the HSTX expander
+// configuration, TMDS encoded (8b/10b, with DC balancing) and decoded again.
+// Any mismatch with the pixel's channel bits aborts.
+//
+// Both builds must produce the identical RGB332 scanlines.
+
+// RGB332 pixels of a scanline (DVI_X_RESOLUTION bytes)
+extern void host_hstx_scanline(uint8_t* rgb332, const uint32_t* tmdsbuf);
@@ -0,0 +1,169 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host replacements for the firmware modules which are not part of the
+// render pipeline or the bus interface (config/flash, menu, DMA copy, timer).
+
+#include <string.h>
+#include <time.h>
+
+#include "applebus/abus_setup.h"
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "debug/debug.h"
+#include "dvi/tmds_mono.h"
+#include "dvi/tmds_index.h"
+#include "fonts/textfont.h"
+#include "menu/menu.h"
+#include "util/dmacopy.h"
+#include "host_dvi.h"
+#include "hardware/interp.h"
+
+volatile compat_t  detected_machine = MACHINE_AUTO;
+volatile compat_t  cfg_machine      = MACHINE_IIE_ENH;
+volatile compat_t  current_machine  = MACHINE_IIE_ENH;
+volatile bool      language_switch  = false;
+volatile uint8_t   reload_charsets  = 3;
+volatile bool      reload_colors;
+
+bool               videx_enabled;
+uint8_t            cfg_videx_selection = 1;
+uint8_t            cfg_local_charset   = 0;
+uint8_t            cfg_alt_charset     = 0;
+uint32_t           invalid_fonts       = 0xffffffff;
+uint8_t            cfg_color_style;
+volatile uint8_t   color_mode          = COLOR_MODE_BW;
+ScanlineMode_t     cfg_scanline_mode   = ScanlinesOff;
+rendering_fx_t     cfg_rendering_fx    = FX_ENABLED;
+DviVideoMode_t     cfg_video_mode      = Dvi640x480;
+ToggleSwitchMode_t input_switch_mode   = ModeSwitchDisabled;
+
+bool  IgnoreNextKeypress;
+char* TitleGitHub[2]                    = {"", ""};
+char* MenuColorMode[COLOR_MODE_AMBER+1] = {"BLACK & WHITE", "GREEN", "AMBER"};
+
+uint64_t time_us_64(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec)*1000000u + ts.tv_nsec/1000;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t) time_us_64();
+}
+
+// default: heap remaining on an RP2040, after the DVI buffers were allocated
+uint32_t host_free_heap = 96*1024;
+
+uint32_t getFreeHeap(void)
+{
+#ifdef FEATURE_INDEXED_LINES
+    // the index lines are allocated from the heap while a mode renders them
+    return host_free_heap - tmds_index_bytes;
+#else
+    return host_free_heap;
+#endif
+}
+
+void memcpy32(void *dst, const void *src, uint32_t size)
+{
+    memcpy(dst, src, size);
+}
+
+void dmacopy_disable_dma(void)
+{
+}
+
+// custom fonts in flash (unused, since flash writes are not supported)
+uint8_t __font_roms_start[MAX_FONT_COUNT*CHARACTER_ROM_SIZE];
+
+void set_machine(compat_t machine)
+{
+    // same register set selection as config.c (fonts are fixed on the host)
+    switch(machine)
+    {
+        case MACHINE_IIE:
+        case MACHINE_IIE_ENH:
+            internal_flags &= ~IFLAGS_IIGS_REGS;
+            internal_flags |=  IFLAGS_IIE_REGS;
+            break;
+        default:
+            internal_flags &= ~(IFLAGS_IIGS_REGS|IFLAGS_IIE_REGS);
+            break;
+    }
+    current_machine = machine;
+}
+
+bool config_flash_write(void* flash_address, uint8_t* data, uint32_t size)
+{
+    return false;
+}
+
+void config_font_update(void)   {}
+void config_load(void)          {}
+void config_load_defaults(void) {}
+void config_save(void)          {}
+
+// the bus is fed by abus_replay, not by the PIO
+void abus_pio_setup(void)       {}
+
+// no PIO: the CPU expands the monochrome scanlines
+bool tmds_mono_pio_init(void)    { return false; }
+void tmds_mono_pio_release(void) {}
+bool tmds_mono_pio_busy(void)    { return false; }
+void tmds_mono_pio_start(const uint32_t* bits, uint32_t words, uint32_t* encode, uint32_t* copy[2], uint32_t* fill[2], uint32_t count) {}
+
+void config_load_charsets(void)
+{
+    // fixed US fonts: there is no font directory in flash
+    memcpy32(character_rom,                      textfont_iie_us_enhanced, CHARACTER_ROM_SIZE);
+    memcpy32(&character_rom[CHARACTER_ROM_SIZE], textfont_iie_us_enhanced, CHARACTER_ROM_SIZE);
+    memcpy32(character_rom_videx_normal,         videx_normal,             CHARACTER_ROM_SIZE);
+    memcpy32(character_rom_videx_inverse,        videx_inverse,            CHARACTER_ROM_SIZE);
+    reload_charsets = 0;
+}
+
+// the menu is not available on the host
+void printXY(uint32_t x, uint32_t line, const char* pMsg, TPrintMode PrintMode) {}
+void centerY(uint32_t y, const char* pMsg, TPrintMode PrintMode) {}
+void clearTextScreen(void) {}
+void showTitle(TPrintMode PrintMode) {}
+void menuShow(char key) {}
+void menuShowSaved(void) {}
+
+void int2str(uint32_t value, char* pStrBuf, uint32_t digits)
+{
+    uint8_t done = 0;
+    for (int32_t i=digits-1;i>=0;i--)
+    {
+        pStrBuf[i] = (done) ? (' '|0x80) : (0x80|'0')+(value % 10);
+        value /= 10;
+        done = (value == 0);
+    }
+    pStrBuf[digits]=0;
+}
+
+// SIO interpolators (see hardware/interp.h)
+interp_hw_t host_interp[2];
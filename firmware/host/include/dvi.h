@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host replacement for libdvi's dvi.h: keeps the scanline queue interface used
+// by the renderers (dvi_get_scanline/dvi_send_scanline), but without any
+// PIO/DMA serialiser behind it. The queues are served by host/host_dvi.c.
+
+#pragma once
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+#define DELAYED_COPY_CODE(n) __noinline __attribute__((section(".delayed_code."))) n
+#define DELAYED_COPY_DATA(n) __attribute__((section(".delayed_data."))) n
+
+#ifndef DVI_N_TMDS_BUFFERS
+#define DVI_N_TMDS_BUFFERS 8
+#endif
+
+// simple single-threaded ring of pointer-sized elements (the firmware
+// queues buffer addresses, which do not fit 32bit on a 64bit host)
+typedef struct
+{
+    uintptr_t* data;
+    uint16_t  element_count;
+    uint16_t  rptr;
+    uint16_t  wptr;
+} queue_t;
+
+struct dvi_inst
+{
+    volatile uint32_t scanline_skip;
+    uint32_t scanline_errors;
+    uint32_t scanline_recovered;
+    uint8_t  scanline_emulation;
+
+    queue_t  q_tmds_valid;
+    queue_t  q_tmds_free;
+};
+
+// Host queue access. Adding to dvi0.q_tmds_valid "displays" the scanline
+// immediately and returns its buffer to dvi0.q_tmds_free.
+extern void queue_spsc_add_blocking_u32   (queue_t *q, void *data);
+extern void queue_spsc_remove_blocking_u32(queue_t *q, void *data);
+extern bool queue_spsc_try_add_u32        (queue_t *q, void *data);
+extern bool queue_spsc_try_remove_u32     (queue_t *q, void *data);
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Minimal host model of the SIO interpolators: lane results (shift, mask,
+// cross input, base) as used by the render kernels. Bases and results are
+// pointer sized, so lane results can address host memory.
+
+#pragma once
+
+#include "pico.h"
+
+typedef struct
+{
+    uint shift;
+    uint mask_lsb;
+    uint mask_msb;
+    bool cross_input;
+} interp_config;
+
+typedef struct
+{
+    uint32_t      accum[2];
+    uintptr_t     base[3];
+    interp_config ctrl[2];
+} interp_hw_t;
+
+extern interp_hw_t host_interp[2];
+
+#define interp0 (&host_interp[0])
+#define interp1 (&host_interp[1])
+
+static inline interp_config interp_default_config(void)
+{
+    interp_config c = {0, 0, 31, false};
+    return c;
+}
+
+static inline void interp_config_set_shift(interp_config* c, uint shift)
+{
+    c->shift = shift;
+}
+
+static inline void interp_config_set_mask(interp_config* c, uint mask_lsb, uint mask_msb)
+{
+    c->mask_lsb = mask_lsb;
+    c->mask_msb = mask_msb;
+}
+
+static inline void interp_config_set_cross_input(interp_config* c, bool cross_input)
+{
+    c->cross_input = cross_input;
+}
+
+static inline void interp_set_config(interp_hw_t* interp, uint lane, interp_config* config)
+{
+    interp->ctrl[lane] = *config;
+}
+
+static inline void interp_set_base(interp_hw_t* interp, uint lane, uintptr_t val)
+{
+    interp->base[lane] = val;
+}
+
+static inline void interp_set_accumulator(interp_hw_t* interp, uint lane, uint32_t val)
+{
+    interp->accum[lane] = val;
+}
+
+static inline uintptr_t interp_peek_lane_result(interp_hw_t* interp, uint lane)
+{
+    const interp_config* c = &interp->ctrl[lane];
+    uint32_t input = interp->accum[c->cross_input ? 1-lane : lane];
+    uint32_t mask  = (0xffffffffu >> (31 - c->mask_msb)) & ~((1u << c->mask_lsb) - 1);
+    return interp->base[lane] + ((input >> c->shift) & mask);
+}
@@ -0,0 +1,43 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Minimal host replacement for the PIO API used by the Apple II bus interface.
+// There is no PIO state machine on the host: bus cycles are fed directly into
+// abus_interface() (see abus_replay.c), so the RX FIFO is always empty.
+
+#pragma once
+
+#include "pico.h"
+
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t* PIO;
+
+#define pio0 ((PIO) 0)
+#define pio1 ((PIO) 1)
+
+static inline uint     pio_sm_get_rx_fifo_level(PIO pio, uint sm) { return 0; }
+static inline bool     pio_sm_is_rx_fifo_full  (PIO pio, uint sm) { return false; }
+static inline bool     pio_sm_is_rx_fifo_empty (PIO pio, uint sm) { return true; }
+static inline uint32_t pio_sm_get              (PIO pio, uint sm) { return 0; }
+static inline uint32_t pio_sm_get_blocking     (PIO pio, uint sm) { return 0; }
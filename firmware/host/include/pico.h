@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Minimal host replacement for the pico-sdk base header.
+// Only provides what the render pipeline needs to build natively on Linux.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sched.h>
+
+typedef unsigned int uint;
+
+#ifndef __noinline
+#define __noinline __attribute__((noinline))
+#endif
+
+#define __time_critical_func(func_name)  func_name
+#define __not_in_flash_func(func_name)   func_name
+#define __force_inline                   inline __attribute__((always_inline))
+#define __in_flash(group)                __attribute__((section(".flashdata." group)))
+
+#define PICO_DEFAULT_LED_PIN 25
+
+typedef uint64_t absolute_time_t;
+
+// host time in microseconds (monotonic clock)
+extern uint64_t time_us_64(void);
+extern uint32_t time_us_32(void);
+
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t) (t / 1000); }
+
+// GPIOs are not available on the host
+static inline bool gpio_get(uint gpio) { (void) gpio; return false; }
+static inline void gpio_xor_mask(uint32_t mask) { (void) mask; }
+
+// waiting for an event: let the other thread run (the queue stress test may share a single CPU)
+static inline void __wfe(void) { sched_yield(); }
+static inline void __sev(void) {}
+// a real barrier: the queue stress test runs producer and consumer on two threads
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
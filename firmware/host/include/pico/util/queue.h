@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+// Host version of the PICO_SDK's queue_t, with the SDK's layout, so the
+// libdvi queue functions (util_queue_u32_inline.h) can be tested on the host
+// (see queue_stress.c). The renderers use the simpler queue of host/include/dvi.h.
+
+typedef struct
+{
+    spin_lock_t* spin_lock;
+} lock_core_t;
+
+typedef struct
+{
+    lock_core_t core;
+    uint8_t*    data;
+    uint16_t    wptr;
+    uint16_t    rptr;
+    uint16_t    element_size;
+    uint16_t    element_count;
+} queue_t;
+
+static inline uint queue_get_level_unsafe(queue_t *q)
+{
+    int32_t rc = (int32_t) q->wptr - (int32_t) q->rptr;
+    if (rc < 0)
+        rc += q->element_count + 1;
+    return (uint) rc;
+}
@@ -0,0 +1,199 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host stress test of the lock-free DVI scanline queues (queue_spsc_* in
+// libdvi/util_queue_u32_inline.h).
+// Two threads circulate DVI_N_TMDS_BUFFERS buffers through a "free" and a
+// "valid" queue, just like the renderer and the DVI DMA interrupt: the
+// renderer thread takes a free buffer, writes a sequence number into it and
+// queues it as valid, the DVI thread peeks and removes valid buffers, checks
+// the sequence number and hands the buffer back. Buffers are passed as
+// indexes, since host pointers do not fit into the 32bit queue elements.
+// The valid queue is shorter than the number of buffers, so the renderer
+// also runs into a full queue (the DVI queues themselves never fill up).
+// Any lost, duplicated or reordered buffer, or any buffer owned by both
+// threads at once, aborts the test. Lost buffers stall the threads, which
+// also aborts the test (after a generous timeout).
+//
+// Usage: queue_stress [million scanlines]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "util_queue_u32_inline.h"
+
+#ifndef DVI_N_TMDS_BUFFERS
+#define DVI_N_TMDS_BUFFERS 8
+#endif
+#define STRESS_VALID_ENTRIES 3
+
+typedef struct
+{
+    volatile uint32_t sequence;
+    volatile uint32_t owner; // 1: renderer, 2: DVI
+} stress_buffer_t;
+
+static stress_buffer_t buffers[DVI_N_TMDS_BUFFERS];
+static uint32_t q_free_data[DVI_N_TMDS_BUFFERS+1];
+static uint32_t q_valid_data[STRESS_VALID_ENTRIES+1];
+static queue_t  q_free;
+static queue_t  q_valid;
+static uint32_t scanlines;
+
+static void queue_setup(queue_t* q, uint32_t* data, uint16_t element_count)
+{
+    q->data          = (uint8_t*) data;
+    q->element_size  = sizeof(uint32_t);
+    q->element_count = element_count;
+    q->rptr          = 0;
+    q->wptr          = 0;
+}
+
+static void take_ownership(uint32_t index, uint32_t owner)
+{
+    if (index >= DVI_N_TMDS_BUFFERS)
+    {
+        fprintf(stderr, "invalid buffer index %u\n", index);
+        abort();
+    }
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&buffers[index].owner, &expected, owner, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        fprintf(stderr, "buffer %u already owned by %u\n", index, expected);
+        abort();
+    }
+}
+
+static void release_ownership(uint32_t index)
+{
+    __atomic_store_n(&buffers[index].owner, 0, __ATOMIC_RELEASE);
+}
+
+// the renderer: free -> valid
+static void* renderer_thread(void* arg)
+{
+    (void) arg;
+    for (uint32_t seq=1;seq<=scanlines;seq++)
+    {
+        uint32_t index;
+        queue_spsc_remove_blocking_u32(&q_free, &index);
+        take_ownership(index, 1);
+        buffers[index].sequence = seq;
+        release_ownership(index);
+        queue_spsc_add_blocking_u32(&q_valid, &index);
+    }
+    return NULL;
+}
+
+// the DVI interrupt: valid -> free, never blocks on the valid queue
+static void* dvi_thread(void* arg)
+{
+    uint32_t expected = 1;
+    uint64_t* idle = (uint64_t*) arg;
+    while (expected <= scanlines)
+    {
+        uint32_t index, peeked;
+        if (!queue_spsc_try_peek_u32(&q_valid, &peeked))
+        {
+            (*idle)++;
+            __wfe();
+            continue;
+        }
+        if (!queue_spsc_try_remove_u32(&q_valid, &index))
+        {
+            fprintf(stderr, "peeked buffer disappeared\n");
+            abort();
+        }
+        if (index != peeked)
+        {
+            fprintf(stderr, "removed buffer %u instead of peeked buffer %u\n", index, peeked);
+            abort();
+        }
+        take_ownership(index, 2);
+        if (buffers[index].sequence != expected)
+        {
+            fprintf(stderr, "scanline %u instead of %u (buffer %u)\n", buffers[index].sequence, expected, index);
+            abort();
+        }
+        expected++;
+        release_ownership(index);
+        if (!queue_spsc_try_add_u32(&q_free, &index))
+        {
+            fprintf(stderr, "free queue full\n");
+            abort();
+        }
+    }
+    return NULL;
+}
+
+static void stalled(int sig)
+{
+    (void) sig;
+    fprintf(stderr, "renderer and DVI stalled (lost buffers?)\n");
+    abort();
+}
+
+int main(int argc, char** argv)
+{
+    scanlines = ((argc > 1) ? atoi(argv[1]) : 10) * 1000000;
+
+    signal(SIGALRM, stalled);
+    alarm(10 + scanlines/100000);
+
+    queue_setup(&q_free,  q_free_data,  DVI_N_TMDS_BUFFERS);
+    queue_setup(&q_valid, q_valid_data, STRESS_VALID_ENTRIES);
+    for (uint32_t i=0;i<DVI_N_TMDS_BUFFERS;i++)
+    {
+        if (!queue_spsc_try_add_u32(&q_free, &i))
+        {
+            fprintf(stderr, "free queue cannot hold all buffers\n");
+            return 1;
+        }
+    }
+
+    uint64_t  idle = 0;
+    pthread_t renderer, dvi;
+    pthread_create(&dvi,      NULL, dvi_thread,      &idle);
+    pthread_create(&renderer, NULL, renderer_thread, NULL);
+    pthread_join(renderer, NULL);
+    pthread_join(dvi,      NULL);
+
+    // all buffers must be back in the free queue, each exactly once
+    uint32_t seen = 0, index;
+    while (queue_spsc_try_remove_u32(&q_free, &index))
+    {
+        take_ownership(index, 1);
+        seen++;
+    }
+    if ((seen != DVI_N_TMDS_BUFFERS)||(queue_spsc_try_remove_u32(&q_valid, &index)))
+    {
+        fprintf(stderr, "%u of %u buffers returned\n", seen, DVI_N_TMDS_BUFFERS);
+        return 1;
+    }
+
+    printf("%u scanlines, %u buffers: OK (DVI idle polls: %llu)\n", scanlines, DVI_N_TMDS_BUFFERS, (unsigned long long) idle);
+    return 0;
+}
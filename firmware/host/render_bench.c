@@ -0,0 +1,533 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+// Host benchmark of the scanline renderers.
+// Renders complete frames for every video mode, using the HGR/DHGR test
+// patterns, and reports the time per scanline and the worst-case frame time.
+// The TMDS output checksum is also reported, so optimizations can be
+// verified to produce the identical TMDS stream. The checksum of the RGB332
+// pixels sent with HSTX output (see host_hstx.h) must be identical for
+// render_bench and render_bench_hstx.
+// A scanline missed by the DVI (dvi0.scanline_skip) must make the renderer
+// skip a line, in every mode. A bus write to the displayed page must show in
+// the next frame, while the unmodified lines are resent from the line cache.
+// The frame time with the TMDS line cache is reported separately: all other
+// figures are measured with the line cache invalidated for every frame.
+// Timing uses the plain C kernels: the SIO interpolator kernels run on a
+// software model of the interpolators here, so they are only verified to
+// produce the identical TMDS stream (use the render profiler on the device
+// to compare their speed).
+// render_bench_latch renders from the frame latch (FEATURE_FRAME_LATCH), which
+// must not change any checksum, and also reports the time spent for copying
+// the display pages.
+// render_bench_timeline tracks the beam position (FEATURE_BEAM_TIMELINE), which
+// must not change any checksum, and also verifies a frame switching from text
+// to hires graphics mid-frame.
+//
+// Usage: render_bench [frames] [640|720] [free heap in KB]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "render/render.h"
+#include "videx/videx_vterm.h"
+#include "dvi/a2dvi.h"
+#include "dvi/tmds_cache.h"
+#include "dvi/tmds_index.h"
+#include "host_dvi.h"
+#include "host_hstx.h"
+
+#include "test/testpattern_hgr.h"
+#include "test/testpattern_dhgr.h"
+
+typedef struct
+{
+    const char* name;
+    uint32_t    soft_switches;
+    uint32_t    internal_flags;
+    uint32_t    internal_flags_clear;
+} bench_mode_t;
+
+static const bench_mode_t bench_modes[] =
+{
+    {"TEXT40",      SOFTSW_TEXT_MODE,                                                   0},
+    {"TEXT80",      SOFTSW_TEXT_MODE|SOFTSW_80COL,                                      0},
+    {"LORES",       0,                                                                  0},
+    {"LORES MONO",  0,                                                                  IFLAGS_FORCED_MONO},
+    {"LORES MIX",   SOFTSW_MIX_MODE,                                                    0},
+    {"DGR",         SOFTSW_80COL|SOFTSW_DGR,                                            0},
+    {"DGR MIX",     SOFTSW_MIX_MODE|SOFTSW_80COL|SOFTSW_DGR,                            0},
+    {"HGR",         SOFTSW_HIRES_MODE,                                                  0},
+    {"HGR MONO",    SOFTSW_HIRES_MODE,                                                  IFLAGS_FORCED_MONO},
+    {"HGR MIX",     SOFTSW_HIRES_MODE|SOFTSW_MIX_MODE,                                  0},
+    {"DHGR",        SOFTSW_HIRES_MODE|SOFTSW_80COL|SOFTSW_DGR,                          0},
+    {"DHGR MONO",   SOFTSW_HIRES_MODE|SOFTSW_80COL|SOFTSW_DGR,                          IFLAGS_FORCED_MONO},
+    {"DHGR MIX",    SOFTSW_HIRES_MODE|SOFTSW_MIX_MODE|SOFTSW_80COL|SOFTSW_DGR,          0},
+    {"DHGR NO FX",  SOFTSW_HIRES_MODE|SOFTSW_80COL|SOFTSW_DGR,                          0, IFLAGS_INTERP_DHGR},
+    {"VIDEX",       SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL,                                0}
+};
+
+#define BENCH_MODE_COUNT (sizeof(bench_modes)/sizeof(bench_modes[0]))
+
+static uint64_t last_ns;
+static uint64_t line_ns_max;
+static uint64_t frame_ns;
+static uint32_t frame_lines;
+static uint32_t checksum;
+static uint32_t rgb_checksum;
+static bool     checksum_enabled;
+
+static inline uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec)*1000000000u + ts.tv_nsec;
+}
+
+// called for every scanline sent: the time spent in here is not accounted
+static void bench_scanline(uint32_t* tmdsbuf)
+{
+    uint64_t line_ns = time_ns() - last_ns;
+    frame_ns += line_ns;
+    if (line_ns > line_ns_max)
+        line_ns_max = line_ns;
+    frame_lines++;
+
+    // FNV-1a over the complete scanline (all 3 TMDS channels, or the RGB332 pixels with HSTX)
+    for (uint32_t i=0;(checksum_enabled)&&(i<DVI_SCANLINE_WORDS);i++)
+    {
+        checksum = (checksum ^ tmdsbuf[i]) * 16777619u;
+    }
+
+    // FNV-1a over the RGB332 pixels of the HSTX output
+    if (checksum_enabled)
+    {
+        uint8_t rgb332[720];
+        host_hstx_scanline(rgb332, tmdsbuf);
+        for (uint32_t i=0;i<DVI_X_RESOLUTION;i++)
+        {
+            rgb_checksum = (rgb_checksum ^ rgb332[i]) * 16777619u;
+        }
+    }
+
+    last_ns = time_ns();
+}
+
+static void load_test_patterns(void)
+{
+    // text and lores pages: all character codes/colors
+    for (uint i=0;i<0x800;i++)
+    {
+        text_p1[i] = (uint8_t) (i*7);
+        text_p3[i] = (uint8_t) (i*13);
+    }
+
+    // HGR test pattern on the main memory pages (same as setHiresTestPattern)
+    for (uint i=0;i<sizeof(TESTPATTERN_HGR_BIN)/4;i++)
+    {
+        uint32_t data;
+        memcpy(&data, &TESTPATTERN_HGR_BIN[i*4], 4);
+        ((uint32_t*)hgr_p1)[i] = data;
+        ((uint32_t*)hgr_p2)[i] = data ^ 0xffffffff;
+    }
+
+    // DHGR test pattern: the first half is the aux memory page (same as setDoubleHiresTestPattern)
+    for (uint i=0;i<sizeof(TESTPATTERN_DHGR_BIN)/4;i++)
+    {
+        uint32_t data;
+        memcpy(&data, &TESTPATTERN_DHGR_BIN[i*4], 4);
+        if (i>0x2000/4)
+        {
+            ((uint32_t*)hgr_p1)[i&0x7ff] = data;
+            ((uint32_t*)hgr_p2)[i&0x7ff] = data ^ 0xffffffff;
+        }
+        else
+        {
+            ((uint32_t*)hgr_p3)[i&0x7ff] = data;
+            ((uint32_t*)hgr_p4)[i&0x7ff] = data ^ 0xffffffff;
+        }
+    }
+
+    // videx: printable characters
+    for (uint i=0;i<sizeof(videx_vram);i++)
+    {
+        videx_vram[i] = 0x20 + (i % 0x5f);
+    }
+}
+
+// bus cycles as captured by the PIO: data, ~SELECT (inactive), R/W, address
+#define BUS_READ(address)  (((uint32_t) (address) << 10) | (1u << 9) | (1u << 8))
+#define BUS_WRITE(address) (((uint32_t) (address) << 10) | (1u << 8))
+
+// bus cycle handler (abus.c is built with FEATURE_TEST for the host)
+extern void abus_interface(uint32_t value);
+
+#ifdef FEATURE_BEAM_TIMELINE
+#define TIMELINE_MAX_LINES 1024
+
+static uint32_t timeline_sums[TIMELINE_MAX_LINES];
+static uint32_t timeline_lines;
+
+// FNV-1a of every scanline of a frame
+static void timeline_scanline(uint32_t* tmdsbuf)
+{
+    uint32_t sum = 2166136261u;
+    for (uint32_t i=0;i<DVI_SCANLINE_WORDS;i++)
+    {
+        sum = (sum ^ tmdsbuf[i]) * 16777619u;
+    }
+    if (timeline_lines < TIMELINE_MAX_LINES)
+        timeline_sums[timeline_lines++] = sum;
+}
+
+static void timeline_render(uint32_t* sums)
+{
+    timeline_lines = 0;
+    render_frame();
+    memcpy(sums, timeline_sums, sizeof(timeline_sums));
+}
+
+static void timeline_bus_cycle(uint32_t cycle, uint32_t value)
+{
+    bus_cycle_counter = cycle;
+    abus_interface(value);
+}
+
+// Apple II frames of a program switching the display before the start of the frame
+// (first soft switch) and at the given scanline (second soft switch), then waiting for the VBL
+static uint32_t timeline_frames(uint32_t cycle, uint32_t frames, uint32_t first, uint32_t second, uint32_t split_line)
+{
+    const uint32_t vbl_start = BEAM_VISIBLE_LINES*BEAM_CYCLES_PER_LINE;
+
+    for (uint32_t f=0;f<frames;f++)
+    {
+        timeline_bus_cycle(cycle - 10, BUS_READ(first));
+        timeline_bus_cycle(cycle + split_line*BEAM_CYCLES_PER_LINE + 10, BUS_READ(second));
+        // LDA $C019, BMI: the last read sees the VBL
+        for (uint32_t c=vbl_start-14*7;c<=vbl_start;c+=7)
+        {
+            timeline_bus_cycle(cycle + c, BUS_READ(0xC019));
+        }
+        cycle += BEAM_LINES_NTSC*BEAM_CYCLES_PER_LINE;
+    }
+    return cycle;
+}
+
+// render a frame of a program switching from display mode a to mode b during the
+// given scanline: the lines of mode b must follow the lines of mode a, starting
+// at the expected scanline
+static int timeline_split(const char* name, uint32_t* cycle, uint32_t softsw_a, uint32_t softsw_b,
+                          uint32_t switch_a, uint32_t switch_b, uint32_t split_line, uint32_t expected)
+{
+    static uint32_t a[TIMELINE_MAX_LINES], b[TIMELINE_MAX_LINES], split[TIMELINE_MAX_LINES], cached[TIMELINE_MAX_LINES];
+    uint32_t splits = render_timeline_splits;
+
+    // reference frames (rendered as a whole: the beam position is unknown yet)
+    beam_anchored = false;
+    soft_switches = softsw_a;
+    tmds_cache_invalidate();
+    timeline_render(a);
+    soft_switches = softsw_b;
+    timeline_render(b);
+
+    // the frame after the first VBL anchors the beam position
+    *cycle = timeline_frames(*cycle, 3, switch_a, switch_b, split_line);
+    bus_cycle_counter = *cycle - (BEAM_LINES_NTSC-BEAM_VISIBLE_LINES-10)*BEAM_CYCLES_PER_LINE;
+    tmds_cache_invalidate();
+    timeline_render(split);
+    // again, from the line cache
+    timeline_render(cached);
+
+    // the lines of mode a must be followed by the lines of mode b
+    uint32_t split_at = 0;
+    uint32_t a_lines  = 0;
+    uint32_t b_lines  = 0;
+    uint32_t first    = 0;
+    for (uint32_t i=0;i<timeline_lines;i++)
+    {
+        if (split[i] != cached[i])
+        {
+            printf("beam timeline %s: line %u: cached line differs\n", name, i);
+            return 1;
+        }
+        if (a[i] == b[i])
+            continue;
+        if (a_lines+b_lines == 0)
+            first = i;
+        if ((split[i] == a[i])&&(b_lines == 0))
+            a_lines++;
+        else
+        if (split[i] == b[i])
+        {
+            if (b_lines++ == 0)
+                split_at = i;
+        }
+        else
+        {
+            printf("beam timeline %s: line %u: neither mode\n", name, i);
+            return 1;
+        }
+    }
+
+    if ((a_lines == 0)||(b_lines == 0)||(render_timeline_splits != splits+2)||(split_at - first != expected))
+    {
+        printf("beam timeline %s: split at line %u instead of %u (%u/%u lines, %u split frames)\n",
+               name, split_at - first, expected, a_lines, b_lines, render_timeline_splits - splits);
+        return 1;
+    }
+
+    printf("A2DVI beam timeline: %s split at line %u (%u + %u lines)\n", name, split_at, a_lines, b_lines);
+    return 0;
+}
+
+static int timeline_check(void)
+{
+    uint32_t cycle = 1000;
+
+    host_scanline_hook = timeline_scanline;
+    internal_flags    |= IFLAGS_IIE_REGS;
+    internal_flags    &= ~IFLAGS_PAL;
+
+    printf("\n");
+    // text above hires graphics: the text row ends at scanline 96
+    if (timeline_split("TEXT/HGR", &cycle, SOFTSW_TEXT_MODE|SOFTSW_HIRES_MODE, SOFTSW_HIRES_MODE, 0xC051, 0xC050, 96, 96))
+        return 1;
+    // hires page flip: at the exact scanline (the switch during scanline 99 affects scanline 100)
+    return timeline_split("HGR PAGE 1/2", &cycle, SOFTSW_HIRES_MODE, SOFTSW_HIRES_MODE|SOFTSW_PAGE_2, 0xC054, 0xC055, 99, 100);
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    uint32_t frames     = (argc > 1) ? atoi(argv[1]) : 500;
+    uint32_t video_mode = ((argc > 2) && (atoi(argv[2]) == 720)) ? Dvi720x480 : Dvi640x480;
+
+    if (frames == 0)
+        frames = 1;
+
+    // free heap determines the size of the line cache (RP2040 default, ~400KB on the RP2350)
+    if (argc > 3)
+        host_free_heap = atoi(argv[3])*1024;
+
+#ifdef FEATURE_FRAME_LATCH
+    // the snapshot is allocated before the line cache sizes itself
+    host_free_heap -= FRAME_LATCH_SIZE;
+#endif
+
+    a2dvi_dvi_enable(video_mode);
+    tmds_color_load();
+    render_init();
+    load_test_patterns();
+
+    host_scanline_hook = bench_scanline;
+
+    // time the plain C kernels (the interpolator kernels are verified below)
+    render_use_interp = false;
+
+    printf("A2DVI render benchmark: %ux480, %u frames per mode\n", DVI_X_RESOLUTION, frames);
+    printf("A2DVI line cache: %u lines, %u bytes\n", tmds_cache_lines, tmds_cache_bytes);
+    printf("%-12s %6s %12s %12s %12s %12s %12s %5s  %8s  %s\n",
+           "MODE", "LINES", "NS/LINE", "MAX NS/LINE", "AVG US/FRM", "MAX US/FRM", "CACHED US/FRM", "HITS", "CHECKSUM", "RGB332");
+
+    for (uint m=0;m<BENCH_MODE_COUNT;m++)
+    {
+        const bench_mode_t* pMode = &bench_modes[m];
+        uint64_t total_ns     = 0;
+        uint64_t frame_ns_max = 0;
+        uint32_t total_lines  = 0;
+        uint64_t cached_ns    = 0;
+        uint32_t uncached_checksum;
+        uint32_t uncached_rgb_checksum;
+        uint32_t cached_checksum;
+
+        soft_switches  = pMode->soft_switches;
+        internal_flags = (internal_flags & ~(IFLAGS_FORCED_MONO|IFLAGS_INTERP_DHGR)) | pMode->internal_flags | IFLAGS_INTERP_DHGR;
+        internal_flags &= ~pMode->internal_flags_clear;
+        checksum       = 2166136261u;
+        rgb_checksum   = 2166136261u;
+        line_ns_max    = 0;
+
+        // first frame is a warm-up (and provides the TMDS checksum)
+        for (uint32_t f=0;f<=frames;f++)
+        {
+            frame_ns    = 0;
+            frame_lines = 0;
+            checksum_enabled = (f == 0);
+            tmds_cache_invalidate();
+            last_ns     = time_ns();
+            render_frame();
+            if (f == 0)
+            {
+                line_ns_max = 0;
+                continue;
+            }
+            total_ns    += frame_ns;
+            total_lines += frame_lines;
+            if (frame_ns > frame_ns_max)
+                frame_ns_max = frame_ns;
+        }
+
+        // a frame resent from the line cache must be identical to a rendered frame
+        uncached_checksum = checksum;
+        uncached_rgb_checksum = rgb_checksum;
+        checksum_enabled  = true;
+        tmds_cache_invalidate();
+        render_frame();
+        checksum = 2166136261u;
+        render_frame();
+        cached_checksum = checksum;
+        checksum = 2166136261u;
+        tmds_cache_invalidate();
+        render_frame();
+        if (checksum != cached_checksum)
+        {
+            printf("%s: cached frame differs from rendered frame (%08x/%08x)\n", pMode->name, cached_checksum, checksum);
+            return 1;
+        }
+
+        // a bus write to the displayed page must show in the next frame, while the
+        // unmodified lines are resent from the line cache (Videx has its own memory)
+        if ((pMode->soft_switches & SOFTSW_VIDEX_80COL) == 0)
+        {
+            uint32_t address = (pMode->soft_switches & SOFTSW_HIRES_MODE) ? 0x2000 : 0x0400;
+            uint8_t  data    = apple_memory[SHADOW_OFFSET(address)];
+            abus_interface(BUS_WRITE(address) | (data ^ 0xff));
+            checksum = 2166136261u;
+            render_frame();
+            uint32_t written_checksum = checksum;
+            checksum = 2166136261u;
+            tmds_cache_invalidate();
+            render_frame();
+            abus_interface(BUS_WRITE(address) | data);
+            if ((written_checksum != checksum)||(written_checksum == cached_checksum))
+            {
+                printf("%s: bus write not shown from the line cache (%08x/%08x)\n", pMode->name, written_checksum, checksum);
+                return 1;
+            }
+        }
+
+        // a scanline missed by the DVI: the renderer skips a line of the next frame
+        frame_lines = 0;
+        render_frame();
+        uint32_t frame_lines_normal = frame_lines;
+        frame_lines = 0;
+        dvi0.scanline_skip++;
+        render_frame();
+        if (frame_lines != frame_lines_normal-1)
+        {
+            printf("%s: missed scanline was not skipped (%u/%u lines)\n", pMode->name, frame_lines, frame_lines_normal);
+            return 1;
+        }
+
+        // the interpolator kernels must produce the same TMDS stream (compared to the
+        // frames rendered before and after, since the cursor/flashing text may toggle)
+        uint32_t c_checksum[2];
+        uint32_t interp_checksum;
+        for (uint32_t f=0;f<3;f++)
+        {
+            render_use_interp = (f == 1);
+            checksum = 2166136261u;
+            tmds_cache_invalidate();
+            render_frame();
+            if (f == 1)
+                interp_checksum = checksum;
+            else
+                c_checksum[f/2] = checksum;
+        }
+        render_use_interp = false;
+        if ((interp_checksum != c_checksum[0])&&(interp_checksum != c_checksum[1]))
+        {
+            printf("%s: interpolator kernels differ from C kernels (%08x/%08x)\n", pMode->name, interp_checksum, c_checksum[0]);
+            return 1;
+        }
+        checksum = uncached_checksum;
+
+        // frames with unmodified screen memory: resent from the line cache
+        checksum_enabled = false;
+        tmds_cache_hit_ratio();
+        for (uint32_t f=0;f<=frames;f++)
+        {
+            frame_ns    = 0;
+            last_ns     = time_ns();
+            render_frame();
+            if (f > 0)
+                cached_ns += frame_ns;
+        }
+
+        uint32_t hit_ratio = tmds_cache_hit_ratio();
+
+        printf("%-12s %6u %12.1f %12llu %12.2f %12.2f %13.2f %4u%%  %08x  %08x\n",
+               pMode->name, total_lines/frames,
+               (double) total_ns/total_lines, (unsigned long long) line_ns_max,
+               (double) total_ns/frames/1000.0, (double) frame_ns_max/1000.0,
+               (double) cached_ns/frames/1000.0, hit_ratio, checksum, uncached_rgb_checksum);
+#ifdef FEATURE_INDEXED_LINES
+        // the index lines are only allocated while a mode renders them
+        if (tmds_index_lines)
+            printf("A2DVI index lines: %u lines, %u bytes, line cache: %u lines\n", tmds_index_lines, tmds_index_bytes, tmds_cache_lines);
+#endif
+    }
+
+#ifdef FEATURE_FRAME_LATCH
+    // snapshot of the complete display pages (the displayed page was flipped),
+    // and without any modified blocks (static screen)
+    printf("\nA2DVI frame latch: %u bytes\n", render_latch_bytes);
+    printf("%-12s %12s %12s %12s\n", "MODE", "FULL BYTES", "FULL US", "IDLE US");
+    for (uint m=0;m<BENCH_MODE_COUNT;m++)
+    {
+        const bench_mode_t* pMode = &bench_modes[m];
+        const uint32_t iterations = 1000;
+        uint64_t full_ns    = 0;
+        uint64_t idle_ns    = 0;
+        uint32_t full_bytes = 0;
+
+        soft_switches = pMode->soft_switches;
+        for (uint32_t i=0;i<iterations;i++)
+        {
+            render_latch_invalidate();
+            uint64_t start = time_ns();
+            render_latch_frame(soft_switches);
+            full_ns   += time_ns() - start;
+            full_bytes = render_latch_copied;
+
+            start = time_ns();
+            render_latch_frame(soft_switches);
+            idle_ns += time_ns() - start;
+        }
+
+        printf("%-12s %12u %12.2f %12.2f\n", pMode->name, full_bytes,
+               (double) full_ns/iterations/1000.0, (double) idle_ns/iterations/1000.0);
+    }
+#endif
+
+#ifdef FEATURE_BEAM_TIMELINE
+    if (timeline_check())
+        return 1;
+#endif
+
+    return 0;
+}
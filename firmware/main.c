@@ -47,6 +47,9 @@ SOFTWARE.
 
 int main()
 {
+    // copy the bus handlers and their data to core 1's RAM bank
+    memcpy32(__ram_core1_copy_start__, __ram_core1_copy_source__, ((uint32_t)__ram_core1_copy_end__) - (uint32_t) __ram_core1_copy_start__);
+
     // slightly rise the core voltage, preparation for overclocking
     vreg_set_voltage(VREG_VSEL);
 
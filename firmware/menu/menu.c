@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include <pico.h>
+#include "hardware/clocks.h"
 
 #include "applebus/abus.h"
 #include "applebus/buffers.h"
@@ -30,6 +31,9 @@ SOFTWARE.
 #include "fonts/textfont.h"
 #include "debug/debug.h"
 #include "dvi/a2dvi.h"
+#include "dvi/tmds_cache.h"
+#include "render/render.h"
+#include "render/render_kernels.h"
 #include "menu.h"
 
 // number of elements in the menu
@@ -56,6 +60,7 @@ static uint8_t MenuPageItems      = 0;
 static bool    MenuNeedsRedraw;
 static uint8_t MenuSubTitleToggle;
 static uint8_t MenuOptionNr;
+static uint8_t MenuDebugPage;
 
 #define TEXT_OFFSET(line) ((((line) & 0x7) << 7) + ((((line) >> 3) & 0x3) * 40))
 
@@ -252,6 +257,8 @@ char DELAYED_COPY_DATA(MenuColorStyle)[] =
 char DELAYED_COPY_DATA(MenuVideoMode)[] =
     "640X480/60HZ\0"
     "720X480/60HZ\0"
+    "720X576/50HZ\0"
+    "800X480/60HZ\0"
     "\0";
 
 char DELAYED_COPY_DATA(MenuFontNames)[] =
@@ -505,8 +512,8 @@ void DELAYED_COPY_CODE(menuShowTest)()
             }
 
             uint line = y >> 1;
-            uint16_t address = 0x400+((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40)+x;
-            apple_memory[address] = (apple_memory[address] & mask) | color;
+            uint16_t address = ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40)+x;
+            text_p1[address] = (text_p1[address] & mask) | color;
         }
     }
 
@@ -536,11 +543,121 @@ void int2str(uint32_t value, char* pStrBuf, uint32_t digits)
     pStrBuf[digits]=0;
 }
 
+// cycles of the three scanline kernels, as "MONO/HIRES/DHGR" (14 characters)
+static void DELAYED_COPY_CODE(menuKernelCycles)(char* s, uint variant)
+{
+    for (uint k=0;k<RENDER_KERNEL_COUNT;k++)
+    {
+        int2str(render_kernel_cycles[k][variant], &s[k*5], 4);
+        s[k*5+4] = 0x80|'/';
+    }
+    s[RENDER_KERNEL_COUNT*5-1] = 0;
+}
+
+void DELAYED_COPY_CODE(menuShowBusStatistics)()
+{
+    const uint8_t X1 = 1;
+    const uint8_t X2 = X1+24;
+    char s[40];
+
+    // CPU cycle budget of a 1.023MHz bus cycle
+    printXY(X1, 3, "CPU CYCLES/BUS CYCLE:", PRINTMODE_NORMAL);
+    int2str(clock_get_hz(clk_sys)/1023000, s, 8);
+    printXY(X2, 3, s, PRINTMODE_NORMAL);
+
+    printXY(X1, 4, "WORST CASE CYCLES:", PRINTMODE_NORMAL);
+    int2str(bus_handler_worst_cycles, s, 8);
+    printXY(X2, 4, s, PRINTMODE_NORMAL);
+    bus_handler_name((uint8_t*) s, bus_handler_worst);
+    s[6] = 0;
+    printXY(X2+9, 4, s, PRINTMODE_NORMAL);
+
+    printXY(X1, 5, "FIFO HIGH-WATER MARK:", PRINTMODE_NORMAL);
+    int2str(bus_fifo_high_water, s, 8);
+    printXY(X2, 5, s, PRINTMODE_NORMAL);
+
+    // bus cycle rate which can be sustained, at the average CPU cycles per bus cycle
+    printXY(X1, 6, "MAX BUS RATE (KHZ):", PRINTMODE_NORMAL);
+    if (bus_busy_cycles)
+    {
+        int2str((uint32_t) (((uint64_t) clock_get_hz(clk_sys)) * bus_busy_count / bus_busy_cycles / 1000), s, 8);
+        printXY(X2, 6, s, PRINTMODE_NORMAL);
+    }
+
+    // measured cycles per scanline of the render kernels: MONO/HIRES/DHGR
+    uint y = 7;
+    printXY(X1, y, "KERNEL C (CYC/LINE):", PRINTMODE_NORMAL);
+    menuKernelCycles(s, 0);
+    printXY(X2, y++, s, PRINTMODE_NORMAL);
+#ifdef FEATURE_ASM_KERNELS
+    printXY(X1, y, "KERNEL ASM (CYC/LINE):", PRINTMODE_NORMAL);
+    menuKernelCycles(s, 1);
+    printXY(X2, y++, s, PRINTMODE_NORMAL);
+#endif
+
+    // histogram header: upper limit of each bucket (CPU cycles)
+    y++;
+    printXY(X1, y, "ADDR", PRINTMODE_NORMAL);
+    for (uint b=0;b<BUS_HISTOGRAM_BUCKETS-1;b++)
+    {
+        int2str((b+1) << BUS_HISTOGRAM_SHIFT, &s[1], 3);
+        s[0] = ' ';
+        uint i = 1;
+        while ((s[i] & 0x7f) == ' ')
+            i++;
+        s[i-1] = '<';
+        printXY(X1+6+b*4, y, s, PRINTMODE_NORMAL);
+    }
+    int2str((BUS_HISTOGRAM_BUCKETS-1) << BUS_HISTOGRAM_SHIFT, s, 3);
+    s[3] = '+';
+    s[4] = 0;
+    printXY(X1+6+(BUS_HISTOGRAM_BUCKETS-1)*4, y++, s, PRINTMODE_NORMAL);
+
+    // histogram rows (in percent) for all active handlers
+    for (uint h=0;(h<BUS_HANDLER_COUNT)&&(y<21);h++)
+    {
+        uint64_t total = 0;
+        for (uint b=0;b<BUS_HISTOGRAM_BUCKETS;b++)
+            total += bus_handler_histogram[h][b];
+        if (total == 0)
+            continue;
+
+        bus_handler_name((uint8_t*) s, h);
+        s[6] = 0;
+        printXY(X1, y, s, PRINTMODE_NORMAL);
+        for (uint b=0;b<BUS_HISTOGRAM_BUCKETS;b++)
+        {
+            uint32_t count   = bus_handler_histogram[h][b];
+            uint32_t percent = (uint32_t) ((count*100ull)/total);
+            if (count == 0)
+                printXY(X1+6+b*4, y, "   -", PRINTMODE_NORMAL);
+            else
+            if (percent == 0)
+                printXY(X1+6+b*4, y, "  <1", PRINTMODE_NORMAL);
+            else
+            {
+                int2str(percent, s, 4);
+                printXY(X1+6+b*4, y, s, PRINTMODE_NORMAL);
+            }
+        }
+        y++;
+    }
+}
+
 void DELAYED_COPY_CODE(menuShowDebug)()
 {
     menuShowFrame();
     menuVideo7Text();
 
+    // the debug page alternates with the bus handler statistics page
+    MenuDebugPage ^= 1;
+    printXY(36, 2, (MenuDebugPage) ? "1/2" : "2/2", PRINTMODE_NORMAL);
+    if (!MenuDebugPage)
+    {
+        menuShowBusStatistics();
+        return;
+    }
+
     // show detected machine and slot
     {
         const uint8_t X1 = 3;
@@ -571,7 +688,7 @@ void DELAYED_COPY_CODE(menuShowDebug)()
         printXY(X2, 8, s, PRINTMODE_NORMAL);
 
         printXY(X1, 9, "SCAN LINE ERRORS:", PRINTMODE_NORMAL);
-        int2str(a2dvi_scanline_errors(), s, 14);
+        int2str(a2dvi_scanline_errors(NULL), s, 14);
         printXY(X2, 9, s, PRINTMODE_NORMAL);
 
         printXY(X1,10, "RESET COUNTER:", PRINTMODE_NORMAL);
@@ -586,6 +703,14 @@ void DELAYED_COPY_CODE(menuShowDebug)()
         int2str(devicemem_counter, s, 14);
         printXY(X2,12, s, PRINTMODE_NORMAL);
 
+        printXY(X1,13, "CACHED LINES:", PRINTMODE_NORMAL);
+        int2str(tmds_cache_lines, s, 14);
+        printXY(X2,13, s, PRINTMODE_NORMAL);
+
+        printXY(X1,14, "CACHE HITS (%):", PRINTMODE_NORMAL);
+        int2str(tmds_cache_hit_ratio(), s, 14);
+        printXY(X2,14, s, PRINTMODE_NORMAL);
+
         printXY(X1,15, "AVAILABLE MEMORY:", PRINTMODE_NORMAL);
         int2str(getFreeHeap(), s, 14);
         printXY(X2,15, s, PRINTMODE_NORMAL);
@@ -594,14 +719,42 @@ void DELAYED_COPY_CODE(menuShowDebug)()
         int2str(boot_time, s, 14);
         printXY(X2, 16, s, PRINTMODE_NORMAL);
 
+        printXY(X1,17, "CACHE MEMORY:", PRINTMODE_NORMAL);
+        int2str(tmds_cache_bytes, s, 14);
+        printXY(X2,17, s, PRINTMODE_NORMAL);
+
+        printXY(X1,18, "SHADOW RAM SAVED:", PRINTMODE_NORMAL);
+        int2str(SHADOW_SAVED_BYTES, s, 14);
+        printXY(X2,18, s, PRINTMODE_NORMAL);
+
+        printXY(X1,19, "RECOVERED LINES:", PRINTMODE_NORMAL);
+        uint32_t recovered;
+        a2dvi_scanline_errors(&recovered);
+        int2str(recovered, s, 14);
+        printXY(X2,19, s, PRINTMODE_NORMAL);
+
+#ifdef FEATURE_FRAME_LATCH
+        // worst case time for copying the display pages (FRAME_LATCH_SIZE bytes of heap)
+        printXY(X1,20, "FRAME LATCH (US):", PRINTMODE_NORMAL);
+        int2str(render_latch_cycles_max / (clock_get_hz(clk_sys)/1000000), s, 14);
+        printXY(X2,20, s, PRINTMODE_NORMAL);
+#endif
+
+#ifdef FEATURE_BEAM_TIMELINE
+        // frames rendered with mid-frame display mode changes
+        printXY(X1,21, "SPLIT FRAMES:", PRINTMODE_NORMAL);
+        int2str(render_timeline_splits, s, 14);
+        printXY(X2,21, s, PRINTMODE_NORMAL);
+#endif
+
 #if 0
-        printXY(X1,17, "IFLAGS:", PRINTMODE_NORMAL);
+        printXY(X1,22, "IFLAGS:", PRINTMODE_NORMAL);
         int2str(internal_flags, s, 8);
-        printXY(X2, 17, s, PRINTMODE_NORMAL);
+        printXY(X2, 22, s, PRINTMODE_NORMAL);
 
-        printXY(X1,18, "SWFLAGS:", PRINTMODE_NORMAL);
+        printXY(X1,23, "SWFLAGS:", PRINTMODE_NORMAL);
         int2str(soft_switches, s, 8);
-        printXY(X2, 18, s, PRINTMODE_NORMAL);
+        printXY(X2, 23, s, PRINTMODE_NORMAL);
 #endif
     }
 }
@@ -781,10 +934,22 @@ bool DELAYED_COPY_CODE(menuDoSelectionPage1)(bool increase)
 {
     switch(MenuSelection)
     {
-        case 0: //640x480 vs 720x480
-            cfg_video_mode ^= 1;
-            cfg_video_mode |= 0x10;
+        case 0: // VIDEO MODE
+        {
+            uint32_t mode = cfg_video_mode & ~DviModeChange;
+            if (increase)
+            {
+                if (mode+1 < DviModeCount)
+                    mode++;
+            }
+            else
+            {
+                if (mode > 0)
+                    mode--;
+            }
+            cfg_video_mode = mode | DviModeChange;
             break;
+        }
         case 1: // PAL vs NTSC
             SET_IFLAG(!IS_IFLAG(IFLAGS_PAL), IFLAGS_PAL);
             break;
@@ -1017,10 +1182,9 @@ static inline bool menuCheckKeys(char key)
             soft_switches |= SOFTSW_TEXT_MODE;
             // abort the menu: do not redraw
             return true;
-        case 22: // CTRL-V, shortcut to directly toggle 640x480 vs 720x480
+        case 22: // CTRL-V, shortcut to directly cycle through the video modes
         {
-            cfg_video_mode ^= 1;
-            cfg_video_mode |= 0x10;
+            cfg_video_mode = (((cfg_video_mode & ~DviModeChange)+1) % DviModeCount) | DviModeChange;
             break;
         }
         case '!': // special debug feature
@@ -1115,7 +1279,7 @@ void DELAYED_COPY_CODE(menuShow)(char key)
     }
     else
     {
-        menuOption(Y++, getMenuString(MenuVideoMode, cfg_video_mode & 1));
+        menuOption(Y++, getMenuString(MenuVideoMode, cfg_video_mode & ~DviModeChange));
         menuOption(Y++, getMenuString(MenuPalNtsc, IS_IFLAG(IFLAGS_PAL)));
         menuOption(Y++, getMenuString(MenuOnOff, IS_IFLAG(IFLAGS_DEBUG_LINES)));
         menuOption(Y++, 0);
@@ -29,13 +29,27 @@ SOFTWARE.
 #include "config/config.h"
 #include "videx/videx_vterm.h"
 #include "dvi/a2dvi.h"
+#include "dvi/genlock.h"
+#include "debug/profiler.h"
 
 #include "render.h"
+#include "render_kernels.h"
 #include "menu/menu.h"
 
+// soft switches which do not affect the display
+#define SOFTSW_NON_DISPLAY (SOFTSW_INTCXROM|SOFTSW_AUX_READ|SOFTSW_AUX_WRITE|SOFTSW_AUXZP|SOFTSW_SLOT3ROM|SOFTSW_IOUDIS)
+
 uint32_t led_bus_cycle_counter;
 bool mono_rendering = false;
+#ifdef FEATURE_ASM_KERNELS
+bool render_use_interp = false; // the assembly kernels replace the interpolator paths
+#else
+bool render_use_interp = true;
+#endif
 bool color_support;
+#if defined(FEATURE_FRAME_LATCH) || defined(FEATURE_BEAM_TIMELINE)
+uint32_t frame_softsw;
+#endif
 
 void DELAYED_COPY_CODE(render_init)()
 {
@@ -45,6 +59,12 @@ void DELAYED_COPY_CODE(render_init)()
         ((uint32_t*)status_line)[i] = 0xA0A0A0A0;
     }
     config_load_charsets();
+
+    // cycles per scanline of the C (and assembly) kernels, for the debug page
+    render_kernel_measure();
+
+    // cycle counter for the render profiler
+    CYCLE_COUNTER_INIT();
 }
 
 // show current display mode as subtitle below the screen area
@@ -258,97 +278,174 @@ static void update_led()
     }
 }
 
-void DELAYED_COPY_CODE(render_loop)()
+// determine the key of the current render mode for the TMDS line cache
+static uint32_t DELAYED_COPY_CODE(line_cache_mode)(uint32_t current_softsw)
 {
-    // show splash/diagnostic screen
-    render_splash();
+    // the page is not part of the mode: the screen memory hash covers the page
+    uint32_t mode = current_softsw & ~(SOFTSW_NON_DISPLAY|SOFTSW_PAGE_2);
+    mode = (mode * 0x9e3779b1u) ^ internal_flags;
+    mode = (mode * 0x9e3779b1u) ^ (color_mode << 8) ^ (language_switch << 16);
+    return mode;
+}
 
-    for(;;)
+// render the Apple II screen area (all rows, or the rows of a segment)
+static void DELAYED_COPY_CODE(render_mode)(uint32_t current_softsw)
+{
+    switch(current_softsw & SOFTSW_MODE_MASK)
+    {
+        case 0:
+            if(current_softsw & SOFTSW_DGR)
+            {
+                render_dgr();
+            }
+            else
+            {
+                render_lores();
+            }
+            break;
+        case SOFTSW_MIX_MODE: //2
+            if((current_softsw & (SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80COL | SOFTSW_DGR))
+            {
+                render_mixed_dgr();
+            }
+            else
+            {
+                render_mixed_lores();
+            }
+            break;
+        case SOFTSW_HIRES_MODE: //4
+            if(current_softsw & SOFTSW_DGR)
+            {
+                render_dhgr();
+            }
+            else
+            {
+                render_hires();
+            }
+            break;
+        case SOFTSW_HIRES_MODE|SOFTSW_MIX_MODE: //6
+            if((current_softsw & (SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80COL | SOFTSW_DGR))
+            {
+                render_mixed_dhgr();
+            }
+            else
+            {
+                render_mixed_hires();
+            }
+            break;
+        default:
+            render_text();
+            if (reload_charsets)
+            {
+                config_load_charsets();
+                tmds_cache_invalidate();
+            }
+            else
+            if (reload_colors)
+            {
+                tmds_color_load();
+                tmds_cache_invalidate();
+            }
+            break;
+    }
+}
+
+#ifdef FEATURE_BEAM_TIMELINE
+// render the screen area in segments, with the display mode of each segment
+static void DELAYED_COPY_CODE(render_segments_frame)(uint32_t segments)
+{
+    for (uint32_t i=0;i<segments;i++)
     {
-        // copy soft switches - since we need consistent settings throughout a rendering cycle
-        uint32_t current_softsw = soft_switches;
-        bool IsVidex = ((current_softsw & (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL)) == (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL));
+        render_line_start = render_segments[i].line;
+        render_line_end   = (i+1 < segments) ? render_segments[i+1].line : 192;
+        frame_softsw     = render_segments[i].softsw;
+        tmds_cache_set_mode(line_cache_mode(frame_softsw));
+        render_mode(frame_softsw);
+    }
+    render_line_start = 0;
+    render_line_end   = 192;
+}
+#endif
+
+// render a complete frame, including the debug/border areas above and below the screen
+void DELAYED_COPY_CODE(render_frame)()
+{
+    // copy soft switches - since we need consistent settings throughout a rendering cycle
+    uint32_t current_softsw = soft_switches;
+
+    // snapshot of the display pages (FEATURE_FRAME_LATCH), before core 1 modifies them mid-frame
+    render_latch_frame(current_softsw);
+
+#ifdef FEATURE_BEAM_TIMELINE
+    // display mode changes during the last Apple II frame (split screens)
+    frame_softsw = current_softsw;
+    uint32_t segments = render_timeline_frame(current_softsw);
+#endif
+
+    render_profile_frame(current_softsw & ~(SOFTSW_NON_DISPLAY|SOFTSW_PAGE_2));
+    // index lines take their memory from the line cache, while the renderers use them
+    tmds_index_start_frame();
+    tmds_cache_start_frame(line_cache_mode(current_softsw));
+
+    bool IsVidex = ((current_softsw & (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL)) == (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL));
 #ifndef FEATURE_TEST_TMDS
-        render_debug(IsVidex, true);
+    render_debug(IsVidex, true);
 
-        // set flag when monochrome rendering is requested
-        mono_rendering = (current_softsw & SOFTSW_MONOCHROME)||(internal_flags & IFLAGS_FORCED_MONO);
+    // set flag when monochrome rendering is requested
+    mono_rendering = (current_softsw & SOFTSW_MONOCHROME)||(internal_flags & IFLAGS_FORCED_MONO);
 
-        // prepare state indicating whether the current display mode supports colors
-        color_support = (current_softsw & SOFTSW_MONOCHROME) ? false : true;
+    // prepare state indicating whether the current display mode supports colors
+    color_support = (current_softsw & SOFTSW_MONOCHROME) ? false : true;
 #else
-        // no scanlines/no videx when running the TMDS test
-        cfg_scanline_mode = ScanlinesOff;
-        IsVidex = false;
-        render_debug(IsVidex, true);
-        if (1)
-        {
-            render_tmds_test();
-        }
-        else
+    // no scanlines/no videx when running the TMDS test
+    cfg_scanline_mode = ScanlinesOff;
+    IsVidex = false;
+    render_debug(IsVidex, true);
+    if (1)
+    {
+        render_tmds_test();
+    }
+    else
 #endif
-        if (IsVidex)
-            render_videx_text();
-        else
-        {
-            switch(current_softsw & SOFTSW_MODE_MASK)
-            {
-                case 0:
-                    if(current_softsw & SOFTSW_DGR)
-                    {
-                        render_dgr();
-                    }
-                    else
-                    {
-                        render_lores();
-                    }
-                    break;
-                case SOFTSW_MIX_MODE: //2
-                    if((current_softsw & (SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80COL | SOFTSW_DGR))
-                    {
-                        render_mixed_dgr();
-                    }
-                    else
-                    {
-                        render_mixed_lores();
-                    }
-                    break;
-                case SOFTSW_HIRES_MODE: //4
-                    if(current_softsw & SOFTSW_DGR)
-                    {
-                        render_dhgr();
-                    }
-                    else
-                    {
-                        render_hires();
-                    }
-                    break;
-                case SOFTSW_HIRES_MODE|SOFTSW_MIX_MODE: //6
-                    if((current_softsw & (SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80COL | SOFTSW_DGR))
-                    {
-                        render_mixed_dhgr();
-                    }
-                    else
-                    {
-                        render_mixed_hires();
-                    }
-                    break;
-                default:
-                    render_text();
-                    if (reload_charsets)
-                    {
-                        config_load_charsets();
-                    }
-                    else
-                    if (reload_colors)
-                    {
-                        tmds_color_load();
-                    }
-                    break;
-            }
-        }
+#ifdef FEATURE_BEAM_TIMELINE
+    if (segments)
+        render_segments_frame(segments);
+    else
+#endif
+    if (IsVidex)
+        render_videx_text();
+    else
+        render_mode(current_softsw);
+
+    render_debug(IsVidex, false);
+
+    // last monochrome scanline of the frame
+    tmds_mono_flush();
+
+#ifdef FEATURE_BEAM_TIMELINE
+    // the segments of a split frame were rendered with their own switches
+    if (segments)
+        return;
+#endif
+
+    // soft switches changed while rendering: some cached lines may show the previous mode
+    if ((soft_switches ^ current_softsw) & ~(SOFTSW_NON_DISPLAY|SOFTSW_PAGE_2))
+    {
+        tmds_cache_invalidate();
+    }
+}
+
+void DELAYED_COPY_CODE(render_loop)()
+{
+    // show splash/diagnostic screen
+    render_splash();
+
+    for(;;)
+    {
+        render_frame();
 
-        render_debug(IsVidex, false);
+        // pace the next DVI frame
+        genlock_frame();
 
         update_text_flasher();
 
@@ -366,10 +463,10 @@ void DELAYED_COPY_CODE(render_loop)()
             update_led();
         }
 
-        if (cfg_video_mode > 1)
+        if (cfg_video_mode & DviModeChange)
         {
-            cfg_video_mode &= 1;
-            a2dvi_dvi_enable(cfg_video_mode & 1);
+            cfg_video_mode &= ~DviModeChange;
+            a2dvi_dvi_enable(cfg_video_mode);
         }
     }
 }
@@ -27,21 +27,43 @@ SOFTWARE.
 #pragma once
 
 #include "dvi/tmds.h"
+#include "hardware/interp.h"
+#include "render_kernels.h"
+#include "render_latch.h"
+#include "render_timeline.h"
 
 extern uint32_t show_subtitle_cycles;
 extern uint32_t led_bus_cycle_counter;
 extern bool mono_rendering;
+extern bool render_use_interp; // use the SIO interpolator kernels (instead of the table kernels, see render_kernels.h)
 
 extern bool color_support;  // flag indicating whether current display mode supports color
 
+// Line renderer of a graphics mode. Each renderer is instantiated once per variant
+// (colour/monochrome, palette, Video-7 mode, kernel), with the variant parameters
+// being compile-time constants of an inlined generic line function. The frame
+// renderers select the variant once per frame from a table, so the per-line and
+// per-pixel branches on these settings are resolved by the compiler.
+typedef void (*render_line_t)(bool p2, uint line);
+
+#define RENDER_LINE_VARIANT(name, generic, ...) \
+    static void DELAYED_COPY_CODE(name)(bool p2, uint line) \
+    { \
+        generic(p2, line, __VA_ARGS__); \
+    }
+
+// number of monochrome palettes (see color_mode_t)
+#define RENDER_MONO_PALETTES 3
+
 extern void render_init();
 extern void render_splash();
 extern void render_loop();
+extern void render_frame();
 
 extern void update_text_flasher();
 extern void render_text();
 extern void render_mixed_text();
-extern void render_text40_line(const uint8_t *page, unsigned int line, uint8_t color_mode);
+extern void render_text40_line(const uint8_t *page, unsigned int line, uint8_t color_mode, bool cached);
 extern void render_color_text40_line(unsigned int line);
 
 extern void render_lores();
@@ -59,11 +81,31 @@ extern void render_mixed_dgr();
 extern void render_videx_text();
 
 extern void render_debug(bool IsVidexMode, bool top);
+extern void render_profile_frame(uint32_t mode);
 extern void copy_str(uint8_t* dest, const char* pMsg);
 extern void int2hex(uint8_t* pStrBuf, uint32_t value, uint32_t digits);
+extern void int2dec(uint8_t* pStrBuf, uint32_t value, uint32_t digits);
+extern void bus_handler_name(uint8_t* dest, uint32_t handler);
+
+// Configure an interpolator lane of core 0 to compute table addresses:
+// base + (input >> shift), masked to bits mask_lsb..mask_msb. Lane 1 may
+// use the accumulator of lane 0 as input, so a single accumulator write
+// provides two table addresses.
+static inline void render_interp_lane(interp_hw_t* interp, uint lane, uint shift, uint mask_lsb, uint mask_msb, bool cross_input, const void* base)
+{
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, shift);
+    interp_config_set_mask(&cfg, mask_lsb, mask_msb);
+    interp_config_set_cross_input(&cfg, cross_input);
+    interp_set_config(interp, lane, &cfg);
+    interp_set_base(interp, lane, (uintptr_t) base);
+}
 
 //#define FEATURE_TEST_TMDS
 
 #ifdef FEATURE_TEST_TMDS
+#ifdef FEATURE_HSTX
+#error "FEATURE_TEST_TMDS sends raw TMDS symbols, which FEATURE_HSTX does not use."
+#endif
 extern void render_tmds_test();
 #endif
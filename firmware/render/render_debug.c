@@ -28,9 +28,23 @@ SOFTWARE.
 #include "render.h"
 #include "menu/menu.h"
 #include "dvi/a2dvi.h"
+#include "dvi/tmds_cache.h"
+#include "dvi/genlock.h"
+#include "debug/profiler.h"
 
 uint32_t show_subtitle_cycles;
 
+// render profiler: CPU load of core 0 per frame (percent of the frame period not spent
+// waiting for the DVI) and the slowest scanline (percent of a scanline period),
+// collected since the display mode was last changed
+static uint32_t DELAYED_COPY_DATA(profile_mode) = 0xffffffff;
+static uint32_t DELAYED_COPY_DATA(profile_frame_start);
+static uint32_t DELAYED_COPY_DATA(profile_frames);
+static uint32_t DELAYED_COPY_DATA(profile_load_sum);
+static uint32_t DELAYED_COPY_DATA(profile_load_min);
+static uint32_t DELAYED_COPY_DATA(profile_load_max);
+static uint32_t DELAYED_COPY_DATA(profile_line_max);
+
 void DELAYED_COPY_CODE(int2hex)(uint8_t* pStrBuf, uint32_t value, uint32_t digits)
 {
     for (int32_t i=0;i<digits;i++)
@@ -40,6 +54,15 @@ void DELAYED_COPY_CODE(int2hex)(uint8_t* pStrBuf, uint32_t value, uint32_t digit
     }
 }
 
+void DELAYED_COPY_CODE(int2dec)(uint8_t* pStrBuf, uint32_t value, uint32_t digits)
+{
+    for (int32_t i=digits-1;i>=0;i--)
+    {
+        pStrBuf[i] = (0x80|'0')+(value % 10);
+        value /= 10;
+    }
+}
+
 void DELAYED_COPY_CODE(copy_str)(uint8_t* dest, const char* pMsg)
 {
     while (*pMsg)
@@ -48,6 +71,53 @@ void DELAYED_COPY_CODE(copy_str)(uint8_t* dest, const char* pMsg)
     }
 }
 
+// name of a bus handler (6 characters): "CXXX R", "2XXX W" or "CARD  "
+void DELAYED_COPY_CODE(bus_handler_name)(uint8_t* dest, uint32_t handler)
+{
+    if (handler == BUS_HANDLER_CARD_SELECT)
+    {
+        copy_str(dest, "CARD  ");
+    }
+    else
+    {
+        int2hex(dest, handler & 0xf, 1);
+        copy_str(&dest[1], (handler & 0x10) ? "XXX W" : "XXX R");
+    }
+}
+
+void DELAYED_COPY_CODE(render_profile_frame)(uint32_t mode)
+{
+    uint32_t now    = CYCLE_COUNTER_READ();
+    uint32_t period = CYCLE_COUNTER_ELAPSED(profile_frame_start, now);
+    uint32_t wait_cycles, line_cycles;
+    profile_frame_start = now;
+    tmds_cache_profile(&wait_cycles, &line_cycles);
+
+    // the completed frame was rendered in the previous mode
+    if ((period > wait_cycles)&&(profile_mode != 0xffffffff))
+    {
+        uint32_t load = ((uint64_t) (period - wait_cycles) * 100) / period;
+        uint32_t line = ((uint64_t) line_cycles * 100 * a2dvi_lines_per_frame()) / period;
+        if ((profile_frames == 0)||(load < profile_load_min))
+            profile_load_min = load;
+        if (load > profile_load_max)
+            profile_load_max = load;
+        if (line > profile_line_max)
+            profile_line_max = line;
+        profile_load_sum += load;
+        profile_frames++;
+    }
+
+    if (mode != profile_mode)
+    {
+        profile_mode     = mode;
+        profile_frames   = 0;
+        profile_load_sum = 0;
+        profile_load_max = 0;
+        profile_line_max = 0;
+    }
+}
+
 void DELAYED_COPY_CODE(update_debug_monitor)(void)
 {
     if ((frame_counter & 3) == 0) // do not update too fast, so data remains readable
@@ -133,8 +203,8 @@ void DELAYED_COPY_CODE(update_debug_monitor)(void)
         (show_subtitle_cycles == 0))
     {
         /*0123456789012345678901234567890123456789
-         *PC:1234 S:123 ZP:12              OV:1234
-         *   80STR AUXR AUXW AUXZ C3ROM CXROM IOUD
+         *BUS MAX:1234 CXXX R  FIFO:123 LINE:123%
+         *PC:1234 S:123 ZP:12 CPU:12/34/56 OV:1234
          */
         uint8_t* line1 = &status_line[80];
         uint8_t* line2 = &status_line[120];
@@ -145,6 +215,28 @@ void DELAYED_COPY_CODE(update_debug_monitor)(void)
             ((uint32_t*)line1)[i] = 0xA0A0A0A0;
         }
 
+        // worst-case CPU cycles of the bus handler, maximum FIFO level
+        copy_str(&line1[0], "BUS MAX:");
+        int2hex(&line1[8], bus_handler_worst_cycles, 4);
+        bus_handler_name(&line1[13], bus_handler_worst);
+        copy_str(&line1[21], "FIFO:");
+        int2hex(&line1[26], bus_fifo_high_water, 3);
+
+        // render profiler: slowest scanline, CPU load min/avg/max (percent) in the current mode
+        if (profile_frames)
+        {
+            copy_str(&line1[30], "LINE:");
+            int2dec(&line1[35], (profile_line_max < 999) ? profile_line_max : 999, 3);
+            copy_str(&line1[38], "%");
+
+            copy_str(&line2[20], "CPU:");
+            int2dec(&line2[24], (profile_load_min < 99) ? profile_load_min : 99, 2);
+            copy_str(&line2[26], "/");
+            int2dec(&line2[27], (profile_load_sum/profile_frames < 99) ? profile_load_sum/profile_frames : 99, 2);
+            copy_str(&line2[29], "/");
+            int2dec(&line2[30], (profile_load_max < 99) ? profile_load_max : 99, 2);
+        }
+
         // program counter
         copy_str(&line2[0], "PC:");
         int2hex(&line2[3], last_address_pc, 4);
@@ -165,6 +257,23 @@ void DELAYED_COPY_CODE(update_debug_monitor)(void)
             bus_overflow_counter = 0xffff;
 #endif
         }
+#ifdef FEATURE_GENLOCK
+        else
+        {
+            // bus write to display latency (ms), lower case while not locked
+            copy_str(&line2[33], (genlock_locked) ? "LT:" : "lt:");
+            if (genlock_latency == GENLOCK_LATENCY_UNKNOWN)
+            {
+                copy_str(&line2[36], "--.-");
+            }
+            else
+            {
+                int2dec(&line2[36], (genlock_latency/10 < 99) ? genlock_latency/10 : 99, 2);
+                copy_str(&line2[38], ".");
+                int2dec(&line2[39], genlock_latency%10, 1);
+            }
+        }
+#endif
 
 #ifdef FEATURE_DEBUG_COUNTER
 #warning DEBUG FEATURE IS ENABLED! ************************************
@@ -188,13 +297,13 @@ void DELAYED_COPY_CODE(render_debug)(bool IsVidexMode, bool top)
             }
             for (uint row=0;row<row_count;row++)
             {
+                if (tmds_cache_skip_line())
+                    continue;
                 dvi_get_scanline(tmdsbuf);
                 dvi_scanline_rgb640(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
                 for (uint32_t x=0;x<320;x++)
                 {
-                    *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
-                    *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
-                    *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+                    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, TMDS_SYMBOL_0_0, TMDS_SYMBOL_0_0, TMDS_SYMBOL_0_0);
                 }
                 dvi_send_scanline(tmdsbuf);
             }
@@ -214,8 +323,8 @@ void DELAYED_COPY_CODE(render_debug)(bool IsVidexMode, bool top)
         uint8_t* line2 = &status_line[40];
         if (!IsVidexMode)
         {
-            render_text40_line(line1, 0, 4);
-            render_text40_line(line2, 0, 4);
+            render_text40_line(line1, 0, 4, false);
+            render_text40_line(line2, 0, 4, false);
         }
     }
     else
@@ -224,8 +333,8 @@ void DELAYED_COPY_CODE(render_debug)(bool IsVidexMode, bool top)
         uint8_t* line1 = &status_line[80];
         uint8_t* line2 = &status_line[120];
         if (!IsVidexMode)
-            render_text40_line(line1, 0, 4);
-        render_text40_line(line2, 0, 4);
+            render_text40_line(line1, 0, 4, false);
+        render_text40_line(line2, 0, 4, false);
 
         if (show_subtitle_cycles)
             show_subtitle_cycles--;
@@ -28,7 +28,7 @@ SOFTWARE.
 #include "config/config.h"
 #include "render.h"
 
-#define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
+#define PAGE2SEL ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
 uint8_t DELAYED_COPY_DATA(dgr_dot_pattern)[32] = {
     0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
@@ -52,33 +52,35 @@ static uint8_t DELAYED_COPY_DATA(dlores_dhgr_map)[16] = {
     uint32_t b = tmds_dhgr_blue [dhgr_index];\
     for (uint x=0;x<count;x++)\
     {\
-        *(tmds_red++)   = r;\
-        *(tmds_green++) = g;\
-        *(tmds_blue++)  = b;\
+        dvi_add_pixel_pair(tmds_red, tmds_green, tmds_blue, r, g, b);\
     }\
 }
 
-static void render_dgr_line(bool p2, uint line);
 
-static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
+static __force_inline void render_dgr_line(bool p2, uint line, const bool mono, const bool fx, const uint palette)
 {
+    const uint8_t *line_bufa = (const uint8_t *)((p2 ? frame_text_p2 : frame_text_p1) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
+    const uint8_t *line_bufb = (const uint8_t *)((p2 ? frame_text_p4 : frame_text_p3) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
+
+    // resend the cached lines when the memory was not modified
+    uint32_t hash = tmds_cache_line_hash(tmds_cache_line_hash(0, line_bufa), line_bufb);
+    if (tmds_cache_resend_lines(line*8, 8, hash))
+        return;
+
     // Construct two scanlines for the two different colored cells at the same time
-    dvi_get_scanline(tmdsbuf1);
+    dvi_get_cached_scanline(tmdsbuf1, line*8+3, hash);
     dvi_scanline_rgb560(tmdsbuf1, tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue);
 
-    dvi_get_scanline(tmdsbuf2);
+    dvi_get_cached_scanline(tmdsbuf2, line*8+7, hash);
     dvi_scanline_rgb560(tmdsbuf2, tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue);
 
-    const uint8_t *line_bufa = (const uint8_t *)((p2 ? text_p2 : text_p1) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
-    const uint8_t *line_bufb = (const uint8_t *)((p2 ? text_p4 : text_p3) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
-
     uint i = 0;
     uint_fast8_t dotc = 0;
 
-    if(mono_rendering)
+    if(mono)
     {
         uint32_t pattern1=0, pattern2=0;
-        uint8_t color_offset = color_mode*12;
+        const uint color_offset = palette*12;
 
         while(i < 40)
         {
@@ -97,14 +99,12 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
             while(dotc >= 2)
             {
                 uint32_t offset = color_offset + (pattern1 & 3);
-                *(tmdsbuf1_red++)   = tmds_mono_pixel_pair[offset+0];
-                *(tmdsbuf1_green++) = tmds_mono_pixel_pair[offset+4];
-                *(tmdsbuf1_blue++)  = tmds_mono_pixel_pair[offset+8];
+                dvi_add_pixel_pair(tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue,
+                                   tmds_mono_pixel_pair[offset+0], tmds_mono_pixel_pair[offset+4], tmds_mono_pixel_pair[offset+8]);
 
                 offset = color_offset + (pattern2 & 3);
-                *(tmdsbuf2_red++)   = tmds_mono_pixel_pair[offset+0];
-                *(tmdsbuf2_green++) = tmds_mono_pixel_pair[offset+4];
-                *(tmdsbuf2_blue++)  = tmds_mono_pixel_pair[offset+8];
+                dvi_add_pixel_pair(tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue,
+                                   tmds_mono_pixel_pair[offset+0], tmds_mono_pixel_pair[offset+4], tmds_mono_pixel_pair[offset+8]);
                 pattern1 >>= 2;
                 pattern2 >>= 2;
                 dotc -= 2;
@@ -112,7 +112,7 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
         }
     }
     else
-    if(internal_flags & IFLAGS_INTERP_DGR)
+    if(fx)
     {
         // based David's DGR renderer - with artifacts
         uint32_t color1 = 0, color2 = 0;
@@ -143,9 +143,8 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
                 dhgr_index |= (color1 & 0xf)<<4;   // index for second pixel
 
                 // add 2 pixels
-                *(tmdsbuf1_red++)   = tmds_dhgr_red  [dhgr_index];
-                *(tmdsbuf1_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf1_blue++)  = tmds_dhgr_blue [dhgr_index];
+                dvi_add_pixel_pair(tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue,
+                                   tmds_dhgr_red[dhgr_index], tmds_dhgr_green[dhgr_index], tmds_dhgr_blue[dhgr_index]);
 
                 color2 &= 0xfffffffe;
                 color2 |= (color2 >> 4) & 1;
@@ -155,9 +154,8 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
                 dhgr_index |= (color2 & 0xf)<<4;   // index for second pixel
 
                 // add 2 pixels
-                *(tmdsbuf2_red++)   = tmds_dhgr_red  [dhgr_index];
-                *(tmdsbuf2_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf2_blue++)  = tmds_dhgr_blue [dhgr_index];
+                dvi_add_pixel_pair(tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue,
+                                   tmds_dhgr_red[dhgr_index], tmds_dhgr_green[dhgr_index], tmds_dhgr_blue[dhgr_index]);
 
                 color1 &= 0xfffffff8;
                 color1 |= (color1 >> 4) & 7;
@@ -166,9 +164,8 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
                 dhgr_index |= (color1 & 0xf)<<4;   // index for second pixel
 
                 // add 2 pixels
-                *(tmdsbuf1_red++)   = tmds_dhgr_red  [dhgr_index];
-                *(tmdsbuf1_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf1_blue++)  = tmds_dhgr_blue [dhgr_index];
+                dvi_add_pixel_pair(tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue,
+                                   tmds_dhgr_red[dhgr_index], tmds_dhgr_green[dhgr_index], tmds_dhgr_blue[dhgr_index]);
 
                 color2 &= 0xfffffff8;
                 color2 |= (color2 >> 4) & 7;
@@ -176,9 +173,8 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
                 color2 >>= 4;
 
                 // add 2 pixels
-                *(tmdsbuf2_red++)   = tmds_dhgr_red  [dhgr_index];
-                *(tmdsbuf2_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf2_blue++)  = tmds_dhgr_blue [dhgr_index];
+                dvi_add_pixel_pair(tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue,
+                                   tmds_dhgr_red[dhgr_index], tmds_dhgr_green[dhgr_index], tmds_dhgr_blue[dhgr_index]);
 
                 dotc -= 4;
             }
@@ -236,7 +232,9 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
     // repeat this line 3 more times (4x in total)
     for (uint yrepeat=0;yrepeat<3;yrepeat++)
     {
-        dvi_get_scanline(tmdsbufRepeat);
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbufRepeat, line*8+yrepeat, hash);
         dvi_copy_scanline(tmdsbufRepeat, tmdsbuf1);
         // send copied buffer
         dvi_send_scanline(tmdsbufRepeat);
@@ -247,7 +245,9 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
     // repeat this line 3 more times (4x in total)
     for (uint yrepeat=0;yrepeat<3;yrepeat++)
     {
-        dvi_get_scanline(tmdsbufRepeat);
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbufRepeat, line*8+4+yrepeat, hash);
         dvi_copy_scanline(tmdsbufRepeat, tmdsbuf2);
         // send copied buffer
         dvi_send_scanline(tmdsbufRepeat);
@@ -256,19 +256,46 @@ static void DELAYED_COPY_CODE(render_dgr_line)(bool p2, uint line)
     dvi_send_scanline(tmdsbuf2);
 }
 
+RENDER_LINE_VARIANT(render_dgr_line_color,      render_dgr_line, false, false, COLOR_MODE_BW)
+RENDER_LINE_VARIANT(render_dgr_line_color_fx,   render_dgr_line, false, true,  COLOR_MODE_BW)
+RENDER_LINE_VARIANT(render_dgr_line_mono_bw,    render_dgr_line, true,  false, COLOR_MODE_BW)
+RENDER_LINE_VARIANT(render_dgr_line_mono_green, render_dgr_line, true,  false, COLOR_MODE_GREEN)
+RENDER_LINE_VARIANT(render_dgr_line_mono_amber, render_dgr_line, true,  false, COLOR_MODE_AMBER)
+
+// line renderers: color (without/with artifacts), then the monochrome palettes
+static render_line_t DELAYED_COPY_DATA(render_dgr_lines)[2+RENDER_MONO_PALETTES] =
+{
+    render_dgr_line_color,
+    render_dgr_line_color_fx,
+    render_dgr_line_mono_bw,
+    render_dgr_line_mono_green,
+    render_dgr_line_mono_amber
+};
+
+static inline render_line_t render_dgr_select(void)
+{
+    if (mono_rendering)
+        return render_dgr_lines[2+color_mode];
+    return render_dgr_lines[(internal_flags & IFLAGS_INTERP_DGR) ? 1 : 0];
+}
+
 void DELAYED_COPY_CODE(render_dgr)()
 {
-    for(uint line=0; line < 24; line++)
+    render_line_t render_line = render_dgr_select();
+
+    for(uint line=RENDER_ROW_START; line < RENDER_ROW_END; line++)
     {
-        render_dgr_line(PAGE2SEL, line);
+        render_line(PAGE2SEL, line);
     }
 }
 
 void DELAYED_COPY_CODE(render_mixed_dgr)()
 {
-    for(uint line=0; line < 20; line++)
+    render_line_t render_line = render_dgr_select();
+
+    for(uint line=RENDER_ROW_START; line < RENDER_MIXED_ROW_END; line++)
     {
-        render_dgr_line(PAGE2SEL, line);
+        render_line(PAGE2SEL, line);
     }
 
     render_mixed_text();
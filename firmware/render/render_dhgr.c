@@ -37,7 +37,7 @@ uint8_t DELAYED_COPY_DATA(tmds_dhgr_lores_mapping)[16] =
     9*3 /*9:HVIOLET*/, 11*3 /*11:LBLUE*/, 13*3 /*13:PINK*/,    15*3 /*15:WHITE*/
 };
 
-#define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
+#define PAGE2SEL ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
 // add pixels to TMDS line
 #define ADD_TMDS_LORES_PIXELS(tmds_red, tmds_green, tmds_blue, color_index, count) \
@@ -45,70 +45,154 @@ uint8_t DELAYED_COPY_DATA(tmds_dhgr_lores_mapping)[16] =
     uint32_t* pTmds = &tmds_lorescolor[color_index*3];\
     for (uint i=0;i<count;i++)\
     {\
-        *(tmds_red++)   = *pTmds;\
-        *(tmds_green++) = *(pTmds+1);\
-        *(tmds_blue++)  = *(pTmds+2);\
+        dvi_add_pixel_pair(tmds_red, tmds_green, tmds_blue, pTmds[0], pTmds[1], pTmds[2]);\
     }\
 }
 
 // add two double pixels
 #define ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b) \
-    *(tmdsbuf_red++)   = r; \
-    *(tmdsbuf_red++)   = r; \
-    *(tmdsbuf_green++) = g; \
-    *(tmdsbuf_green++) = g; \
-    *(tmdsbuf_blue++)  = b; \
-    *(tmdsbuf_blue++)  = b;
+    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b); \
+    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
+
+// DHGR colors with artifacts: a sliding window over the dots yields the DHGR
+// palette index of each pixel, two pixels (a pair, first pixel in the low
+// nibble) at a time, which are passed to add_pair
+#define DHGR_FX_PIXEL_PAIRS(add_pair) \
+{\
+    /* Preload black into the sliding window */\
+    dots = 0;\
+    dotc = 4;\
+    while(i < 40)\
+    {\
+        /* Load in as many subpixels as possible */\
+        while((dotc <= 18) && (i < 40))\
+        {\
+            dots |= (line_memb[i] & 0x7f) << dotc;\
+            dotc += 7;\
+            dots |= (line_mema[i] & 0x7f) << dotc;\
+            dotc += 7;\
+            i++;\
+        }\
+\
+        while((dotc >= 8) || ((dotc > 4) && (i == 40)))\
+        {\
+            dots &= 0xfffffffe;\
+            dots |= (dots >> 4) & 1;\
+            uint8_t dhgr_index = dots & 0xf; /* index for first pixel */\
+            dots &= 0xfffffffc;\
+            dots |= (dots >> 4) & 3;\
+            dhgr_index |= (dots & 0xf)<<4;   /* index for second pixel */\
+            add_pair(dhgr_index);\
+\
+            dots &= 0xfffffff8;\
+            dots |= (dots >> 4) & 7;\
+            dhgr_index = dots & 0xf;         /* index for third pixel */\
+            dots >>= 4;\
+            dhgr_index |= (dots & 0xf)<<4;   /* index for fourth pixel */\
+            add_pair(dhgr_index);\
+\
+            dotc -= 4;\
+        }\
+    }\
+}
+
+// add 2 pixels to the index line
+#define DHGR_FX_ADD_INDEX(dhgr_index) \
+    *(pair++) = dhgr_index;
+
+// add 2 pixels to the TMDS line
+#define DHGR_FX_ADD_TMDS(dhgr_index) \
+    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, tmds_dhgr_red[dhgr_index], tmds_dhgr_green[dhgr_index], tmds_dhgr_blue[dhgr_index]);
 
 static inline uint dhgr_line_to_mem_offset(uint line)
 {
     return ((line & 0x07) << 10) | ((line & 0x38) << 4) | (((line & 0xc0) >> 6) * 40);
 }
 
-static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
+// The lanes of interp0 compute the LORES color entries of the lower two 4 dot
+// groups, with the dots written to the accumulator shifted left by 4.
+static void DELAYED_COPY_CODE(render_dhgr_interp_setup)(void)
 {
-     // Construct scanline
-    dvi_get_scanline(tmdsbuf);
+    render_interp_lane(interp0, 0, 0, 4, 7, false, tmds_dhgr_lores_rgb);
+    render_interp_lane(interp0, 1, 4, 4, 7, true,  tmds_dhgr_lores_rgb);
+}
+
+// line renderer variants
+enum
+{
+    DHGR_COLOR,         // 16 colors (table kernel)
+    DHGR_COLOR_INTERP,  // 16 colors (interpolator)
+    DHGR_COLOR_FX,      // 16 colors with artifacts (IFLAGS_INTERP_DHGR)
+    DHGR_MONO,          // monochrome (also Video-7 560x192 mode)
+    DHGR_V7_FB,         // Video-7 F/B HiRes
+    DHGR_V7_160,        // Video-7 160x192 (640 pixels)
+    DHGR_V7_MIXED,      // Video-7 mixed B&W/RGB
+    DHGR_VARIANTS
+};
+
+static __force_inline void render_dhgr_line(bool p2, uint line, const uint variant)
+{
+    const bool mono = (variant == DHGR_MONO);
+
+    // the DVI missed a line: skip this one
+    if (tmds_cache_skip_line())
+        return;
 
-    const uint8_t *line_mema = (const uint8_t *)((p2 ? hgr_p2 : hgr_p1) + dhgr_line_to_mem_offset(line));
-    const uint8_t *line_memb = (const uint8_t *)((p2 ? hgr_p4 : hgr_p3) + dhgr_line_to_mem_offset(line));
+    const uint8_t *line_mema = (const uint8_t *)((p2 ? frame_hgr_p2 : frame_hgr_p1) + dhgr_line_to_mem_offset(line));
+    const uint8_t *line_memb = (const uint8_t *)((p2 ? frame_hgr_p4 : frame_hgr_p3) + dhgr_line_to_mem_offset(line));
+
+    // resend the cached line when the memory was not modified
+    uint32_t hash = tmds_cache_line_hash(tmds_cache_line_hash(mono, line_mema), line_memb);
+    if (tmds_cache_resend(line, hash))
+        return;
 
     // DHGR is weird. Video-7 just makes it weirder. Nuff said.
     uint32_t dots = 0;
     uint_fast8_t dotc = 0;
     uint i = 0;
 
-    if(mono)
+#ifdef FEATURE_INDEXED_LINES
+    if(variant == DHGR_COLOR_FX)
     {
-        dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
-        uint8_t color_offset = color_mode*12;
-        while(i < 40)
+        // 16 colors: each pixel pair is a byte of an index line (see tmds_index.h)
+        uint8_t* pair = tmds_index_line();
+        if (pair)
         {
-            // Load in as many subpixels as possible
-            while((dotc < 28) && (i < 40))
+            uint8_t* pairs = pair;
+            for (uint x=0;x<DVI_APPLE2_XOFS_560;x++)
             {
-                dots |= (line_memb[i] & 0x7f) << dotc;
-                dotc += 7;
-                dots |= (line_mema[i] & 0x7f) << dotc;
-                dotc += 7;
-                i++;
+                pairs[x] = 0;
+                pairs[x+DVI_APPLE2_XOFS_560+560/2] = 0;
             }
+            pair += DVI_APPLE2_XOFS_560;
+            DHGR_FX_PIXEL_PAIRS(DHGR_FX_ADD_INDEX);
+            tmds_index_send_scanline(pairs);
+            return;
+        }
+    }
+#endif
 
-            // Consume pixels
-            while(dotc)
-            {
-                uint32_t offset = color_offset + (dots & 0x3);
-                *(tmdsbuf_red++)   = tmds_mono_pixel_pair[offset+0];
-                *(tmdsbuf_green++) = tmds_mono_pixel_pair[offset+4];
-                *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[offset+8];
-                dots >>= 2;
+     // Construct scanline
+    dvi_get_cached_scanline(tmdsbuf, line, hash);
 
-                dotc -= 2;
-            }
+    if(mono)
+    {
+        // 14 dots per column, expanded to the TMDS symbols by the monochrome encoder
+        dvi_scanline_border560(tmdsbuf);
+        tmds_mono_writer_t w;
+        tmds_mono_begin(&w);
+        for(i=0; i < 40; i++)
+        {
+            dots  = (line_memb[i] & 0x7f);
+            dots |= (line_mema[i] & 0x7f) << 7;
+            tmds_mono_put(&w, dots, 14);
         }
+        tmds_mono_end(&w);
+        tmds_mono_send_scanline(tmdsbuf, DVI_APPLE2_XOFS_560, 560, color_mode);
+        return;
     }
     else
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & (SOFTSW_80STORE | SOFTSW_80COL)) == SOFTSW_80STORE))
+    if(variant == DHGR_V7_FB)
     {
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
@@ -159,7 +243,7 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
         }
     }
     else
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE2))
+    if(variant == DHGR_V7_160)
     {
         uint8_t color;
 
@@ -193,7 +277,7 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
         }
     }
     else
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE1))
+    if(variant == DHGR_V7_MIXED)
     {
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
@@ -233,16 +317,14 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
                     // add two double b&w monochrome pixels
                     uint8_t bits = dots & 3;
                     // first double pixel
-                    *(tmdsbuf_red++)   = tmds_mono_pixel_pair[bits+0];
-                    *(tmdsbuf_green++) = tmds_mono_pixel_pair[bits+4];
-                    *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[bits+8];
+                    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue,
+                                       tmds_mono_pixel_pair[bits+0], tmds_mono_pixel_pair[bits+4], tmds_mono_pixel_pair[bits+8]);
                     dots >>= 2;
 
                     bits = dots & 3;
                     // second double pixel
-                    *(tmdsbuf_red++)   = tmds_mono_pixel_pair[bits+0];
-                    *(tmdsbuf_green++) = tmds_mono_pixel_pair[bits+4];
-                    *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[bits+8];
+                    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue,
+                                       tmds_mono_pixel_pair[bits+0], tmds_mono_pixel_pair[bits+4], tmds_mono_pixel_pair[bits+8]);
                     dots >>= 2;
                 }
                 pixelmode >>= 4;
@@ -293,56 +375,15 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
     }
 #endif
     else
-    if(IS_IFLAG(IFLAGS_INTERP_DHGR))
+    if(variant == DHGR_COLOR_FX)
     {
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
-        // Preload black into the sliding window
-        dots = 0;
-        dotc = 4;
-
-        while(i < 40)
-        {
-            // Load in as many subpixels as possible
-            while((dotc <= 18) && (i < 40))
-            {
-                dots |= (line_memb[i] & 0x7f) << dotc;
-                dotc += 7;
-                dots |= (line_mema[i] & 0x7f) << dotc;
-                dotc += 7;
-                i++;
-            }
-
-            while((dotc >= 8) || ((dotc > 4) && (i == 40)))
-            {
-                dots &= 0xfffffffe;
-                dots |= (dots >> 4) & 1;
-                uint8_t dhgr_index = dots & 0xf; // index for first pixel
-                dots &= 0xfffffffc;
-                dots |= (dots >> 4) & 3;
-                dhgr_index |= (dots & 0xf)<<4;   // index for second pixel
-
-                // add 2 pixels
-                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
-                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
-
-                dots &= 0xfffffff8;
-                dots |= (dots >> 4) & 7;
-                dhgr_index = dots & 0xf;         // index for third pixel
-                dots >>= 4;
-                dhgr_index |= (dots & 0xf)<<4;   // index for fourth pixel
-
-                // add 2 pixels
-                *(tmdsbuf_red++)   = tmds_dhgr_red[dhgr_index];
-                *(tmdsbuf_green++) = tmds_dhgr_green[dhgr_index];
-                *(tmdsbuf_blue++)  = tmds_dhgr_blue[dhgr_index];
-
-                dotc -= 4;
-            }
-        }
+        DHGR_FX_PIXEL_PAIRS(DHGR_FX_ADD_TMDS);
     }
     else
+    if(variant == DHGR_COLOR_INTERP)
     {
+        // same as below, using interp0 (see render_dhgr_interp_setup)
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
         while(i < 40)
         {
@@ -359,59 +400,111 @@ static void DELAYED_COPY_CODE(render_dhgr_line)(bool p2, uint line, bool mono)
             // Consume pixels
             while(dotc >= 8)
             {
-                // map HGR dot values to 16 color (RGB LORES) palette
-                uint32_t* pTmds = &tmds_lorescolor[tmds_dhgr_lores_mapping[dots&0xf]];
+                interp_set_accumulator(interp0, 0, dots << 4);
+                dots >>= 8;
+
+                // add 4 pixels (two double pixels) for the first 4 dots
+                const uint32_t* pTmds = (const uint32_t*) interp_peek_lane_result(interp0, 0);
                 uint32_t r = pTmds[0];
                 uint32_t g = pTmds[1];
                 uint32_t b = pTmds[2];
-
-                // add 4 pixels (two double pixels)
                 ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
-                dots >>= 4;
-
-                // map HGR dot values to 16 color (LORES) palette
-                pTmds = &tmds_lorescolor[tmds_dhgr_lores_mapping[dots&0xf]];
-                dots >>= 4;
 
+                // add 4 pixels (two double pixels) for the next 4 dots
+                pTmds = (const uint32_t*) interp_peek_lane_result(interp0, 1);
                 r = pTmds[0];
                 g = pTmds[1];
                 b = pTmds[2];
-
-                // add 4 pixels (two double pixels)
                 ADD_TMDS_4PIXELS_RGB(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, r, g, b);
 
                 dotc -= 8;
             }
         }
     }
+    else
+    {
+        dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+
+        // collect the 560 dots, then map each group of 4 dots to the 16 color (RGB LORES) palette
+        tmds_mono_writer_t w;
+        tmds_mono_begin(&w);
+        for(i=0; i < 40; i++)
+        {
+            dots  = (line_memb[i] & 0x7f);
+            dots |= (line_mema[i] & 0x7f) << 7;
+            tmds_mono_put(&w, dots, 14);
+        }
+        tmds_mono_end(&w);
+        render_kernel_dhgr_rgb(tmdsbuf_blue, DVI_WORDS_PER_CHANNEL*4, tmds_mono_line(), 560/4, tmds_dhgr_lores_rgb);
+    }
 
     // send buffer
     dvi_send_scanline(tmdsbuf);
 }
 
+RENDER_LINE_VARIANT(render_dhgr_line_color,        render_dhgr_line, DHGR_COLOR)
+RENDER_LINE_VARIANT(render_dhgr_line_color_interp, render_dhgr_line, DHGR_COLOR_INTERP)
+RENDER_LINE_VARIANT(render_dhgr_line_color_fx,     render_dhgr_line, DHGR_COLOR_FX)
+RENDER_LINE_VARIANT(render_dhgr_line_mono,         render_dhgr_line, DHGR_MONO)
+RENDER_LINE_VARIANT(render_dhgr_line_v7_fb,        render_dhgr_line, DHGR_V7_FB)
+RENDER_LINE_VARIANT(render_dhgr_line_v7_160,       render_dhgr_line, DHGR_V7_160)
+RENDER_LINE_VARIANT(render_dhgr_line_v7_mixed,     render_dhgr_line, DHGR_V7_MIXED)
+
+static render_line_t DELAYED_COPY_DATA(render_dhgr_lines)[DHGR_VARIANTS] =
+{
+    [DHGR_COLOR]        = render_dhgr_line_color,
+    [DHGR_COLOR_INTERP] = render_dhgr_line_color_interp,
+    [DHGR_COLOR_FX]     = render_dhgr_line_color_fx,
+    [DHGR_MONO]         = render_dhgr_line_mono,
+    [DHGR_V7_FB]        = render_dhgr_line_v7_fb,
+    [DHGR_V7_160]       = render_dhgr_line_v7_160,
+    [DHGR_V7_MIXED]     = render_dhgr_line_v7_mixed
+};
+
+// select the line renderer for this frame
+static render_line_t DELAYED_COPY_CODE(render_dhgr_setup)(void)
+{
+    uint variant;
+
+    render_dhgr_interp_setup();
+    if(mono_rendering ||
+       (IS_IFLAG(IFLAGS_VIDEO7) && ((FRAME_SOFTSW & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE0)))
+        variant = DHGR_MONO;
+    else
+    if(IS_IFLAG(IFLAGS_VIDEO7) && ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_80COL)) == SOFTSW_80STORE))
+        variant = DHGR_V7_FB;
+    else
+    if(IS_IFLAG(IFLAGS_VIDEO7) && ((FRAME_SOFTSW & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE2))
+        variant = DHGR_V7_160;
+    else
+    if(IS_IFLAG(IFLAGS_VIDEO7) && ((FRAME_SOFTSW & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE1))
+        variant = DHGR_V7_MIXED;
+    else
+    if(IS_IFLAG(IFLAGS_INTERP_DHGR))
+        variant = DHGR_COLOR_FX;
+    else
+        variant = (render_use_interp) ? DHGR_COLOR_INTERP : DHGR_COLOR;
+
+    return render_dhgr_lines[variant];
+}
+
 void DELAYED_COPY_CODE(render_dhgr)()
 {
-    bool mono = mono_rendering;
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE0))
-    {
-        mono = true;
-    }
-    for(uint line=0; line < 192; line++)
+    render_line_t render_line = render_dhgr_setup();
+
+    for(uint line=RENDER_LINE_START; line < RENDER_LINE_END; line++)
     {
-        render_dhgr_line(PAGE2SEL, line, mono);
+        render_line(PAGE2SEL, line);
     }
 }
 
 void DELAYED_COPY_CODE(render_mixed_dhgr)()
 {
-    bool mono = mono_rendering;
-    if(IS_IFLAG(IFLAGS_VIDEO7) && ((soft_switches & SOFTSW_V7_MODE3) == SOFTSW_V7_MODE0))
-    {
-        mono = true;
-    }
-    for(uint line=0; line < 160; line++)
+    render_line_t render_line = render_dhgr_setup();
+
+    for(uint line=RENDER_LINE_START; line < RENDER_MIXED_LINE_END; line++)
     {
-        render_dhgr_line(PAGE2SEL, line, mono);
+        render_line(PAGE2SEL, line);
     }
 
     render_mixed_text();
@@ -29,44 +29,116 @@ SOFTWARE.
 #include "render.h"
 #include "hires_dot_patterns.h"
 
-#define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
+#define PAGE2SEL ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
 static inline uint hires_line_to_mem_offset(uint line)
 {
     return ((line & 0x07) << 10) | ((line & 0x38) << 4) | (((line & 0xc0) >> 6) * 40);
 }
 
-static void DELAYED_COPY_CODE(render_hires_line)(bool p2, uint line)
+// Load the next 14 dots behind the current 14 dots (current dots: bits 28-15).
+#define hires_load_dots(dots, b) \
+{ \
+    uint _b = (b); \
+    if(_b & 0x80) \
+    { \
+        /* Extend the last bit from the previous byte */ \
+        dots |= (dots & (1u << 15)) >> 1; \
+    } \
+    dots |= (uint32_t)hires_dot_patterns[_b] << 1; \
+}
+
+// Output the pixel pair for the table entry computed by an interpolator lane.
+#define HIRES_PIXEL_PAIR_INTERP(interp, lane) \
+{ \
+    const uint32_t* _sym = (const uint32_t*) interp_peek_lane_result(interp, lane); \
+    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, _sym[0], _sym[1], _sym[2]); \
+}
+
+// Interpolator lanes compute the table entries of the 8 dot windows at bits 24 (even),
+// 22 (odd), 20 (even) and 18 (odd) of the accumulator. Both lanes of an interpolator
+// use accumulator 0, so writing it to interp0 and interp1 provides 4 pixel pairs.
+static void DELAYED_COPY_CODE(render_hires_interp_setup)(void)
 {
-    const uint8_t *line_mem = (const uint8_t *)((p2 ? hgr_p2 : hgr_p1) + hires_line_to_mem_offset(line));
+    const uint32_t* rgb_even = &tmds_hires_color_patterns_rgb[0];
+    const uint32_t* rgb_odd  = &tmds_hires_color_patterns_rgb[256*TMDS_HIRES_RGB_STRIDE];
+
+    // the 8 dots are the table index, the table entries are 16 bytes
+    render_interp_lane(interp0, 0, 24-4, 4, 11, false, rgb_even);
+    render_interp_lane(interp0, 1, 22-4, 4, 11, true,  rgb_odd);
+    render_interp_lane(interp1, 0, 20-4, 4, 11, false, rgb_even);
+    render_interp_lane(interp1, 1, 18-4, 4, 11, true,  rgb_odd);
+}
+
+static __force_inline void render_hires_line(bool p2, uint line, const bool mono, const bool interp)
+{
+    // the DVI missed a line: skip this one
+    if (tmds_cache_skip_line())
+        return;
+
+    const uint8_t *line_mem = (const uint8_t *)((p2 ? frame_hgr_p2 : frame_hgr_p1) + hires_line_to_mem_offset(line));
+
+    // resend the cached line when the memory was not modified
+    uint32_t hash = tmds_cache_line_hash(0, line_mem);
+    if (tmds_cache_resend(line, hash))
+        return;
+
+    dvi_get_cached_scanline(tmdsbuf, line, hash);
+
+    if(mono)
+    {
+        // 14 dots per byte, expanded to the TMDS symbols by the monochrome encoder
+        dvi_scanline_border560(tmdsbuf);
+        tmds_mono_writer_t w;
+        tmds_mono_begin(&w);
+        for(uint i=0; i < 40; i++)
+        {
+            tmds_mono_put(&w, hires_dot_patterns2[line_mem[i]], 14);
+        }
+        tmds_mono_end(&w);
+        tmds_mono_send_scanline(tmdsbuf, DVI_APPLE2_XOFS_560, 560, color_mode);
+        return;
+    }
 
-    dvi_get_scanline(tmdsbuf);
     dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
-    if(mono_rendering)
+    if (interp)
     {
-        uint32_t lastmsb = 0;
-        uint_fast8_t dotc = 0;
-        uint32_t dots = 0;
-        uint8_t color_offset = color_mode*12;
+        // same as below, using the interpolators (see render_hires_interp_setup)
+        uint32_t dots = (uint32_t)hires_dot_patterns[line_mem[0]] << 15;
 
-        for(uint i=0; i < 40; i++)
+        for(uint i=1; i < 41; i+=2)
         {
-            // Load in as many subpixels as possible
-            dots |= (hires_dot_patterns2[lastmsb | line_mem[i]]) << dotc;
-            lastmsb = (dotc>0) ? ((line_mem[i] & 0x40)<<2) : 0;
-            dotc += 14;
-
-            // Consume pixels
-            while(dotc)
-            {
-                uint32_t coffset = color_offset + (dots&0x3);
-                *(tmdsbuf_red++)   = tmds_mono_pixel_pair[coffset + 0];
-                *(tmdsbuf_green++) = tmds_mono_pixel_pair[coffset + 4];
-                *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[coffset + 8];
-                dots >>= 2;
-                dotc -= 2;
-            }
+            // first byte of the pair: even/odd pixels at 24..18, then at 16..12
+            hires_load_dots(dots, line_mem[i]);
+            interp_set_accumulator(interp0, 0, dots);
+            interp_set_accumulator(interp1, 0, dots);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 0);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 1);
+            HIRES_PIXEL_PAIR_INTERP(interp1, 0);
+            HIRES_PIXEL_PAIR_INTERP(interp1, 1);
+            interp_set_accumulator(interp0, 0, dots << 8);
+            interp_set_accumulator(interp1, 0, dots << 8);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 0);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 1);
+            HIRES_PIXEL_PAIR_INTERP(interp1, 0);
+            dots <<= 14;
+
+            // second byte of the pair: starts with an odd pixel, so the dots
+            // are moved by one pixel to match the phases of the lanes
+            hires_load_dots(dots, (i < 39) ? line_mem[i+1] : 0);
+            interp_set_accumulator(interp0, 0, dots >> 2);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 1);
+            interp_set_accumulator(interp0, 0, dots << 2);
+            interp_set_accumulator(interp1, 0, dots << 2);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 0);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 1);
+            HIRES_PIXEL_PAIR_INTERP(interp1, 0);
+            HIRES_PIXEL_PAIR_INTERP(interp1, 1);
+            interp_set_accumulator(interp0, 0, dots << 10);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 0);
+            HIRES_PIXEL_PAIR_INTERP(interp0, 1);
+            dots <<= 14;
         }
     }
     else
@@ -89,52 +161,51 @@ static void DELAYED_COPY_CODE(render_hires_line)(bool p2, uint line)
         //                       \_________/
         //                         current
         //                          pixel
-        uint oddness = 0;
-
-        // Load in the first 14 dots
-        uint32_t dots = (uint32_t)hires_dot_patterns[line_mem[0]] << 15;
-
-        for(uint i=1; i < 41; i++)
-        {
-            // Load in the next 14 dots
-            uint b = (i < 40) ? line_mem[i] : 0;
-            if(b & 0x80) {
-                // Extend the last bit from the previous byte
-                dots |= (dots & (1u << 15)) >> 1;
-            }
-            dots |= (uint32_t)hires_dot_patterns[b] << 1;
-
-            // Consume 14 dots
-            for(uint j=0; j < 7; j++)
-            {
-                uint dot_pattern = oddness | ((dots >> 24) & 0xff);
-                *(tmdsbuf_red++)   = tmds_hires_color_patterns_red[dot_pattern];
-                *(tmdsbuf_green++) = tmds_hires_color_patterns_green[dot_pattern];
-                *(tmdsbuf_blue++)  = tmds_hires_color_patterns_blue[dot_pattern];
-                dots <<= 2;
-                oddness ^= 0x100;
-            }
-        }
+        // The 7 pixel pairs of a byte alternate between even and odd pixel phases.
+        // Bytes are processed in pairs, so the phase of every pixel pair is fixed.
+        // The RGB symbols of a dot pattern are fetched from a single table entry.
+        render_kernel_hires_rgb(tmdsbuf_blue, DVI_WORDS_PER_CHANNEL*4, line_mem,
+                                tmds_hires_color_patterns_rgb, hires_dot_patterns);
     }
 
     dvi_send_scanline(tmdsbuf);
 }
 
+RENDER_LINE_VARIANT(render_hires_line_color,  render_hires_line, false, false)
+RENDER_LINE_VARIANT(render_hires_line_interp, render_hires_line, false, true)
+RENDER_LINE_VARIANT(render_hires_line_mono,   render_hires_line, true,  false)
+
+// line renderers: [monochrome][interpolator]
+static render_line_t DELAYED_COPY_DATA(render_hires_lines)[2][2] =
+{
+    {render_hires_line_color, render_hires_line_interp},
+    {render_hires_line_mono,  render_hires_line_mono}
+};
+
+static render_line_t DELAYED_COPY_CODE(render_hires_setup)(void)
+{
+    render_hires_interp_setup();
+    return render_hires_lines[mono_rendering][render_use_interp];
+}
 
 void DELAYED_COPY_CODE(render_hires)()
 {
-    for(uint line=0; line < 192; line++)
+    render_line_t render_line = render_hires_setup();
+
+    for(uint line=RENDER_LINE_START; line < RENDER_LINE_END; line++)
     {
-        render_hires_line(PAGE2SEL, line);
+        render_line(PAGE2SEL, line);
     }
 }
 
 
 void DELAYED_COPY_CODE(render_mixed_hires)()
 {
-    for(uint line=0; line < 160; line++)
+    render_line_t render_line = render_hires_setup();
+
+    for(uint line=RENDER_LINE_START; line < RENDER_MIXED_LINE_END; line++)
     {
-        render_hires_line(PAGE2SEL, line);
+        render_line(PAGE2SEL, line);
     }
 
     render_mixed_text();
@@ -0,0 +1,201 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include "config/config.h"
+#include "debug/profiler.h"
+#include "dvi/tmds.h"
+#include "render_kernels.h"
+
+uint32_t DELAYED_COPY_DATA(render_kernel_cycles)[RENDER_KERNEL_COUNT][2];
+
+// C kernels (always built: the assembly kernels in render_kernels.S are measured against them)
+void DELAYED_COPY_CODE(render_kernel_mono_c)(uint32_t* tmdsbuf, const uint32_t* bits, uint32_t pixels, const uint32_t* table)
+{
+    uint32_t b = 0;
+
+    for (uint32_t n=0;n<pixels/4;n++)
+    {
+        if ((n & 7) == 0)
+            b = *(bits++);
+#ifdef FEATURE_HSTX
+        *(tmdsbuf++) = table[b & 0xf];
+#else
+        const uint32_t* p = &table[(b & 0xf)*2];
+        tmdsbuf[0] = p[0];
+        tmdsbuf[1] = p[1];
+        tmdsbuf += 2;
+#endif
+        b >>= 4;
+    }
+}
+
+// Load the next 14 dots behind the current 14 dots (current dots: bits 28-15).
+#define hires_load_dots(dots, b) \
+{ \
+    uint32_t _b = (b); \
+    if(_b & 0x80) \
+    { \
+        /* Extend the last bit from the previous byte */ \
+        dots |= (dots & (1u << 15)) >> 1; \
+    } \
+    dots |= (uint32_t)dot_patterns[_b] << 1; \
+}
+
+// Output the pixel pair for the 8 dot window at the given position.
+#define HIRES_PIXEL_PAIR(shift, rgb) \
+{ \
+    const uint32_t* _sym = &rgb[((dots >> shift) & 0xff)*TMDS_HIRES_RGB_STRIDE]; \
+    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, _sym[0], _sym[1], _sym[2]); \
+}
+
+void DELAYED_COPY_CODE(render_kernel_hires_rgb_c)(dvi_pixel_pair_t* tmdsbuf_blue, uint32_t channel_bytes, const uint8_t* line_mem,
+                                                  const uint32_t* rgb, const uint16_t* dot_patterns)
+{
+#ifndef FEATURE_HSTX
+    uint32_t* tmdsbuf_green = tmdsbuf_blue  + channel_bytes/4;
+    uint32_t* tmdsbuf_red   = tmdsbuf_green + channel_bytes/4;
+#endif
+    const uint32_t* rgb_even = &rgb[0];
+    const uint32_t* rgb_odd  = &rgb[256*TMDS_HIRES_RGB_STRIDE];
+
+    // Load in the first 14 dots
+    uint32_t dots = (uint32_t)dot_patterns[line_mem[0]] << 15;
+
+    for(uint32_t i=1; i < 41; i+=2)
+    {
+        // first byte of the pair: starts with an even pixel
+        hires_load_dots(dots, line_mem[i]);
+        HIRES_PIXEL_PAIR(24, rgb_even);
+        HIRES_PIXEL_PAIR(22, rgb_odd);
+        HIRES_PIXEL_PAIR(20, rgb_even);
+        HIRES_PIXEL_PAIR(18, rgb_odd);
+        HIRES_PIXEL_PAIR(16, rgb_even);
+        HIRES_PIXEL_PAIR(14, rgb_odd);
+        HIRES_PIXEL_PAIR(12, rgb_even);
+        dots <<= 14;
+
+        // second byte of the pair: starts with an odd pixel
+        hires_load_dots(dots, (i < 39) ? line_mem[i+1] : 0);
+        HIRES_PIXEL_PAIR(24, rgb_odd);
+        HIRES_PIXEL_PAIR(22, rgb_even);
+        HIRES_PIXEL_PAIR(20, rgb_odd);
+        HIRES_PIXEL_PAIR(18, rgb_even);
+        HIRES_PIXEL_PAIR(16, rgb_odd);
+        HIRES_PIXEL_PAIR(14, rgb_even);
+        HIRES_PIXEL_PAIR(12, rgb_odd);
+        dots <<= 14;
+    }
+}
+
+void DELAYED_COPY_CODE(render_kernel_dhgr_rgb_c)(dvi_pixel_pair_t* tmdsbuf_blue, uint32_t channel_bytes, const uint32_t* dots,
+                                                 uint32_t count, const uint32_t* rgb)
+{
+#ifndef FEATURE_HSTX
+    uint32_t* tmdsbuf_green = tmdsbuf_blue  + channel_bytes/4;
+    uint32_t* tmdsbuf_red   = tmdsbuf_green + channel_bytes/4;
+#endif
+    uint32_t d = 0;
+
+    for (uint32_t n=0;n<count;n++)
+    {
+        if ((n & 7) == 0)
+            d = *(dots++);
+        const uint32_t* p = &rgb[(d & 0xf)*4];
+        uint32_t r = p[0];
+        uint32_t g = p[1];
+        uint32_t b = p[2];
+#ifdef FEATURE_HSTX
+        dvi_pixel_pair_t rgb332 = r | g | b;
+        tmdsbuf_blue[0] = rgb332; tmdsbuf_blue[1] = rgb332; tmdsbuf_blue += 2;
+#else
+        tmdsbuf_red[0]   = r; tmdsbuf_red[1]   = r; tmdsbuf_red   += 2;
+        tmdsbuf_green[0] = g; tmdsbuf_green[1] = g; tmdsbuf_green += 2;
+        tmdsbuf_blue[0]  = b; tmdsbuf_blue[1]  = b; tmdsbuf_blue  += 2;
+#endif
+        d >>= 4;
+    }
+}
+
+// minimum cycles of a few runs (filters the bus contention of core 1)
+#define KERNEL_MEASURE_RUNS 8
+#define KERNEL_MEASURE(result, call) \
+{ \
+    uint32_t _min = 0x00FFFFFF; \
+    for (uint _r=0;_r<KERNEL_MEASURE_RUNS;_r++) \
+    { \
+        uint32_t _start = CYCLE_COUNTER_READ(); \
+        call; \
+        uint32_t _cycles = CYCLE_COUNTER_ELAPSED(_start, CYCLE_COUNTER_READ()); \
+        if (_cycles < _min) \
+            _min = _cycles; \
+    } \
+    result = _min; \
+}
+
+void DELAYED_COPY_CODE(render_kernel_measure)(void)
+{
+    // scratch scanline, dot pattern table, 1bpp line and HIRES line
+    uint32_t* tmdsbuf = malloc(DVI_SCANLINE_WORDS*4 + 256*2 + TMDS_MONO_MAX_PIXELS/8 + 40);
+    if (!tmdsbuf)
+        return;
+    uint16_t* dot_patterns = (uint16_t*) &tmdsbuf[DVI_SCANLINE_WORDS];
+    uint32_t* bits         = (uint32_t*) &dot_patterns[256];
+    uint8_t*  line_mem     = (uint8_t*)  &bits[TMDS_MONO_MAX_PIXELS/32];
+
+    // mixed patterns: every table entry is used, half of the HIRES bytes are shifted
+    for (uint i=0;i<256;i++)
+        dot_patterns[i] = (i * 0x81) & 0x3fff;
+    for (uint i=0;i<TMDS_MONO_MAX_PIXELS/32;i++)
+        bits[i] = 0x5a3c96e1 ^ (i * 0x01010101);
+    for (uint i=0;i<40;i++)
+        line_mem[i] = (i & 1) ? 0xd5 : 0x2a;
+
+#ifdef FEATURE_HSTX
+    const uint32_t* mono_table = tmds_mono_rgb332[0];
+#else
+    const uint32_t* mono_table = tmds_mono_nibble[TMDS_MONO_LEVELS-1];
+#endif
+    dvi_pixel_pair_t* tmdsbuf_blue  = (dvi_pixel_pair_t*) tmdsbuf;
+    const uint32_t    channel_bytes = DVI_WORDS_PER_CHANNEL*4;
+
+    CYCLE_COUNTER_INIT();
+
+    KERNEL_MEASURE(render_kernel_cycles[RENDER_KERNEL_MONO][0],
+                   render_kernel_mono_c(tmdsbuf, bits, 560, mono_table));
+    KERNEL_MEASURE(render_kernel_cycles[RENDER_KERNEL_HIRES][0],
+                   render_kernel_hires_rgb_c(tmdsbuf_blue, channel_bytes, line_mem, tmds_hires_color_patterns_rgb, dot_patterns));
+    KERNEL_MEASURE(render_kernel_cycles[RENDER_KERNEL_DHGR][0],
+                   render_kernel_dhgr_rgb_c(tmdsbuf_blue, channel_bytes, bits, 560/4, tmds_dhgr_lores_rgb));
+#ifdef FEATURE_ASM_KERNELS
+    KERNEL_MEASURE(render_kernel_cycles[RENDER_KERNEL_MONO][1],
+                   render_kernel_mono_asm(tmdsbuf, bits, 560, mono_table));
+    KERNEL_MEASURE(render_kernel_cycles[RENDER_KERNEL_HIRES][1],
+                   render_kernel_hires_rgb_asm(tmdsbuf_blue, channel_bytes, line_mem, tmds_hires_color_patterns_rgb, dot_patterns));
+    KERNEL_MEASURE(render_kernel_cycles[RENDER_KERNEL_DHGR][1],
+                   render_kernel_dhgr_rgb_asm(tmdsbuf_blue, channel_bytes, bits, 560/4, tmds_dhgr_lores_rgb));
+#endif
+
+    free(tmdsbuf);
+}
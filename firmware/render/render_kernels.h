@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "dvi/tmds.h"
+
+// Scanline kernels: the innermost loops, which expand pixels to TMDS symbols.
+// Implemented in C (render_kernels.c) and in assembly for ARMv6-M/ARMv8-M
+// (render_kernels.S, selected by FEATURE_ASM_KERNELS at build time).
+//
+// The kernels write all three channels through a single pointer to the blue
+// channel: green and red follow at 'channel_bytes' distance (see dvi_scanline_rgb).
+// HSTX builds write RGB332 pixel pairs (see dvi_add_pixel_pair) and always use
+// the C kernels.
+
+// Expand a 1bpp line (first pixel in the least significant bit) into one channel.
+// The table provides 2 pixel pairs for each 4bit pattern (pixels: multiple of 4).
+// HSTX builds: the table provides one word (4 RGB332 pixels) per 4bit pattern.
+extern void render_kernel_mono_c(uint32_t* tmdsbuf, const uint32_t* bits, uint32_t pixels, const uint32_t* table);
+
+// Expand the 40 bytes of a HIRES line into 280 color pixel pairs. The table has
+// entries of TMDS_HIRES_RGB_STRIDE words (red, green, blue) for the 256 dot
+// patterns of even pixels, followed by the 256 patterns of odd pixels.
+extern void render_kernel_hires_rgb_c(dvi_pixel_pair_t* tmdsbuf_blue, uint32_t channel_bytes, const uint8_t* line_mem,
+                                      const uint32_t* rgb, const uint16_t* dot_patterns);
+
+// Expand a line of DHGR dots (packed like a 1bpp line) into two double pixels
+// per 4 dots. The table has entries of 4 words (red, green, blue) per 4 dots.
+extern void render_kernel_dhgr_rgb_c(dvi_pixel_pair_t* tmdsbuf_blue, uint32_t channel_bytes, const uint32_t* dots,
+                                     uint32_t count, const uint32_t* rgb);
+
+#ifdef FEATURE_ASM_KERNELS
+// same interface, implemented in render_kernels.S
+extern void render_kernel_mono_asm(uint32_t* tmdsbuf, const uint32_t* bits, uint32_t pixels, const uint32_t* table);
+extern void render_kernel_hires_rgb_asm(dvi_pixel_pair_t* tmdsbuf_blue, uint32_t channel_bytes, const uint8_t* line_mem,
+                                        const uint32_t* rgb, const uint16_t* dot_patterns);
+extern void render_kernel_dhgr_rgb_asm(dvi_pixel_pair_t* tmdsbuf_blue, uint32_t channel_bytes, const uint32_t* dots,
+                                       uint32_t count, const uint32_t* rgb);
+
+#define render_kernel_mono      render_kernel_mono_asm
+#define render_kernel_hires_rgb render_kernel_hires_rgb_asm
+#define render_kernel_dhgr_rgb  render_kernel_dhgr_rgb_asm
+#else
+#define render_kernel_mono      render_kernel_mono_c
+#define render_kernel_hires_rgb render_kernel_hires_rgb_c
+#define render_kernel_dhgr_rgb  render_kernel_dhgr_rgb_c
+#endif
+
+// CPU cycles per scanline of each kernel (560 pixel mono line, 40 byte HIRES line,
+// 560 dot DHGR line), measured at boot: [kernel][0=C, 1=assembly].
+// The assembly column stays 0 unless FEATURE_ASM_KERNELS is enabled.
+#define RENDER_KERNEL_MONO  0
+#define RENDER_KERNEL_HIRES 1
+#define RENDER_KERNEL_DHGR  2
+#define RENDER_KERNEL_COUNT 3
+extern uint32_t render_kernel_cycles[RENDER_KERNEL_COUNT][2];
+
+// Measure the kernels (must run before the DVI output starts: no interrupts).
+extern void render_kernel_measure(void);
@@ -0,0 +1,217 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "debug/profiler.h"
+#include "render.h"
+#include "render_latch.h"
+
+#ifdef FEATURE_FRAME_LATCH
+
+// one snapshot per displayed page: text/hires, main/aux memory
+typedef enum
+{
+    LATCH_TEXT_MAIN,
+    LATCH_TEXT_AUX,
+    LATCH_HGR_MAIN,
+    LATCH_HGR_AUX,
+    LATCH_SLOTS
+} latch_slot_id_t;
+
+typedef struct
+{
+    uint8_t*       copy;
+    uint32_t       size;
+    const uint8_t* source; // shadow memory page in the snapshot (NULL: none)
+} latch_slot_t;
+
+static latch_slot_t latch_slots[LATCH_SLOTS];
+static uint8_t*     latch_buffer;
+static bool         latch_full_copy;
+
+const volatile uint8_t *frame_text_p1;
+const volatile uint8_t *frame_text_p2;
+const volatile uint8_t *frame_text_p3;
+const volatile uint8_t *frame_text_p4;
+const volatile uint8_t *frame_hgr_p1;
+const volatile uint8_t *frame_hgr_p2;
+const volatile uint8_t *frame_hgr_p3;
+const volatile uint8_t *frame_hgr_p4;
+
+uint32_t render_latch_bytes;
+uint32_t render_latch_copied;
+uint32_t render_latch_cycles;
+uint32_t render_latch_cycles_max;
+
+void DELAYED_COPY_CODE(render_latch_reset)(void)
+{
+    frame_text_p1 = text_p1;
+    frame_text_p2 = text_p2;
+    frame_text_p3 = text_p3;
+    frame_text_p4 = text_p4;
+    frame_hgr_p1  = hgr_p1;
+    frame_hgr_p2  = hgr_p2;
+    frame_hgr_p3  = hgr_p3;
+    frame_hgr_p4  = hgr_p4;
+    frame_softsw  = soft_switches;
+}
+
+void DELAYED_COPY_CODE(render_latch_invalidate)(void)
+{
+    for (uint i=0;i<LATCH_SLOTS;i++)
+        latch_slots[i].source = NULL;
+}
+
+void DELAYED_COPY_CODE(render_latch_init)(void)
+{
+    render_latch_reset();
+    if (latch_buffer)
+        return;
+
+    // without the heap for the snapshot, the renderers just keep using the shadow memory
+    latch_buffer = malloc(FRAME_LATCH_SIZE);
+    if (!latch_buffer)
+        return;
+    render_latch_bytes = FRAME_LATCH_SIZE;
+
+    latch_slots[LATCH_TEXT_MAIN].size = 0x0400;
+    latch_slots[LATCH_TEXT_AUX].size  = 0x0400;
+    latch_slots[LATCH_HGR_MAIN].size  = 0x2000;
+    latch_slots[LATCH_HGR_AUX].size   = 0x2000;
+    uint8_t* copy = latch_buffer;
+    for (uint i=0;i<LATCH_SLOTS;i++)
+    {
+        latch_slots[i].copy = copy;
+        copy += latch_slots[i].size;
+    }
+    render_latch_invalidate();
+}
+
+// Update the snapshot of a page: copy the blocks written since the last frame,
+// or the complete page when the snapshot holds another page. Returns the
+// snapshot and adds the number of copied bytes.
+static const uint8_t* DELAYED_COPY_CODE(render_latch_page)(latch_slot_t* slot, const uint8_t* memory, volatile uint8_t* dirty, uint32_t offset)
+{
+    const uint8_t* source = memory + offset;
+    bool full = (slot->source != source)||(latch_full_copy);
+    slot->source = source;
+
+    dirty += offset >> SHADOW_BLOCK_SHIFT;
+    for (uint32_t block=0;block < (slot->size >> SHADOW_BLOCK_SHIFT);block++)
+    {
+        if ((!full)&&(dirty[block] == 0))
+            continue;
+
+        // clear the flag before copying: a write during the copy sets it again
+        dirty[block] = 0;
+        __dmb();
+
+        const volatile uint32_t* src = (const volatile uint32_t*) (source + (block << SHADOW_BLOCK_SHIFT));
+        uint32_t* dest = (uint32_t*) (slot->copy + (block << SHADOW_BLOCK_SHIFT));
+        for (uint32_t i=0;i<(1u << SHADOW_BLOCK_SHIFT)/4;i++)
+        {
+            dest[i] = src[i];
+        }
+        render_latch_copied += 1u << SHADOW_BLOCK_SHIFT;
+    }
+    return slot->copy;
+}
+
+void DELAYED_COPY_CODE(render_latch_frame)(uint32_t current_softsw)
+{
+    render_latch_reset();
+    frame_softsw        = current_softsw;
+    render_latch_copied = 0;
+
+    // Videx 80 column text has its own memory
+    if ((!latch_buffer)||
+        ((current_softsw & (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL)) == (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL)))
+        return;
+
+    uint32_t start = CYCLE_COUNTER_READ();
+
+    // The menu (and the test patterns) write the shadow memory directly,
+    // bypassing the write tracking: copy the complete pages while it is shown,
+    // and once more when it is closed.
+#ifdef FEATURE_TEST
+    latch_full_copy = true;
+#else
+    latch_full_copy |= IS_SOFTSWITCH(SOFTSW_MENU_ENABLE);
+#endif
+
+    bool     page2 = ((current_softsw & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2);
+    bool     aux   = ((current_softsw & (SOFTSW_80COL | SOFTSW_DGR)) != 0);
+    uint32_t mode  = current_softsw & SOFTSW_MODE_MASK;
+
+    // text/lores page: all modes but full screen hires
+    if (mode != SOFTSW_HIRES_MODE)
+    {
+        uint32_t offset = SHADOW_OFFSET(page2 ? 0x0800 : 0x0400);
+        const uint8_t* p = render_latch_page(&latch_slots[LATCH_TEXT_MAIN], apple_memory, shadow_dirty_main, offset);
+        if (page2)
+            frame_text_p2 = p;
+        else
+            frame_text_p1 = p;
+        if (aux)
+        {
+            p = render_latch_page(&latch_slots[LATCH_TEXT_AUX], aux_memory, shadow_dirty_aux, offset);
+            if (page2)
+                frame_text_p4 = p;
+            else
+                frame_text_p3 = p;
+        }
+    }
+
+    // hires page: full screen and mixed hires modes
+    if ((mode & (SOFTSW_TEXT_MODE|SOFTSW_HIRES_MODE)) == SOFTSW_HIRES_MODE)
+    {
+        uint32_t offset = SHADOW_OFFSET(page2 ? 0x4000 : 0x2000);
+        const uint8_t* p = render_latch_page(&latch_slots[LATCH_HGR_MAIN], apple_memory, shadow_dirty_main, offset);
+        if (page2)
+            frame_hgr_p2 = p;
+        else
+            frame_hgr_p1 = p;
+        if (aux)
+        {
+            p = render_latch_page(&latch_slots[LATCH_HGR_AUX], aux_memory, shadow_dirty_aux, offset);
+            if (page2)
+                frame_hgr_p4 = p;
+            else
+                frame_hgr_p3 = p;
+        }
+    }
+
+#ifndef FEATURE_TEST
+    latch_full_copy = IS_SOFTSWITCH(SOFTSW_MENU_ENABLE);
+#endif
+
+    render_latch_cycles = CYCLE_COUNTER_ELAPSED(start, CYCLE_COUNTER_READ());
+    if (render_latch_cycles > render_latch_cycles_max)
+        render_latch_cycles_max = render_latch_cycles;
+}
+
+#endif // FEATURE_FRAME_LATCH
@@ -0,0 +1,106 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "applebus/buffers.h"
+
+// Frame latch (FEATURE_FRAME_LATCH).
+//
+// Core 1 keeps writing the shadow memory while core 0 renders a frame, so a
+// game flipping pages (or redrawing a page) mid-frame shows parts of two
+// frames. With the frame latch, the display pages of the current mode are
+// copied at the start of each frame, and the renderers read this stable
+// snapshot instead. Only the 128 byte blocks written since the last frame are
+// copied (see SHADOW_MARK_DIRTY), unless the displayed page changed. The page
+// selection (PAGE2SEL) is also taken from the soft switches latched for the
+// frame.
+//
+// Costs: FRAME_LATCH_SIZE bytes of heap (allocated before the line cache, so
+// the cache is smaller), a second byte store per screen write on core 1, and the copy
+// time at the start of each frame (see render_latch_cycles).
+//
+// Without FEATURE_FRAME_LATCH, the frame pointers are the shadow memory page
+// pointers, and the page selection follows the live soft switches.
+
+#ifdef FEATURE_FRAME_LATCH
+
+// main + aux memory of one text and one hires page
+#define FRAME_LATCH_SIZE (2*(0x0400+0x2000))
+
+// display pages of the current frame: the snapshot for the displayed pages,
+// the shadow memory for all others
+extern const volatile uint8_t *frame_text_p1;
+extern const volatile uint8_t *frame_text_p2;
+extern const volatile uint8_t *frame_text_p3;
+extern const volatile uint8_t *frame_text_p4;
+extern const volatile uint8_t *frame_hgr_p1;
+extern const volatile uint8_t *frame_hgr_p2;
+extern const volatile uint8_t *frame_hgr_p3;
+extern const volatile uint8_t *frame_hgr_p4;
+
+// statistics: heap used by the latch, bytes copied for the last frame, CPU
+// cycles spent for copying (last frame and worst case)
+extern uint32_t render_latch_bytes;
+extern uint32_t render_latch_copied;
+extern uint32_t render_latch_cycles;
+extern uint32_t render_latch_cycles_max;
+
+// allocate the snapshot buffer (before the line cache takes the remaining heap)
+extern void render_latch_init(void);
+// latch the display pages for the frame about to be rendered
+extern void render_latch_frame(uint32_t current_softsw);
+// point the frame pointers to the (possibly redirected) shadow memory pages
+extern void render_latch_reset(void);
+// copy the complete pages for the next frame (the shadow memory was written
+// without write tracking)
+extern void render_latch_invalidate(void);
+
+#else
+
+#define frame_text_p1 text_p1
+#define frame_text_p2 text_p2
+#define frame_text_p3 text_p3
+#define frame_text_p4 text_p4
+#define frame_hgr_p1  hgr_p1
+#define frame_hgr_p2  hgr_p2
+#define frame_hgr_p3  hgr_p3
+#define frame_hgr_p4  hgr_p4
+
+#define render_latch_init()
+#define render_latch_frame(current_softsw)
+#define render_latch_reset()
+#define render_latch_invalidate()
+
+#endif // FEATURE_FRAME_LATCH
+
+#if defined(FEATURE_FRAME_LATCH) || defined(FEATURE_BEAM_TIMELINE)
+// soft switches latched for the current frame (or for the current segment of
+// a frame with mid-frame mode changes, see render_timeline.h)
+extern uint32_t frame_softsw;
+#define FRAME_SOFTSW frame_softsw
+#else
+#define FRAME_SOFTSW soft_switches
+#endif
@@ -49,44 +49,28 @@ uint16_t DELAYED_COPY_DATA(lores_dot_pattern)[16] =
     0x3fff
 };
 
-static void render_lores_line(bool p2, uint line);
 
-#define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
+#define PAGE2SEL ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
-void DELAYED_COPY_CODE(render_lores)()
-{
-    for(uint line=0; line < 24; line++)
-    {
-        render_lores_line(PAGE2SEL, line);
-    }
-}
-
-
-void DELAYED_COPY_CODE(render_mixed_lores)()
+static __force_inline void render_lores_line(bool p2, uint line, const bool mono, const uint palette)
 {
-    for(uint line=0; line < 20; line++)
-    {
-        render_lores_line(PAGE2SEL, line);
-    }
-
-    render_mixed_text();
-}
+    const uint8_t *line_buf = (const uint8_t *)((p2 ? frame_text_p2 : frame_text_p1) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
 
+    // resend the cached lines when the memory was not modified
+    uint32_t hash = tmds_cache_line_hash(0, line_buf);
+    if (tmds_cache_resend_lines(line*8, 8, hash))
+        return;
 
-static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
-{
     // Construct two scanlines for the two different colored cells at the same time
-    dvi_get_scanline(tmdsbuf1);
+    dvi_get_cached_scanline(tmdsbuf1, line*8+3, hash);
     dvi_scanline_rgb560(tmdsbuf1, tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue);
 
-    dvi_get_scanline(tmdsbuf2);
+    dvi_get_cached_scanline(tmdsbuf2, line*8+7, hash);
     dvi_scanline_rgb560(tmdsbuf2, tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue);
 
-    const uint8_t *line_buf = (const uint8_t *)((p2 ? text_p2 : text_p1) + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
-
-    if(mono_rendering)
+    if(mono)
     {
-        uint8_t color_offset = color_mode*12;
+        const uint color_offset = palette*12;
         for(uint i = 0; i < 40; i+=2)
         {
             uint32_t pattern1 = lores_dot_pattern[line_buf[i] & 0xf];
@@ -98,15 +82,13 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
             for(uint j = 0; j < 14; j++)
             {
                 uint32_t offset = color_offset + (pattern1 & 0x3);
-                *(tmdsbuf1_red++)   = tmds_mono_pixel_pair[offset+0];
-                *(tmdsbuf1_green++) = tmds_mono_pixel_pair[offset+4];
-                *(tmdsbuf1_blue++)  = tmds_mono_pixel_pair[offset+8];
+                dvi_add_pixel_pair(tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue,
+                                   tmds_mono_pixel_pair[offset+0], tmds_mono_pixel_pair[offset+4], tmds_mono_pixel_pair[offset+8]);
                 pattern1 >>= 2;
 
                 offset = color_offset + (pattern2 & 0x3);
-                *(tmdsbuf2_red++)   = tmds_mono_pixel_pair[offset+0];
-                *(tmdsbuf2_green++) = tmds_mono_pixel_pair[offset+4];
-                *(tmdsbuf2_blue++)  = tmds_mono_pixel_pair[offset+8];
+                dvi_add_pixel_pair(tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue,
+                                   tmds_mono_pixel_pair[offset+0], tmds_mono_pixel_pair[offset+4], tmds_mono_pixel_pair[offset+8]);
                 pattern2 >>= 2;
             }
         }
@@ -125,9 +107,7 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
             uint32_t b = pTmds[2];
             for (uint j = 0; j < 7; j++)
             {
-                *(tmdsbuf1_red++)   = r;
-                *(tmdsbuf1_green++) = g;
-                *(tmdsbuf1_blue++)  = b;
+                dvi_add_pixel_pair(tmdsbuf1_red, tmdsbuf1_green, tmdsbuf1_blue, r, g, b);
             }
 
             pTmds = &tmds_lorescolor[color2*3];
@@ -136,9 +116,7 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
             b = pTmds[2];
             for (uint j = 0; j < 7; j++)
             {
-                *(tmdsbuf2_red++)   = r;
-                *(tmdsbuf2_green++) = g;
-                *(tmdsbuf2_blue++)  = b;
+                dvi_add_pixel_pair(tmdsbuf2_red, tmdsbuf2_green, tmdsbuf2_blue, r, g, b);
             }
         }
     }
@@ -146,7 +124,9 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
     // repeat this line 3 more times (4x in total)
     for (uint yrepeat=0;yrepeat<3;yrepeat++)
     {
-        dvi_get_scanline(tmdsbufRepeat);
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbufRepeat, line*8+yrepeat, hash);
         dvi_copy_scanline(tmdsbufRepeat, tmdsbuf1);
         // send copied buffer
         dvi_send_scanline(tmdsbufRepeat);
@@ -157,7 +137,9 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
     // repeat this line 3 more times (4x in total)
     for (uint yrepeat=0;yrepeat<3;yrepeat++)
     {
-        dvi_get_scanline(tmdsbufRepeat);
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbufRepeat, line*8+4+yrepeat, hash);
         dvi_copy_scanline(tmdsbufRepeat, tmdsbuf2);
         // send copied buffer
         dvi_send_scanline(tmdsbufRepeat);
@@ -166,3 +148,45 @@ static void DELAYED_COPY_CODE(render_lores_line)(bool p2, uint line)
     // send original buffer
     dvi_send_scanline(tmdsbuf2);
 }
+
+RENDER_LINE_VARIANT(render_lores_line_color,      render_lores_line, false, COLOR_MODE_BW)
+RENDER_LINE_VARIANT(render_lores_line_mono_bw,    render_lores_line, true,  COLOR_MODE_BW)
+RENDER_LINE_VARIANT(render_lores_line_mono_green, render_lores_line, true,  COLOR_MODE_GREEN)
+RENDER_LINE_VARIANT(render_lores_line_mono_amber, render_lores_line, true,  COLOR_MODE_AMBER)
+
+// line renderers: color, then the monochrome palettes
+static render_line_t DELAYED_COPY_DATA(render_lores_lines)[1+RENDER_MONO_PALETTES] =
+{
+    render_lores_line_color,
+    render_lores_line_mono_bw,
+    render_lores_line_mono_green,
+    render_lores_line_mono_amber
+};
+
+static inline render_line_t render_lores_select(void)
+{
+    return render_lores_lines[(mono_rendering) ? 1+color_mode : 0];
+}
+
+void DELAYED_COPY_CODE(render_lores)()
+{
+    render_line_t render_line = render_lores_select();
+
+    for(uint line=RENDER_ROW_START; line < RENDER_ROW_END; line++)
+    {
+        render_line(PAGE2SEL, line);
+    }
+}
+
+
+void DELAYED_COPY_CODE(render_mixed_lores)()
+{
+    render_line_t render_line = render_lores_select();
+
+    for(uint line=RENDER_ROW_START; line < RENDER_MIXED_ROW_END; line++)
+    {
+        render_line(PAGE2SEL, line);
+    }
+
+    render_mixed_text();
+}
@@ -110,6 +110,7 @@ void DELAYED_COPY_CODE(render_splash)()
     // redirect pointers to local buffer
     text_p1 = text_page;
     text_p3 = color_page;
+    render_latch_reset();
 
     // initialize the splash screen
     showTitle(PRINTMODE_NORMAL);
@@ -217,4 +218,5 @@ void DELAYED_COPY_CODE(render_splash)()
     // restore pointers to text page
     text_p1 = (volatile uint8_t*) p1;
     text_p3 = (volatile uint8_t*) p3;
+    render_latch_reset();
 }
@@ -32,7 +32,7 @@ SOFTWARE.
 
 #include "render.h"
 
-#define PAGE2SEL ((soft_switches & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
+#define PAGE2SEL ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_PAGE_2)) == SOFTSW_PAGE_2)
 
 volatile uint_fast32_t text_flasher_mask = 0;
 static uint64_t next_flash_tick = 0;
@@ -68,11 +68,13 @@ void DELAYED_COPY_CODE(update_text_flasher)()
     }
 }
 
-static inline uint_fast8_t char_text_bits(uint_fast8_t ch, uint_fast8_t glyph_line)
+// resolve a character to its glyph: character ROM offset (low 16 bits) and
+// the inversion mask (upper bits) for normal, inverse and flashing characters
+static inline uint32_t char_glyph(uint_fast8_t ch)
 {
-    uint_fast8_t bits, invert;
+    uint_fast8_t invert;
 
-    if((ch & 0x80) || (soft_switches & SOFTSW_ALTCHAR))
+    if((ch & 0x80) || (FRAME_SOFTSW & SOFTSW_ALTCHAR))
     {
         // normal / mousetext character
         invert = 0x00;
@@ -83,59 +85,79 @@ static inline uint_fast8_t char_text_bits(uint_fast8_t ch, uint_fast8_t glyph_li
     }
 
     uint_fast16_t LanguageOffset = (language_switch) ? 0x800 : 0x0;
-    bits = character_rom[LanguageOffset | ((uint_fast16_t)ch << 3) | glyph_line];
+    return (LanguageOffset | ((uint_fast16_t)ch << 3)) | (invert << 16);
+}
+
+// get the 7 pixels of a resolved glyph for the given glyph line
+static inline uint_fast8_t glyph_text_bits(uint32_t glyph, uint_fast8_t glyph_line)
+{
+    uint_fast8_t bits = character_rom[(glyph & 0xffff) | glyph_line];
+    return (bits ^ (glyph >> 16)) & 0x7f;
+}
 
-    return (bits ^ invert) & 0x7f;
+static inline uint_fast8_t char_text_bits(uint_fast8_t ch, uint_fast8_t glyph_line)
+{
+    return glyph_text_bits(char_glyph(ch), glyph_line);
 }
 
-void DELAYED_COPY_CODE(render_text40_line)(const uint8_t *page, unsigned int line, uint8_t color_mode)
+void DELAYED_COPY_CODE(render_text40_line)(const uint8_t *page, unsigned int line, uint8_t color_mode, bool cached)
 {
     const uint8_t *line_buf = (const uint8_t *)(page + ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40));
 
-    for(uint glyph_line=0; glyph_line < 8; glyph_line++)
+    // resend the cached lines when the memory was not modified (not for the status lines)
+    uint32_t hash = tmds_cache_line_hash(color_mode ^ text_flasher_mask, line_buf);
+    uint32_t cache_line = (cached) ? line*8 : TMDS_CACHE_NO_LINE;
+    if ((cached)&&(tmds_cache_resend_lines(cache_line, 8, hash)))
+        return;
+
+    // resolve the glyphs once for all glyph lines of this text row
+    uint32_t glyphs[40];
+    for(uint col=0; col < 40; col++)
     {
-        dvi_get_scanline(tmdsbuf);
-        dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+        glyphs[col] = char_glyph(line_buf[col]);
+    }
 
-        for(uint col=0; col < 40; )
+    for(uint glyph_line=0; glyph_line < 8; glyph_line++)
+    {
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbuf, cache_line+glyph_line, hash);
+        dvi_scanline_border560(tmdsbuf);
+
+        tmds_mono_writer_t w;
+        tmds_mono_begin(&w);
+        for(uint col=0; col < 40; col++)
         {
-            // Grab 14 pixels from the next two characters
-            uint32_t bits;
-            bits  = char_text_bits(line_buf[col++], glyph_line);
-            bits |= char_text_bits(line_buf[col++], glyph_line) << 7;
-
-            // Translate bits into a pair of pixels
-            for(int i=0; i < 14; i++)
-            {
-                uint8_t color_offset = color_mode*3;
-                if ((bits & 1)==0)
-                    color_offset = 3*3;
-                *(tmdsbuf_blue++)  = tmds_mono_double_pixel[color_offset + 2];
-                *(tmdsbuf_green++) = tmds_mono_double_pixel[color_offset + 1];
-                *(tmdsbuf_red++)   = tmds_mono_double_pixel[color_offset + 0];
-                bits >>= 1;
-            }
+            // Translate the 7 pixels of the character into double pixels
+            uint32_t bits = glyph_text_bits(glyphs[col], glyph_line);
+            tmds_mono_put(&w, tmds_mono_double7(bits), 14);
         }
-        dvi_send_scanline(tmdsbuf);
+        tmds_mono_end(&w);
+        tmds_mono_send_scanline(tmdsbuf, DVI_APPLE2_XOFS_560, 560, color_mode);
     }
 }
 
 #define ADD_LORES_PIXEL(color3) { \
     uint32_t* pTmds = &tmds_lorescolor[color3]; \
-    *(tmdsbuf_red++)   = *(pTmds++); \
-    *(tmdsbuf_green++) = *(pTmds++); \
-    *(tmdsbuf_blue++)  = *pTmds; \
+    dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, pTmds[0], pTmds[1], pTmds[2]); \
 }
 
 void DELAYED_COPY_CODE(render_color_text40_line)(unsigned int line)
 {
     const uint16_t xofs = ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40);
-    const uint32_t *line_buf  = (const uint32_t *)(text_p1 + xofs);
-    const uint32_t *color_buf = (const uint32_t *)(text_p3 + xofs);
+    const uint32_t *line_buf  = (const uint32_t *)(frame_text_p1 + xofs);
+    const uint32_t *color_buf = (const uint32_t *)(frame_text_p3 + xofs);
+
+    // resend the cached lines when the memory was not modified
+    uint32_t hash = tmds_cache_line_hash(tmds_cache_line_hash(text_flasher_mask, line_buf), color_buf);
+    if (tmds_cache_resend_lines(line*8, 8, hash))
+        return;
 
     for(uint glyph_line=0; glyph_line < 8; glyph_line++)
     {
-        dvi_get_scanline(tmdsbuf);
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbuf, line*8+glyph_line, hash);
         dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
 
         for(uint col=0; col < 10; col++)
@@ -173,42 +195,48 @@ void DELAYED_COPY_CODE(render_text80_line)(const uint8_t *page_a, const uint8_t
     const uint8_t *line_buf_a = (const uint8_t *) (page_a + line_offset);
     const uint8_t *line_buf_b = (const uint8_t *) (page_b + line_offset);
 
-    uint8_t color_offset = color_mode*12;
+    // resend the cached lines when the memory was not modified
+    uint32_t hash = tmds_cache_line_hash(tmds_cache_line_hash(color_mode ^ text_flasher_mask, line_buf_a), line_buf_b);
+    if (tmds_cache_resend_lines(line*8, 8, hash))
+        return;
 
-    for(uint glyph_line=0; glyph_line < 8; glyph_line++)
+    // resolve the glyphs once for all glyph lines of this text row
+    uint32_t glyphs_a[40], glyphs_b[40];
+    for(uint col=0; col < 40; col++)
     {
-        dvi_get_scanline(tmdsbuf);
-        dvi_scanline_rgb560(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+        glyphs_a[col] = char_glyph(line_buf_a[col]);
+        glyphs_b[col] = char_glyph(line_buf_b[col]);
+    }
 
-        for(uint col=0; col < 40;)
+    for(uint glyph_line=0; glyph_line < 8; glyph_line++)
+    {
+        if (tmds_cache_skip_line())
+            continue;
+        dvi_get_cached_scanline(tmdsbuf, line*8+glyph_line, hash);
+        dvi_scanline_border560(tmdsbuf);
+
+        tmds_mono_writer_t w;
+        tmds_mono_begin(&w);
+        for(uint col=0; col < 40; col++)
         {
             // Grab 14 pixels from the next two characters
             uint32_t bits;
-            bits  = char_text_bits(line_buf_a[col], glyph_line) << 7;
-            bits |= char_text_bits(line_buf_b[col], glyph_line);
-            col++;
-
-            // Translate each pair of bits into a pair of pixels
-            for(int i=0; i < 7; i++)
-            {
-                char symbol = (bits&3) + color_offset;
-                *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[symbol+8];
-                *(tmdsbuf_green++) = tmds_mono_pixel_pair[symbol+4];
-                *(tmdsbuf_red++)   = tmds_mono_pixel_pair[symbol+0];
-                bits >>= 2;
-            }
+            bits  = glyph_text_bits(glyphs_a[col], glyph_line) << 7;
+            bits |= glyph_text_bits(glyphs_b[col], glyph_line);
+            tmds_mono_put(&w, bits, 14);
         }
-        dvi_send_scanline(tmdsbuf);
+        tmds_mono_end(&w);
+        tmds_mono_send_scanline(tmdsbuf, DVI_APPLE2_XOFS_560, 560, color_mode);
     }
 }
 
 void DELAYED_COPY_CODE(render_mixed_text)()
 {
-    if((internal_flags & IFLAGS_VIDEO7) && ((soft_switches & (SOFTSW_80STORE | SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80STORE | SOFTSW_DGR)))
+    if((internal_flags & IFLAGS_VIDEO7) && ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80STORE | SOFTSW_DGR)))
     {
         if (!mono_rendering)
         {
-            for(uint line=20; line < 24; line++)
+            for(uint line=RENDER_MIXED_TEXT_ROW_START; line < RENDER_ROW_END; line++)
             {
                 render_color_text40_line(line);
             }
@@ -219,14 +247,14 @@ void DELAYED_COPY_CODE(render_mixed_text)()
     // monochrome rendering
     {
         const bool page2 = PAGE2SEL;
-        const uint8_t *pageA = (const uint8_t *)(page2 ? text_p2 : text_p1);
+        const uint8_t *pageA = (const uint8_t *)(page2 ? frame_text_p2 : frame_text_p1);
         uint8_t cmode = (mono_rendering) ? color_mode : 0; /* white */
 
-        if(soft_switches & SOFTSW_80COL)
+        if(FRAME_SOFTSW & SOFTSW_80COL)
         {
             // 80 column mode rendering
-            const uint8_t *pageB = (const uint8_t *)(page2 ? text_p4 : text_p3);
-            for(uint line=20; line < 24; line++)
+            const uint8_t *pageB = (const uint8_t *)(page2 ? frame_text_p4 : frame_text_p3);
+            for(uint line=RENDER_MIXED_TEXT_ROW_START; line < RENDER_ROW_END; line++)
             {
                 render_text80_line(pageA, pageB, line, cmode);
             }
@@ -234,9 +262,9 @@ void DELAYED_COPY_CODE(render_mixed_text)()
         else
         {
             // 40 column mode rendering
-            for(uint line=20; line < 24; line++)
+            for(uint line=RENDER_MIXED_TEXT_ROW_START; line < RENDER_ROW_END; line++)
             {
-                render_text40_line(pageA, line, cmode);
+                render_text40_line(pageA, line, cmode, true);
             }
         }
     }
@@ -244,11 +272,11 @@ void DELAYED_COPY_CODE(render_mixed_text)()
 
 void DELAYED_COPY_CODE(render_text)()
 {
-    if((internal_flags & IFLAGS_VIDEO7) && ((soft_switches & (SOFTSW_80STORE | SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80STORE | SOFTSW_DGR)))
+    if((internal_flags & IFLAGS_VIDEO7) && ((FRAME_SOFTSW & (SOFTSW_80STORE | SOFTSW_80COL | SOFTSW_DGR)) == (SOFTSW_80STORE | SOFTSW_DGR)))
     {
         if (!mono_rendering)
         {
-            for(uint line=0; line < 24; line++)
+            for(uint line=RENDER_ROW_START; line < RENDER_ROW_END; line++)
             {
                 render_color_text40_line(line);
             }
@@ -263,13 +291,13 @@ void DELAYED_COPY_CODE(render_text)()
     // monochrome rendering
     {
         const bool page2 = PAGE2SEL;
-        const uint8_t *pageA = (const uint8_t *)(page2 ? text_p2 : text_p1);
+        const uint8_t *pageA = (const uint8_t *)(page2 ? frame_text_p2 : frame_text_p1);
 
-        if(soft_switches & SOFTSW_80COL)
+        if(FRAME_SOFTSW & SOFTSW_80COL)
         {
             // 80 column mode rendering
-            const uint8_t *pageB = (const uint8_t *)(page2 ? text_p4 : text_p3);
-            for(uint line=0; line < 24; line++)
+            const uint8_t *pageB = (const uint8_t *)(page2 ? frame_text_p4 : frame_text_p3);
+            for(uint line=RENDER_ROW_START; line < RENDER_ROW_END; line++)
             {
                 render_text80_line(pageA, pageB, line, color_mode);
             }
@@ -277,9 +305,9 @@ void DELAYED_COPY_CODE(render_text)()
         else
         {
             // 40 column mode rendering
-            for(uint line=0; line < 24; line++)
+            for(uint line=RENDER_ROW_START; line < RENDER_ROW_END; line++)
             {
-                render_text40_line(pageA, line, color_mode);
+                render_text40_line(pageA, line, color_mode, true);
             }
         }
     }
@@ -0,0 +1,158 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <hardware/sync.h>
+
+#include "applebus/buffers.h"
+#include "config/config.h"
+#include "render.h"
+#include "render_timeline.h"
+
+#ifdef FEATURE_BEAM_TIMELINE
+
+render_segment_t render_segments[RENDER_SEGMENTS_MAX];
+uint32_t render_line_start = 0;
+uint32_t render_line_end   = 192;
+uint32_t render_timeline_splits;
+
+// text, lores and the text rows of the mixed modes are rendered by rows of 8 scanlines
+static inline bool render_by_rows(uint32_t softsw, uint32_t line)
+{
+    if (softsw & SOFTSW_TEXT_MODE)
+        return true;
+    if ((softsw & SOFTSW_MIX_MODE)&&(line >= RENDER_MIXED_ROWS*8))
+        return true;
+    return ((softsw & SOFTSW_HIRES_MODE) == 0);
+}
+
+uint32_t DELAYED_COPY_CODE(render_timeline_frame)(uint32_t current_softsw)
+{
+    // the menu (and the test firmware) show their own display mode
+    if ((!beam_anchored)||(current_softsw & SOFTSW_MENU_ENABLE)||(IS_IFLAG(IFLAGS_TEST)))
+        return 0;
+
+    uint32_t lines          = IS_IFLAG(IFLAGS_PAL) ? BEAM_LINES_PAL : BEAM_LINES_NTSC;
+    uint32_t frame_cycles   = lines * BEAM_CYCLES_PER_LINE;
+    uint32_t visible_cycles = BEAM_VISIBLE_LINES * BEAM_CYCLES_PER_LINE;
+
+    // start of the last frame with complete visible scanlines
+    uint32_t frame_start = beam_frame_start;
+    uint32_t now         = bus_cycle_counter;
+    uint32_t start       = now - (now - frame_start) % frame_cycles;
+    if (now - start < visible_cycles)
+        start -= frame_cycles;
+
+    // find the changes of the frame (newest first), and the soft switches at its start
+    uint32_t count = beam_log_count;
+    __dmb();
+    uint32_t index   = count;
+    uint32_t changes = 0;
+    uint32_t softsw;
+    for (;;)
+    {
+        // the log does not reach back to the start of the frame
+        if ((index == 0)||(count - index >= BEAM_LOG_SIZE))
+            return 0;
+        index--;
+
+        volatile beam_event_t* event = &beam_log[index & (BEAM_LOG_SIZE-1)];
+        int32_t offset = (int32_t) (event->cycle - start);
+        if (offset < 0)
+        {
+            softsw = event->softsw;
+            break;
+        }
+        if (offset < (int32_t) visible_cycles)
+            changes++;
+    }
+    if (changes == 0)
+        return 0;
+
+    // segments of scanlines: a change during a scanline affects the next one
+    uint32_t segments = 0;
+    for (uint32_t i=index;(changes > 0)&&(segments < RENDER_SEGMENTS_MAX);i++)
+    {
+        uint32_t line = 0;
+        if (i != index)
+        {
+            volatile beam_event_t* event = &beam_log[i & (BEAM_LOG_SIZE-1)];
+            uint32_t offset = event->cycle - start;
+            if (offset >= visible_cycles)
+                continue;
+            changes--;
+            softsw = event->softsw;
+            line = (offset + BEAM_CYCLES_PER_LINE - 1) / BEAM_CYCLES_PER_LINE;
+            if (line >= BEAM_VISIBLE_LINES)
+                break;
+        }
+
+        // Videx text is rendered for the complete frame only
+        if ((softsw & (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL)) == (SOFTSW_TEXT_MODE|SOFTSW_VIDEX_80COL))
+            return 0;
+
+        if ((segments == 0)||(render_segments[segments-1].line != line))
+        {
+            render_segments[segments].line = line;
+            segments++;
+        }
+        render_segments[segments-1].softsw = (current_softsw & ~SOFTSW_BEAM_MASK) | (softsw & SOFTSW_BEAM_MASK);
+
+        // the change restored the switches of the previous segment
+        if ((segments > 1)&&(render_segments[segments-1].softsw == render_segments[segments-2].softsw))
+            segments--;
+    }
+
+    // core 1 overwrote the entries while they were read
+    __dmb();
+    if (beam_log_count - index >= BEAM_LOG_SIZE)
+        return 0;
+
+    // changes next to text or lores rows move to the nearest row (the later
+    // segment replaces any segment it moves over)
+    uint32_t exact    = segments;
+    uint32_t previous = render_segments[0].softsw;
+    segments = 1;
+    for (uint32_t i=1;i<exact;i++)
+    {
+        render_segment_t segment = render_segments[i];
+        if ((render_by_rows(previous, segment.line))||(render_by_rows(segment.softsw, segment.line)))
+            segment.line = (segment.line + 4) & ~7u;
+        previous = segment.softsw;
+        if (segment.line >= BEAM_VISIBLE_LINES)
+            break;
+        while ((segments > 0)&&(render_segments[segments-1].line >= segment.line))
+            segments--;
+        if ((segments > 0)&&(render_segments[segments-1].softsw == segment.softsw))
+            continue;
+        render_segments[segments++] = segment;
+    }
+
+    if (segments < 2)
+        return 0;
+
+    render_timeline_splits++;
+    return segments;
+}
+
+#endif // FEATURE_BEAM_TIMELINE
@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2024 Thorsten Brehm
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "applebus/buffers.h"
+
+// Beam timeline (FEATURE_BEAM_TIMELINE).
+//
+// Programs switching the display mode at a certain scanline (text above
+// graphics, graphics above text, two pages, ...) need the display mode of
+// each scanline, not just the mode at the start of the frame. Core 1 logs
+// every change of the display soft switches with its bus cycle, and derives
+// the beam position from the bus cycle counter: 65 cycles per scanline, 262
+// (NTSC) or 312 (PAL) scanlines per frame, anchored by the $C019 VBL polling
+// of the running program (see beam_log in buffers.h).
+//
+// At the start of each frame, the changes during the visible scanlines of the
+// last complete Apple II frame are mapped to scanlines, and the frame is
+// rendered in segments of scanlines, each with its own soft switches. The
+// hires renderers follow the exact scanline of a change. Where a text or lores
+// row is involved on either side of a change, the segment starts at the
+// nearest text row (8 scanlines), since these renderers work by rows. Frames
+// without a mid-frame change are rendered as a whole, as before, with no
+// per-line overhead.
+//
+// Without VBL polling (Apple II/II+, or programs never waiting for the VBL),
+// the beam position is unknown and frames are always rendered as a whole.
+
+#ifdef FEATURE_BEAM_TIMELINE
+
+#define RENDER_SEGMENTS_MAX 24
+
+typedef struct
+{
+    uint32_t line;   // first scanline of the segment
+    uint32_t softsw; // soft switches of the segment
+} render_segment_t;
+
+extern render_segment_t render_segments[RENDER_SEGMENTS_MAX];
+
+// scanlines rendered by the frame renderers: all lines, or the current segment
+// (whole text rows, unless only hires lines are rendered at its start/end)
+extern uint32_t render_line_start;
+extern uint32_t render_line_end;
+#define RENDER_LINE_START render_line_start
+#define RENDER_LINE_END   render_line_end
+#define RENDER_ROW_START  (render_line_start/8)
+#define RENDER_ROW_END    (render_line_end/8)
+
+// statistics: frames rendered in segments
+extern uint32_t render_timeline_splits;
+
+// map the mid-frame changes of the last complete Apple II frame to segments:
+// returns the number of segments, or 0 when the frame has a single mode
+extern uint32_t render_timeline_frame(uint32_t current_softsw);
+
+#else
+
+#define RENDER_LINE_START 0
+#define RENDER_LINE_END   192
+#define RENDER_ROW_START  0
+#define RENDER_ROW_END    24
+
+#endif // FEATURE_BEAM_TIMELINE
+
+// rows of the graphics and of the text part of the mixed modes
+#define RENDER_MIXED_ROWS           20
+#define RENDER_MIXED_ROW_END        ((RENDER_ROW_END   < RENDER_MIXED_ROWS) ? RENDER_ROW_END   : RENDER_MIXED_ROWS)
+#define RENDER_MIXED_TEXT_ROW_START ((RENDER_ROW_START > RENDER_MIXED_ROWS) ? RENDER_ROW_START : RENDER_MIXED_ROWS)
+#define RENDER_MIXED_LINE_END       ((RENDER_LINE_END  < RENDER_MIXED_ROWS*8) ? RENDER_LINE_END : RENDER_MIXED_ROWS*8)
@@ -90,16 +90,16 @@ static inline uint_fast8_t char_videx_text_bits(uint8_t ch, uint_fast8_t glyph_l
 // renders one text lines with 9 horizontal pixels
 static void render_videx_text_line(unsigned int line, uint16_t text_base_addr, uint16_t cursor_addr)
 {
-    const uint8_t color_offset = color_mode*12;
-
     const uint cursor_line_start = videx_crtc_regs[10] & 0xf;
     const uint cursor_line_end   = videx_crtc_regs[11] & 0xf;
     const uint crtc_mem_offset_of_line = text_base_addr + (line * 80);
 
     for(uint glyph_line = 0; glyph_line < 9; glyph_line++)
     {
+        if (tmds_cache_skip_line())
+            continue;
         dvi_get_scanline(tmdsbuf);
-        dvi_scanline_rgb640(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
+        uint32_t* pixels = tmds_mono_line();
         bool cursor_in_line = (glyph_line >= cursor_line_start) && (glyph_line <= cursor_line_end);
 
         // Note: Videx characters are 8 pixels wide so 80 columns fills an entire 640 pixel VGA line and
@@ -130,20 +130,13 @@ static void render_videx_text_line(unsigned int line, uint16_t text_base_addr, u
             has_cursor = (cursor_in_line) && (crtc_mem_offset+3 == cursor_addr);
             bits      |= (char_videx_text_bits(data, glyph_line, has_cursor)) << 24;
 
-            // Render each pair of bits into a pair of pixels, least significant bit first
-            for(int i = 0; i < 16; i++)
-            {
-                char symbol = (bits&3) + color_offset;
-                *(tmdsbuf_blue++)  = tmds_mono_pixel_pair[symbol+8];
-                *(tmdsbuf_green++) = tmds_mono_pixel_pair[symbol+4];
-                *(tmdsbuf_red++)   = tmds_mono_pixel_pair[symbol+0];
-                bits >>= 2;
-            }
+            // 32 pixels, least significant bit first
+            pixels[col] = bits;
 
             crtc_mem_offset += 4;
         }
 
-        dvi_send_scanline(tmdsbuf);
+        tmds_mono_send_scanline(tmdsbuf, DVI_APPLE2_XOFS_640, 640, color_mode);
     }
 }
 
@@ -151,13 +144,13 @@ void DELAYED_COPY_CODE(render_skip_lines)(uint row_count)
 {
     for (uint row=0;row<row_count;row++)
     {
+        if (tmds_cache_skip_line())
+            continue;
         dvi_get_scanline(tmdsbuf);
         dvi_scanline_rgb640(tmdsbuf, tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue);
         for (uint32_t x=0;x<320;x++)
         {
-            *(tmdsbuf_red++)   = TMDS_SYMBOL_0_0;
-            *(tmdsbuf_green++) = TMDS_SYMBOL_0_0;
-            *(tmdsbuf_blue++)  = TMDS_SYMBOL_0_0;
+            dvi_add_pixel_pair(tmdsbuf_red, tmdsbuf_green, tmdsbuf_blue, TMDS_SYMBOL_0_0, TMDS_SYMBOL_0_0, TMDS_SYMBOL_0_0);
         }
         dvi_send_scanline(tmdsbuf);
     }
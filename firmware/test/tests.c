@@ -29,7 +29,10 @@ SOFTWARE.
  * all supported video modes and settings.
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include "pico/time.h"
+#include "hardware/dma.h"
 #include "debug/debug.h"
 #include "menu/menu.h"
 #include "applebus/abus.h"
@@ -38,6 +41,7 @@ SOFTWARE.
 #include "render/render.h"
 #include "config/config.h"
 #include "dvi/a2dvi.h"
+#include "debug/profiler.h"
 #include "testpattern_hgr.h"
 #include "testpattern_dhgr.h"
 
@@ -90,6 +94,8 @@ const uint32_t SimulatedSlotNr = 1;
 
 #define TEST_MENU
 
+#define TEST_BUS_CONTENTION
+
 const uint32_t TestDelayMilliseconds = 300;//1*1000;
 
 color_mode_t test_color_mode = COLOR_MODE_GREEN;
@@ -168,10 +174,21 @@ void showTestConfig()
     if (test_scanline_mode)
         printXY(17,23, "SCANLINES", PRINTMODE_NORMAL);
 
-    if (cfg_video_mode & 1)
-        printXY(27,23, "720", PRINTMODE_NORMAL);
-    else
-        printXY(27,23, "640", PRINTMODE_NORMAL);
+    switch (cfg_video_mode & ~DviModeChange)
+    {
+        case Dvi720x480:
+            printXY(27,23, "720", PRINTMODE_NORMAL);
+            break;
+        case Dvi720x576:
+            printXY(27,23, "576", PRINTMODE_NORMAL);
+            break;
+        case Dvi800x480:
+            printXY(27,23, "800", PRINTMODE_NORMAL);
+            break;
+        default:
+            printXY(27,23, "640", PRINTMODE_NORMAL);
+            break;
+    }
 }
 
 void toggleAltChar()
@@ -225,8 +242,8 @@ void setLoresPixel(uint16_t x, uint8_t y, bool page2, uint8_t color)
      }
 
      uint line = y >> 1;
-     uint16_t address = 0x400+((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40)+x;
-     apple_memory[address] = (apple_memory[address] & mask) | color;
+     uint16_t address = ((line & 0x7) << 7) + (((line >> 3) & 0x3) * 40)+x;
+     text_p1[address] = (text_p1[address] & mask) | color;
 }
 
 void setLoresTestPattern(uint lines)
@@ -643,7 +660,7 @@ void test_menu()
         sleep(TestDelayMilliseconds/5);
     }
 
-    simulateWrite(REG_CARD+0x9, 22);  // CTRL-V: toggle video mode
+    simulateWrite(REG_CARD+0x9, 22);  // CTRL-V: next video mode
     sleep(3000);
 
     simulateWrite(REG_CARD+0x9, 27); // escape/exit
@@ -651,6 +668,89 @@ void test_menu()
 #endif
 }
 
+#ifdef TEST_BUS_CONTENTION
+// simulated bus cycles per phase of the contention test
+#define TEST_CONTENTION_CYCLES (2*1000*1000)
+
+// simulate screen writes to the DHGR pages, recording the bus handler statistics
+static void testContentionCycles(void)
+{
+    uint32_t card_select = (1u << (CONFIG_PIN_APPLEBUS_SELECT - CONFIG_PIN_APPLEBUS_DATA_BASE));
+
+    memset((void*) bus_handler_histogram, 0, sizeof(bus_handler_histogram));
+    bus_handler_worst_cycles = 0;
+
+    for (uint32_t i=0;i<TEST_CONTENTION_CYCLES;i++)
+    {
+        uint16_t address = 0x2000 + (i & 0x3fff);
+        // alternate between main and aux memory (soft switch reads/writes are measured, too)
+        if ((i & 0x3fff) == 0)
+        {
+            uint16_t reg = (i & 0x4000) ? 0xc005 : 0xc004; // RAMWRT on/off
+            abus_interface_timed((reg << 10) | card_select);
+        }
+        abus_interface_timed((address << 10) | card_select | (i & 0xff));
+    }
+}
+#endif
+
+// Bus handler jitter while the cores and DMA compete for the RAM banks: the bus
+// handler statistics (debug menu, page 2) are recorded with the normal load
+// (DHGR rendering, DVI DMA), and with an additional DMA load on core 0's data,
+// whose banks also hold the bottom of the heap with the TMDS buffers. Core 1's
+// bus handlers and shadow memory have a bank of their own (see linker scripts),
+// so the additional load must not increase their worst case.
+void test_bus_contention()
+{
+#ifdef TEST_BUS_CONTENTION
+    simulateWrite(REG_SW_HIRES, 0);         // enable HIRES graphics
+    simulateWrite(REG_SW_DGR, 0);           // enable DOUBLE HIRES mode
+    simulateWrite(REG_SW_TEXT_OFF, 0);      // disable TEXT mode
+    simulateWrite(REG_SW_80STORE_OFF, 0);   // disable 80STORE, RAMWRT selects the bank
+
+    soft_switches |= SOFTSW_V7_MODE3;
+
+    CYCLE_COUNTER_INIT();
+
+    // DMA load target: core 0's data (the heap may reach into core 1's bank)
+    static uint32_t dma_buffer[2];
+
+    for (uint phase=0;phase<2;phase++)
+    {
+        int dma_channel = -1;
+
+        if (phase == 1)
+        {
+            // additional DMA load: copy a word within core 0's data, as fast as the bus permits
+            dma_channel = dma_claim_unused_channel(true);
+            dma_channel_config cfg = dma_channel_get_default_config(dma_channel);
+            channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+            channel_config_set_read_increment(&cfg, false);
+            channel_config_set_write_increment(&cfg, false);
+            dma_channel_configure(dma_channel, &cfg, &dma_buffer[1], &dma_buffer[0], 0x0fffffff, true);
+        }
+
+        testContentionCycles();
+
+        if (dma_channel >= 0)
+        {
+            dma_channel_abort(dma_channel);
+            dma_channel_unclaim(dma_channel);
+        }
+
+        // show the bus handler statistics of this phase
+        test_debug_menu();
+        test_debug_menu();
+    }
+
+    simulateWrite(0xc004, 0);               // RAMWRT off
+    setDoubleHiresTestPattern();            // restore the screen areas
+    simulateWrite(REG_SW_DGR_OFF, 0);       // disable DOUBLE HIRES mode
+    simulateWrite(REG_SW_HIRES_OFF,  0);    // disable HIRES
+    simulateWrite(REG_SW_TEXT,       0);    // enable text mode
+#endif
+}
+
 #ifdef FEATURE_TEST_TMDS
 void render_tmds_test()
 {
@@ -874,11 +974,14 @@ void test_loop()
         testHires();
         testDoubleHires();
 
+        // bus handler jitter under RAM contention
+        test_bus_contention();
+
         // show debug menu. And lock up when scanline errors occurred.
         do
         {
             test_debug_menu();
-        } while (a2dvi_scanline_errors());
+        } while (a2dvi_scanline_errors(NULL));
 
         iteration++;
     }
@@ -35,11 +35,17 @@ void __dvi_func(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint
 		inst->dma_cfg[i].tx_fifo = (void*)&inst->ser_cfg->pio->txf[inst->ser_cfg->sm_tmds[i]];
 		inst->dma_cfg[i].dreq = pio_get_dreq(inst->ser_cfg->pio, inst->ser_cfg->sm_tmds[i], true);
 	}
-	inst->late_scanline_ctr = 0;
+	inst->scanline_skip = 0;
 	inst->scanline_emulation = 0;
 	inst->scanline_errors = 0;
+	inst->scanline_recovered = 0;
+	inst->scanline_stale = false;
+	inst->frame_stamp_src = NULL;
+	inst->frame_stamp = 0;
+	inst->frame_count = 0;
 	inst->tmds_buf_release_next = NULL;
 	inst->tmds_buf_release = NULL;
+	inst->tmds_buf_last = NULL;
 	queue_init_with_spinlock(&inst->q_tmds_valid,   sizeof(void*),  8, spinlock_tmds_queue);
 	queue_init_with_spinlock(&inst->q_tmds_free,    sizeof(void*),  8, spinlock_tmds_queue);
 #if 0
@@ -47,29 +53,34 @@ void __dvi_func(dvi_init)(struct dvi_inst *inst, uint spinlock_tmds_queue, uint
 	queue_init_with_spinlock(&inst->q_colour_free,  sizeof(void*),  8, spinlock_colour_queue);
 #endif
 
-	dvi_setup_scanline_for_vblank(inst->timing, inst->dma_cfg, true,  &inst->dma_list_vblank_sync);
-	dvi_setup_scanline_for_vblank(inst->timing, inst->dma_cfg, false, &inst->dma_list_vblank_nosync);
-	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, (void*)SRAM_BASE, &inst->dma_list_active);
-	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, NULL, &inst->dma_list_error);
+	dvi_setup_scanline_for_vblank(inst->timing, inst->dma_cfg, inst->h_border, true,  &inst->dma_list_vblank_sync);
+	dvi_setup_scanline_for_vblank(inst->timing, inst->dma_cfg, inst->h_border, false, &inst->dma_list_vblank_nosync);
+	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, inst->h_border, (void*)SRAM_BASE, &inst->dma_list_active);
+	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, inst->h_border, NULL, &inst->dma_list_error);
 
+	uint image_pixels = inst->timing->h_active_pixels - 2 * inst->h_border;
+
+	// The heap follows core 0's code and data (see the linker scripts): these
+	// buffers are allocated at its bottom, so the DMA reading them competes with
+	// core 0, but not with the bus handlers in core 1's RAM bank.
 	for (int i = 0; i < DVI_N_TMDS_BUFFERS; ++i)
 	{
 		void *tmdsbuf;
 #if DVI_MONOCHROME_TMDS
-		tmdsbuf = malloc(inst->timing->h_active_pixels / DVI_SYMBOLS_PER_WORD * sizeof(uint32_t));
+		tmdsbuf = malloc(image_pixels / DVI_SYMBOLS_PER_WORD * sizeof(uint32_t));
 #else
-		tmdsbuf = malloc(3 * inst->timing->h_active_pixels / DVI_SYMBOLS_PER_WORD * sizeof(uint32_t));
+		tmdsbuf = malloc(3 * image_pixels / DVI_SYMBOLS_PER_WORD * sizeof(uint32_t));
 
 		if (tmdsbuf)
 		{
 			// initialize all TMDS buffers with black pixels
-			for (int j=0;j<3 * inst->timing->h_active_pixels / 2;j++)
+			for (int j=0;j<3 * image_pixels / 2;j++)
 				((uint32_t*)tmdsbuf)[j] = 0x7fd00;
 		}
 #endif
 		if (!tmdsbuf)
 			panic("TMDS buffer allocation failed");
-		queue_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+		queue_spsc_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
 	}
 }
 
@@ -162,25 +173,25 @@ void __dvi_func(dvi_start)(struct dvi_inst *inst) {
 #if 0 // DISABLED: not used by A2DVI
 static inline void __dvi_func_x(_dvi_prepare_scanline_8bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
 	uint32_t *tmdsbuf;
-	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+	queue_spsc_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
 	uint pixwidth = inst->timing->h_active_pixels;
 	uint words_per_channel = pixwidth / DVI_SYMBOLS_PER_WORD;
 	// Scanline buffers are half-resolution; the functions take the number of *input* pixels as parameter.
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 0 * words_per_channel, pixwidth / 2, DVI_8BPP_BLUE_MSB,  DVI_8BPP_BLUE_LSB );
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 1 * words_per_channel, pixwidth / 2, DVI_8BPP_GREEN_MSB, DVI_8BPP_GREEN_LSB);
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 2 * words_per_channel, pixwidth / 2, DVI_8BPP_RED_MSB,   DVI_8BPP_RED_LSB  );
-	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+	queue_spsc_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
 }
 
 static inline void __dvi_func_x(_dvi_prepare_scanline_16bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
 	uint32_t *tmdsbuf;
-	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+	queue_spsc_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
 	uint pixwidth = inst->timing->h_active_pixels;
 	uint words_per_channel = pixwidth / DVI_SYMBOLS_PER_WORD;
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 0 * words_per_channel, pixwidth / 2, DVI_16BPP_BLUE_MSB,  DVI_16BPP_BLUE_LSB );
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 1 * words_per_channel, pixwidth / 2, DVI_16BPP_GREEN_MSB, DVI_16BPP_GREEN_LSB);
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 2 * words_per_channel, pixwidth / 2, DVI_16BPP_RED_MSB,   DVI_16BPP_RED_LSB  );
-	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+	queue_spsc_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
 }
 
 // "Worker threads" for TMDS encoding (core enters and never returns, but still handles IRQs)
@@ -220,11 +231,18 @@ void __dvi_func(dvi_scanbuf_main_16bpp)(struct dvi_inst *inst) {
 
 static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 {
-	// Every fourth interrupt marks the start of the horizontal active region. We
-	// now have until the end of this region to generate DMA blocklist for next
-	// scanline.
+	// Every fourth interrupt marks the start of the horizontal active region
+	// (the scanline buffer, with horizontal borders). We now have until the end
+	// of this region to generate DMA blocklist for next scanline.
+	bool prev_active = inst->timing_state.v_state == DVI_STATE_ACTIVE;
+	bool prev_vsync = inst->timing_state.v_state == DVI_STATE_SYNC;
 	dvi_timing_state_advance(inst->timing, &inst->timing_state);
-	if (inst->tmds_buf_release && !queue_try_add_u32(&inst->q_tmds_free, &inst->tmds_buf_release))
+	if ((inst->timing_state.v_state == DVI_STATE_ACTIVE) && (inst->timing_state.v_ctr == 0)) {
+		if (inst->frame_stamp_src)
+			inst->frame_stamp = *inst->frame_stamp_src;
+		++inst->frame_count;
+	}
+	if (inst->tmds_buf_release && !queue_spsc_try_add_u32(&inst->q_tmds_free, &inst->tmds_buf_release))
 		panic("TMDS free queue full in IRQ!");
 	inst->tmds_buf_release = inst->tmds_buf_release_next;
 	inst->tmds_buf_release_next = NULL;
@@ -232,18 +250,11 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 	// Make sure all three channels have definitely loaded their last block
 	// (should be within a few cycles of one another)
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
-		while (dma_debug_hw->ch[inst->dma_cfg[i].chan_data].dbg_tcr != inst->timing->h_active_pixels / DVI_SYMBOLS_PER_WORD)
+		while (dma_debug_hw->ch[inst->dma_cfg[i].chan_data].dbg_tcr != (inst->timing->h_active_pixels - 2 * inst->h_border) / DVI_SYMBOLS_PER_WORD)
 			tight_loop_contents();
 	}
 
 	uint32_t *tmdsbuf;
-	while ((inst->late_scanline_ctr > 0) && (queue_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf)))
-	{
-		// If we displayed this buffer then it would be in the wrong vertical
-		// position on-screen. Just pass it back.
-		queue_add_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
-		--inst->late_scanline_ctr;
-	}
 
 	// blank lines (overscan area, first 48 lines, last 48 lines (apple II letter box), and scanlines)
 	if ((inst->timing_state.v_state != DVI_STATE_ACTIVE)||
@@ -253,31 +264,54 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 	{
 		// Don't care
 		tmdsbuf = NULL;
+
+		// the last line is not repeated across frames: release it during vertical blanking
+		if ((inst->timing_state.v_state != DVI_STATE_ACTIVE)&&(inst->tmds_buf_last))
+		{
+			inst->tmds_buf_release_next = inst->tmds_buf_last;
+			inst->tmds_buf_last = NULL;
+			inst->scanline_stale = false;
+		}
 	}
 	else
-	if (queue_try_peek_u32(&inst->q_tmds_valid, &tmdsbuf))
+	if (queue_spsc_try_peek_u32(&inst->q_tmds_valid, &tmdsbuf))
 	{
 		if (inst->timing_state.v_ctr % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1) {
-			queue_remove_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
-			inst->tmds_buf_release_next = tmdsbuf;
+			queue_spsc_remove_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+			// keep this line for repeating it, release the one displayed before
+			inst->tmds_buf_release_next = inst->tmds_buf_last;
+			inst->tmds_buf_last = tmdsbuf;
+			if (inst->scanline_stale) {
+				// the line was late, but made it in time for its repeated display line
+				++inst->scanline_recovered;
+				inst->scanline_stale = false;
+			}
 		}
 	}
 	else {
-		// No valid scanline was ready
-		tmdsbuf = NULL;
-		++inst->scanline_errors;
-		if (inst->timing_state.v_ctr % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1)
-			++inst->late_scanline_ctr;
+		// No valid scanline was ready: show the last line once more (black when
+		// there is none yet in this frame), rather than a flashing black line
+		tmdsbuf = inst->tmds_buf_last;
+		if (inst->timing_state.v_ctr % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1) {
+			// Missed entirely: the source skips a line instead, so its following
+			// scanlines are displayed at the right vertical position again.
+			++inst->scanline_errors;
+			++inst->scanline_skip;
+			inst->scanline_stale = false;
+		}
+		else
+			inst->scanline_stale = true;
 	}
 
+	struct dvi_scanline_dma_list *list;
 	switch (inst->timing_state.v_state) {
 		case DVI_STATE_ACTIVE:
 			if (tmdsbuf) {
-				dvi_update_scanline_data_dma(inst->timing, tmdsbuf, &inst->dma_list_active);
-				_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_active);
+				list = &inst->dma_list_active;
+				dvi_update_scanline_data_dma(inst->timing, inst->h_border, tmdsbuf, list);
 			}
 			else {
-				_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_error);
+				list = &inst->dma_list_error;
 			}
 #if 0
 			if (inst->scanline_callback && inst->timing_state.v_ctr % DVI_VERTICAL_REPEAT == DVI_VERTICAL_REPEAT - 1) {
@@ -286,14 +320,16 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst)
 #endif
 			break;
 		case DVI_STATE_SYNC:
-			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_sync);
+			list = &inst->dma_list_vblank_sync;
 			break;
 		//case DVI_STATE_FRONT_PORCH:
 		//case DVI_STATE_BACK_PORCH:
 		default:
-			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_nosync);
+			list = &inst->dma_list_vblank_nosync;
 			break;
 	}
+	dvi_set_scanline_border_dma(inst->timing, inst->dma_cfg, inst->h_border, prev_active, prev_vsync, list);
+	_dvi_load_dma_op(inst->dma_cfg, list);
 }
 
 static void __dvi_func(dvi_dma0_irq)() {
@@ -335,17 +371,23 @@ void __dvi_func(dvi_destroy)(struct dvi_inst *inst, uint irq_num)
 			inst->tmds_buf_release_next = NULL;
 			buf_count++;
 		}
+		if (inst->tmds_buf_last)
+		{
+			free(inst->tmds_buf_last);
+			inst->tmds_buf_last = NULL;
+			buf_count++;
+		}
 		while (buf_count < DVI_N_TMDS_BUFFERS)
 		{
 			void *tmdsbuf = NULL;
 			// free queue
-			if (queue_try_remove_u32(&inst->q_tmds_free, &tmdsbuf))
+			if (queue_spsc_try_remove_u32(&inst->q_tmds_free, &tmdsbuf))
 			{
 				free(tmdsbuf);
 				buf_count++;
 			}
 			// also consider valid queue, since we may have aborted a frame display cycle
-			if (queue_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf))
+			if (queue_spsc_try_remove_u32(&inst->q_tmds_valid, &tmdsbuf))
 			{
 				free(tmdsbuf);
 				buf_count++;
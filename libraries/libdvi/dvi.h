@@ -32,6 +32,9 @@ struct dvi_inst {
 	struct dvi_lane_dma_cfg dma_cfg[N_TMDS_LANES];
 	struct dvi_timing_state timing_state;
 	struct dvi_serialiser_cfg* ser_cfg;
+	// Black border left and right of the scanline buffers, output by the DMA
+	// (pixels, even): the scanline buffers are h_active_pixels - 2*h_border wide
+	uint h_border;
 #if 0
 	// Called in the DMA IRQ once per scanline -- careful with the run time!
 	dvi_callback_t scanline_callback;
@@ -49,13 +52,26 @@ struct dvi_inst {
 	// the actual data DMA transfer has completed.
 	uint32_t *tmds_buf_release_next;
 	uint32_t *tmds_buf_release;
-	// Remember how far behind the source is on TMDS scanlines, so we can output
-	// solid colour until they catch up (rather than dying spectacularly)
-	uint32_t late_scanline_ctr;
+	// Most recently displayed TMDS buffer of the current frame. It is repeated
+	// when the next scanline is not ready in time, and only released when the
+	// next scanline is displayed (or at the end of the frame).
+	uint32_t *tmds_buf_last;
+	// Scanlines missed entirely (counting up): the source skips as many lines
+	// (see tmds_cache_skip_line), so the following ones keep their position
+	volatile uint32_t scanline_skip;
 	// count production errors (scanlines were not ready in time)
 	uint32_t scanline_errors;
+	// count scanlines which were late for their first, but ready for their
+	// repeated display line (the last line was shown once more instead)
+	uint32_t scanline_recovered;
+	bool scanline_stale;
 	// enable/disable scan line emulation (alternating blank lines)
 	uint8_t scanline_emulation;
+	// Frame pacing: *frame_stamp_src is sampled when the active area of a
+	// frame starts (optional, e.g. a counter of the source's clock)
+	const volatile uint32_t *frame_stamp_src;
+	volatile uint32_t frame_stamp;
+	volatile uint32_t frame_count;
 
 	// Encoded scanlines:
 	queue_t q_tmds_valid;
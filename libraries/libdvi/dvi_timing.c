@@ -46,27 +46,29 @@ struct dvi_timing __dvi_const(dvi_timing_720x480p_60hz) = {
 	.bit_clk_khz       = 270000
 };
 
-#if 0 // DISABLED: not used by A2DVI
-// SVGA -- completely by-the-book but requires 400 MHz clk_sys
-const struct dvi_timing __dvi_const(dvi_timing_800x600p_60hz) = {
+// 720x576p 50 Hz -- the CEA mode for PAL displays, same pixel clock as 720x480p
+// (270 MHz clk_sys). One line less than the standard 625 lines per frame: 27 MHz /
+// (864 * 624) is exactly the frame rate of a PAL Apple II (1015625 Hz / (65 * 312)).
+struct dvi_timing __dvi_const(dvi_timing_720x576p_50hz) = {
 	.h_sync_polarity   = false,
-	.h_front_porch     = 44,
-	.h_sync_width      = 128,
-	.h_back_porch      = 88,
-	.h_active_pixels   = 800,
+	.h_front_porch     = 12,
+	.h_sync_width      = 64,
+	.h_back_porch      = 68,
+	.h_active_pixels   = 720,
 
 	.v_sync_polarity   = false,
-	.v_front_porch     = 1,
-	.v_sync_width      = 4,
-	.v_back_porch      = 23,
-	.v_active_lines    = 600,
+	.v_front_porch     = 5,
+	.v_sync_width      = 5,
+	.v_back_porch      = 38,
+	.v_active_lines    = 576,
 
-	.bit_clk_khz       = 400000
+	.bit_clk_khz       = 270000
 };
 
 // 800x480p 60 Hz (note this doesn't seem to be a CEA mode, I just used the
-// output of `cvt 800 480 60`), 295 MHz bit clock
-const struct dvi_timing __dvi_const(dvi_timing_800x480p_60hz) = {
+// output of `cvt 800 480 60`), 295 MHz bit clock. The native resolution of many
+// small HDMI panels. A2DVI renders the centre 720 pixels, the DMA adds the borders.
+struct dvi_timing __dvi_const(dvi_timing_800x480p_60hz) = {
 	.h_sync_polarity = false,
 	.h_front_porch   = 24,
 	.h_sync_width    = 72,
@@ -82,6 +84,24 @@ const struct dvi_timing __dvi_const(dvi_timing_800x480p_60hz) = {
 	.bit_clk_khz     = 295200
 };
 
+#if 0 // DISABLED: not used by A2DVI
+// SVGA -- completely by-the-book but requires 400 MHz clk_sys
+const struct dvi_timing __dvi_const(dvi_timing_800x600p_60hz) = {
+	.h_sync_polarity   = false,
+	.h_front_porch     = 44,
+	.h_sync_width      = 128,
+	.h_back_porch      = 88,
+	.h_active_pixels   = 800,
+
+	.v_sync_polarity   = false,
+	.v_front_porch     = 1,
+	.v_sync_width      = 4,
+	.v_back_porch      = 23,
+	.v_active_lines    = 600,
+
+	.bit_clk_khz       = 400000
+};
+
 // SVGA reduced blanking (355 MHz bit clock) -- valid CVT mode, less common
 // than fully-blanked SVGA, but doesn't require such a high system clock
 const struct dvi_timing __dvi_const(dvi_timing_800x600p_reduced_60hz) = {
@@ -261,15 +281,18 @@ void __dvi_func(dvi_timing_state_init)(struct dvi_timing_state *t)
 {
 	t->v_ctr = 0;
 	t->v_state = DVI_STATE_FRONT_PORCH;
+	t->v_adjust = 0;
 }
 
 void __dvi_func(dvi_timing_state_advance)(const struct dvi_timing *t, struct dvi_timing_state *s) {
 		s->v_ctr++;
 		if ((s->v_state == DVI_STATE_FRONT_PORCH && s->v_ctr == t->v_front_porch) ||
 		    (s->v_state == DVI_STATE_SYNC && s->v_ctr == t->v_sync_width) ||
-		    (s->v_state == DVI_STATE_BACK_PORCH && s->v_ctr == t->v_back_porch) ||
+		    (s->v_state == DVI_STATE_BACK_PORCH && s->v_ctr >= t->v_back_porch + s->v_adjust) ||
 		    (s->v_state == DVI_STATE_ACTIVE && s->v_ctr == t->v_active_lines)) {
 
+			if (s->v_state == DVI_STATE_BACK_PORCH)
+				s->v_adjust = 0;
 			s->v_state = (s->v_state + 1) % DVI_STATE_COUNT;
 			s->v_ctr = 0;
 		}
@@ -304,78 +327,135 @@ static void _set_data_cb(dma_cb_t *cb, const struct dvi_lane_dma_cfg *dma_cfg,
 	channel_config_set_irq_quiet(&cb->c, !irq_on_finish);
 }
 
+// Black pixels: the symbol pair of a lane, repeated with a read ring (4 or 8 byte period)
+#define BLACK_SYMS(lane) (&empty_scanline_tmds[2 * (lane) / DVI_SYMBOLS_PER_WORD])
+#define BLACK_RING       (DVI_SYMBOLS_PER_WORD == 2 ? 2 : 3)
+
+// Horizontal borders (h_border > 0): the scanline buffers only cover the centre
+// of the active area, the black borders left and right of it are DMA'd from the
+// symbol table. The IRQ then has to come with the last block of the list, the
+// scanline buffer, as the control channels must have loaded the last block of
+// a list before the IRQ points them to the next one. So the right border is
+// moved to the start of the following list (patched for each scanline by
+// dvi_set_scanline_border_dma, since it depends on the previous scanline):
+//
+//   sync lane:   [right border] front porch, sync, back porch, left border (IRQ), pixels
+//   other lanes: [right border] blanking, left border, pixels
+//
+// Without borders, the lists are as usual: the back porch raises the IRQ.
+
 void __dvi_func(dvi_setup_scanline_for_vblank)(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
-		bool vsync_asserted, struct dvi_scanline_dma_list *l)
+		uint h_border, bool vsync_asserted, struct dvi_scanline_dma_list *l)
 {
 	bool vsync = t->v_sync_polarity == vsync_asserted;
 	const uint32_t *sym_hsync_off = get_ctrl_sym(vsync, !t->h_sync_polarity);
 	const uint32_t *sym_hsync_on  = get_ctrl_sym(vsync,  t->h_sync_polarity);
 	const uint32_t *sym_no_sync   = get_ctrl_sym(false,  false             );
-
-	dma_cb_t *synclist = dvi_lane_from_list(l, TMDS_SYNC_LANE);
-	// The symbol table contains each control symbol *twice*, concatenated into 20 LSBs of table word, so we can always do word-repeat.
-	_set_data_cb(&synclist[0], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_front_porch   / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
-	_set_data_cb(&synclist[1], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_on,  t->h_sync_width    / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
-	_set_data_cb(&synclist[2], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_back_porch    / DVI_SYMBOLS_PER_WORD, 2, IRQ_ON_FINISH);
-	_set_data_cb(&synclist[3], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_active_pixels / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+	uint image_pixels = t->h_active_pixels - 2 * h_border;
 
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
-		if (i == TMDS_SYNC_LANE)
-			continue;
 		dma_cb_t *cblist = dvi_lane_from_list(l, i);
-		_set_data_cb(&cblist[0], &dma_cfg[i], sym_no_sync,(t->h_front_porch + t->h_sync_width + t->h_back_porch) / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
-		_set_data_cb(&cblist[1], &dma_cfg[i], sym_no_sync, t->h_active_pixels / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+		int n = 0;
+		// The symbol table contains each control symbol *twice*, concatenated into 20 LSBs of table word, so we can always do word-repeat.
+		if (i == TMDS_SYNC_LANE) {
+			if (h_border)
+				_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, h_border    / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, t->h_front_porch / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_on,  t->h_sync_width  / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, t->h_back_porch  / DVI_SYMBOLS_PER_WORD, 2, !h_border);
+			if (h_border)
+				_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, h_border    / DVI_SYMBOLS_PER_WORD, 2, IRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, image_pixels / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+		}
+		else {
+			if (h_border)
+				_set_data_cb(&cblist[n++], &dma_cfg[i], sym_no_sync, h_border / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_no_sync,
+				(t->h_front_porch + t->h_sync_width + t->h_back_porch + h_border) / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_no_sync, image_pixels / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+		}
 	}
 }
 
 void __dvi_func(dvi_setup_scanline_for_active)(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
-		uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l)
+		uint h_border, uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l)
 {
 	const uint32_t *sym_hsync_off = get_ctrl_sym(!t->v_sync_polarity, !t->h_sync_polarity);
 	const uint32_t *sym_hsync_on  = get_ctrl_sym(!t->v_sync_polarity,  t->h_sync_polarity);
 	const uint32_t *sym_no_sync   = get_ctrl_sym(false,                false             );
-
-	dma_cb_t *synclist = dvi_lane_from_list(l, TMDS_SYNC_LANE);
-	_set_data_cb(&synclist[0], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_front_porch / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
-	_set_data_cb(&synclist[1], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_on,  t->h_sync_width  / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
-	_set_data_cb(&synclist[2], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_back_porch  / DVI_SYMBOLS_PER_WORD, 2, IRQ_ON_FINISH);
+	uint image_pixels = t->h_active_pixels - 2 * h_border;
 
 	for (int i = 0; i < N_TMDS_LANES; ++i)
 	{
 		dma_cb_t *cblist = dvi_lane_from_list(l, i);
-		if (i != TMDS_SYNC_LANE)
+		int n = 0;
+		if (h_border)
+			_set_data_cb(&cblist[n++], &dma_cfg[i], BLACK_SYMS(i), h_border / DVI_SYMBOLS_PER_WORD, BLACK_RING, NOIRQ_ON_FINISH);
+		if (i == TMDS_SYNC_LANE)
+		{
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, t->h_front_porch / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_on,  t->h_sync_width  / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_hsync_off, t->h_back_porch  / DVI_SYMBOLS_PER_WORD, 2, !h_border);
+		}
+		else
 		{
-			_set_data_cb(&cblist[0], &dma_cfg[i], sym_no_sync,
+			_set_data_cb(&cblist[n++], &dma_cfg[i], sym_no_sync,
 				(t->h_front_porch + t->h_sync_width + t->h_back_porch) / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
 		}
-		int target_block = (i == TMDS_SYNC_LANE) ? DVI_SYNC_LANE_CHUNKS - 1 :  DVI_NOSYNC_LANE_CHUNKS - 1;
+		if (h_border)
+			_set_data_cb(&cblist[n++], &dma_cfg[i], BLACK_SYMS(i), h_border / DVI_SYMBOLS_PER_WORD, BLACK_RING, i == TMDS_SYNC_LANE);
 		if (tmdsbuf)
 		{
 			// Non-repeating DMA for the freshly-encoded TMDS buffer
-			_set_data_cb(&cblist[target_block], &dma_cfg[i], tmdsbuf + i * (t->h_active_pixels / DVI_SYMBOLS_PER_WORD),
-				t->h_active_pixels / DVI_SYMBOLS_PER_WORD, 0, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n], &dma_cfg[i], tmdsbuf + i * (image_pixels / DVI_SYMBOLS_PER_WORD),
+				image_pixels / DVI_SYMBOLS_PER_WORD, 0, NOIRQ_ON_FINISH);
 		}
 		else
 		{
 			// Use read ring to repeat the correct DC-balanced symbol pair on blank scanlines (4 or 8 byte period)
-			_set_data_cb(&cblist[target_block], &dma_cfg[i], &empty_scanline_tmds[2 * i / DVI_SYMBOLS_PER_WORD],
-				t->h_active_pixels / DVI_SYMBOLS_PER_WORD, DVI_SYMBOLS_PER_WORD == 2 ? 2 : 3, NOIRQ_ON_FINISH);
+			_set_data_cb(&cblist[n], &dma_cfg[i], BLACK_SYMS(i),
+				image_pixels / DVI_SYMBOLS_PER_WORD, BLACK_RING, NOIRQ_ON_FINISH);
 		}
 	}
 }
 
-void __dvi_func(dvi_update_scanline_data_dma)(const struct dvi_timing *t, const uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l)
+void __dvi_func(dvi_update_scanline_data_dma)(const struct dvi_timing *t, uint h_border, const uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l)
 {
+	uint image_pixels = t->h_active_pixels - 2 * h_border;
+	// the scanline buffer is the last block
+	int extra = (h_border) ? 2 : 0;
+
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
 #if DVI_MONOCHROME_TMDS
 		const uint32_t *lane_tmdsbuf = tmdsbuf;
 #else
-		const uint32_t *lane_tmdsbuf = tmdsbuf + i * t->h_active_pixels / DVI_SYMBOLS_PER_WORD;
+		const uint32_t *lane_tmdsbuf = tmdsbuf + i * image_pixels / DVI_SYMBOLS_PER_WORD;
 #endif
 		if (i == TMDS_SYNC_LANE)
-			dvi_lane_from_list(l, i)[3].read_addr = lane_tmdsbuf;
+			dvi_lane_from_list(l, i)[3 + extra].read_addr = lane_tmdsbuf;
+		else
+			dvi_lane_from_list(l, i)[1 + extra].read_addr = lane_tmdsbuf;
+	}
+}
+
+// The right border at the start of a list belongs to the previous scanline:
+// black pixels after an active scanline, blanking (with its vsync level) otherwise.
+void __dvi_func(dvi_set_scanline_border_dma)(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
+		uint h_border, bool prev_active, bool prev_vsync_asserted, struct dvi_scanline_dma_list *l)
+{
+	if (!h_border)
+		return;
+
+	for (int i = 0; i < N_TMDS_LANES; ++i) {
+		dma_cb_t *cb = dvi_lane_from_list(l, i);
+		if (prev_active)
+			_set_data_cb(cb, &dma_cfg[i], BLACK_SYMS(i), h_border / DVI_SYMBOLS_PER_WORD, BLACK_RING, NOIRQ_ON_FINISH);
+		else
+		if (i == TMDS_SYNC_LANE)
+			_set_data_cb(cb, &dma_cfg[i], get_ctrl_sym(t->v_sync_polarity == prev_vsync_asserted, !t->h_sync_polarity),
+				h_border / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
 		else
-			dvi_lane_from_list(l, i)[1].read_addr = lane_tmdsbuf;
+			_set_data_cb(cb, &dma_cfg[i], get_ctrl_sym(false, false), h_border / DVI_SYMBOLS_PER_WORD, 2, NOIRQ_ON_FINISH);
 	}
 }
 
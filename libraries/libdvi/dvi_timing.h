@@ -33,6 +33,9 @@ enum dvi_line_state {
 struct dvi_timing_state {
 	uint v_ctr;
 	enum dvi_line_state v_state;
+	// lines added to (or removed from) the next vertical back porch, for
+	// pacing the frames to an external source (cleared once applied)
+	volatile int v_adjust;
 };
 
 // This should map directly to DMA register layout, but more convenient types
@@ -48,8 +51,13 @@ typedef struct dma_cb {
 static_assert(sizeof(dma_cb_t) == 4 * sizeof(uint32_t), "bad dma layout");
 static_assert(__builtin_offsetof(dma_cb_t, c.ctrl) == __builtin_offsetof(dma_channel_hw_t, ctrl_trig), "bad dma layout");
 
-#define DVI_SYNC_LANE_CHUNKS DVI_STATE_COUNT
-#define DVI_NOSYNC_LANE_CHUNKS 2
+// Blocks per scanline: front porch, sync, back porch and active area on the
+// sync lane, blanking and active area on the other lanes. With a horizontal
+// border, the active area is split into the left border and the pixels of the
+// scanline buffer, and each list starts with the right border of the previous
+// scanline (see dvi_set_scanline_border_dma).
+#define DVI_SYNC_LANE_CHUNKS (DVI_STATE_COUNT + 2)
+#define DVI_NOSYNC_LANE_CHUNKS 4
 
 struct dvi_scanline_dma_list {
 	dma_cb_t l0[DVI_SYNC_LANE_CHUNKS];
@@ -75,6 +83,7 @@ extern uint32_t dvi_ctrl_syms[4];
 
 extern struct dvi_timing dvi_timing_640x480p_60hz;
 extern struct dvi_timing dvi_timing_720x480p_60hz;
+extern struct dvi_timing dvi_timing_720x576p_50hz;
 extern struct dvi_timing dvi_timing_800x480p_60hz;
 extern struct dvi_timing dvi_timing_800x600p_60hz;
 extern struct dvi_timing dvi_timing_960x540p_60hz;
@@ -90,11 +99,14 @@ void dvi_timing_state_advance(const struct dvi_timing *t, struct dvi_timing_stat
 void dvi_scanline_dma_list_init(struct dvi_scanline_dma_list *dma_list);
 
 void dvi_setup_scanline_for_vblank(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
-		bool vsync_asserted, struct dvi_scanline_dma_list *l);
+		uint h_border, bool vsync_asserted, struct dvi_scanline_dma_list *l);
 
 void dvi_setup_scanline_for_active(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
-		uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l);
+		uint h_border, uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l);
 
-void dvi_update_scanline_data_dma(const struct dvi_timing *t, const uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l);
+void dvi_update_scanline_data_dma(const struct dvi_timing *t, uint h_border, const uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l);
+
+void dvi_set_scanline_border_dma(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
+		uint h_border, bool prev_active, bool prev_vsync_asserted, struct dvi_scanline_dma_list *l);
 
 #endif
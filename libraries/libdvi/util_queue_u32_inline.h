@@ -80,4 +80,64 @@ static inline void queue_peek_blocking_u32(queue_t *q, void *data) {
     } while (true);
 }
 
+// Lock-free variants for queues with exactly one producer and one consumer,
+// e.g. the renderer and the DVI DMA interrupt, handing over buffer pointers.
+// No spinlock: the producer only ever writes wptr, the consumer only ever
+// writes rptr, so each side owns its index, and only reads the other one.
+// The element is written before wptr publishes it, and read before rptr hands
+// its slot back. For a handoff between a thread and an interrupt on the same
+// core, a compiler barrier would already suffice - the __dmb is cheap and also
+// keeps the queue safe between the two cores.
+// These must not be mixed with the spinlocked functions above on the same
+// queue, and a second producer (or consumer) needs to exclude the first one
+// itself (e.g. by disabling interrupts on the core running the DMA IRQ).
+
+static inline bool queue_spsc_try_add_u32(queue_t *q, void *data) {
+    uint16_t wptr = q->wptr;
+    uint16_t next = _queue_inc_index_u32(q, wptr);
+    if (next == *(volatile uint16_t*)&q->rptr) {
+        return false; // full
+    }
+    ((uint32_t*)q->data)[wptr] = *(uint32_t*)data;
+    __dmb(); // element is visible before it is published
+    *(volatile uint16_t*)&q->wptr = next;
+    __sev();
+    return true;
+}
+
+static inline bool queue_spsc_try_remove_u32(queue_t *q, void *data) {
+    uint16_t rptr = q->rptr;
+    if (rptr == *(volatile uint16_t*)&q->wptr) {
+        return false; // empty
+    }
+    __dmb(); // element is read after seeing it published
+    *(uint32_t*)data = ((volatile uint32_t*)q->data)[rptr];
+    __dmb(); // element is read before its slot is handed back
+    *(volatile uint16_t*)&q->rptr = _queue_inc_index_u32(q, rptr);
+    __sev();
+    return true;
+}
+
+static inline bool queue_spsc_try_peek_u32(queue_t *q, void *data) {
+    uint16_t rptr = q->rptr;
+    if (rptr == *(volatile uint16_t*)&q->wptr) {
+        return false; // empty
+    }
+    __dmb();
+    *(uint32_t*)data = ((volatile uint32_t*)q->data)[rptr];
+    return true;
+}
+
+static inline void queue_spsc_add_blocking_u32(queue_t *q, void *data) {
+    while (!queue_spsc_try_add_u32(q, data)) {
+        __wfe();
+    }
+}
+
+static inline void queue_spsc_remove_blocking_u32(queue_t *q, void *data) {
+    while (!queue_spsc_try_remove_u32(q, data)) {
+        __wfe();
+    }
+}
+
 #endif
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# abus_trace_gen.py - Generate Apple II bus traces for the host replay tool
+#
+# Copyright (c) 2024 Thorsten Brehm.
+#
+# MIT License (see firmware sources).
+#
+# Writes the 32-bit words pushed by abus.pio (little-endian):
+#   bits 25..10: address bus, bit 9: R/W (1=read), bit 8: ~SELECT (0=card selected),
+#   bits 7..0: data bus.
+#
+# Usage:
+#   abus_trace_gen.py <script> <trace.bin>   convert a text script to a trace
+#   abus_trace_gen.py --demo <trace.bin>     generate the default regression trace
+#
+# Script lines: "R <address>", "W <address> <data>" (hex), "#" comments.
+
+import struct
+import sys
+
+RW_READ     = 1 << 9
+SELECT_OFF  = 1 << 8
+CARD_SLOT   = 1       # same slot as the firmware tests
+CARD_REGS   = 0xC080 | (CARD_SLOT << 4)
+
+def bus_word(address, data, read):
+    word = (address & 0xffff) << 10
+    if read:
+        word |= RW_READ
+    else:
+        word |= data & 0xff
+    if (address & 0xfff0) != CARD_REGS:
+        word |= SELECT_OFF
+    return word
+
+class Trace:
+    def __init__(self):
+        self.words = []
+        self.pc    = 0x0800
+
+    def read(self, address):
+        self.words.append(bus_word(address, 0, True))
+
+    def write(self, address, data):
+        self.words.append(bus_word(address, data, False))
+
+    # 6502 instruction fetches (opcode + operands), program at $0800-$0FFF
+    def fetch(self, count):
+        for i in range(count):
+            self.read(self.pc)
+            self.pc = 0x0800 + ((self.pc + 1) & 0x7ff)
+
+    # "STA $address": 3 fetches + write cycle
+    def sta(self, address, data):
+        self.fetch(3)
+        self.write(address, data)
+
+    # "LDA $address": 3 fetches + read cycle
+    def lda(self, address):
+        self.fetch(3)
+        self.read(address)
+
+    def save(self, filename):
+        with open(filename, "wb") as f:
+            for word in self.words:
+                f.write(struct.pack("<I", word))
+
+def demo_trace():
+    t = Trace()
+
+    # 6502 reset: vector fetch and jump to the Apple IIe reset routine
+    t.read(0xFFFC)
+    t.read(0xFFFD)
+    t.read(0xFA62)
+
+    # text page 1
+    for i in range(0x400):
+        t.sta(0x400+i, 0xA0 + (i % 0x40))
+
+    # 80 column text: 80STORE, PAGE2 selects aux memory
+    t.sta(0xC001, 0)   # 80STOREON
+    t.sta(0xC00D, 0)   # 80COLON
+    t.lda(0xC055)      # PAGE2ON
+    for i in range(0x400):
+        t.sta(0x400+i, 0xC1 + (i % 26))
+    t.lda(0xC054)      # PAGE2OFF
+    t.sta(0xC000, 0)   # 80STOREOFF
+
+    # HGR page 1 and 2, aux HGR via RAMWRT
+    t.lda(0xC050)      # TEXTOFF
+    t.lda(0xC057)      # HIRESON
+    for i in range(0x4000):
+        t.sta(0x2000+i, i & 0xff)
+    t.sta(0xC005, 0)   # RAMWRTON
+    for i in range(0x2000):
+        t.sta(0x2000+i, (i*7) & 0xff)
+    t.sta(0xC004, 0)   # RAMWRTOFF
+
+    # ignored areas, ROM and language card reads
+    for i in range(0x1000):
+        t.sta(0x6000+i, i & 0xff)
+        t.lda(0xD000+i)
+
+    # DHGR: 80COL + AN3 off, mixed mode, alternate character set, vblank polling
+    t.lda(0xC05E)      # DGRON
+    t.lda(0xC053)      # MIXEDON
+    t.sta(0xC00F, 0)   # ALTCHARSETON
+    for i in range(0x100):
+        t.lda(0xC019)  # RDVBL
+
+    # A2DVI device registers: unlock and select green monochrome
+    t.sta(CARD_REGS+0xf, 11)
+    t.sta(CARD_REGS+0xf, 22)
+    t.sta(CARD_REGS+0x1, 2)
+
+    return t
+
+def script_trace(filename):
+    t = Trace()
+    with open(filename) as f:
+        for line in f:
+            line = line.split("#")[0].split()
+            if not line:
+                continue
+            if line[0].upper() == "R":
+                t.read(int(line[1], 16))
+            elif line[0].upper() == "W":
+                t.write(int(line[1], 16), int(line[2], 16))
+            else:
+                raise ValueError("invalid script line: %s" % " ".join(line))
+    return t
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: %s <script>|--demo <trace.bin>" % sys.argv[0])
+        sys.exit(1)
+    trace = demo_trace() if sys.argv[1] == "--demo" else script_trace(sys.argv[1])
+    trace.save(sys.argv[2])
+    print("%u bus cycles written to %s" % (len(trace.words), sys.argv[2]))
@@ -169,10 +169,44 @@ enc = TMDSEncode()
 # 	if enc.imbalance == 0:
 # 		print(f"{i:02x}: {sym:03x}")
 
+###
+# HGR color kernel table: the per channel hires color patterns of
+# firmware/dvi/tmds_hires.c, interleaved as red/green/blue symbol triplets.
+# The HGR renderer fetches all three channels of a dot pattern from one
+# location, with the odd/even pixel phase selecting the table half.
+# Entries are padded to 4 words (16 bytes), so the SIO interpolators can
+# compute the entry address from the dot pattern with a plain shift/mask.
+
+def read_c_table(src, name):
+	start = src.index(name)
+	body = src[src.index("{", start) + 1:src.index("}", start)]
+	body = " ".join(line.split("//")[0] for line in body.split("\n"))
+	return [int(v, 0) for v in body.split(",") if v.strip()]
+
+def hires_rgb_table(filename):
+	with open(filename) as f:
+		src = f.read()
+	red   = read_c_table(src, "tmds_hires_color_patterns_red")
+	green = read_c_table(src, "tmds_hires_color_patterns_green")
+	blue  = read_c_table(src, "tmds_hires_color_patterns_blue")
+	assert(len(red) == len(green) == len(blue) == 2 * 256)
+
+	print("// Generated by tools/tmds_table_gen.py from tmds_hires.c - do not edit:")
+	print("//   python3 tools/tmds_table_gen.py hires firmware/dvi/tmds_hires.c > firmware/dvi/tmds_hires_rgb.c")
+	print()
+	print("#include \"tmds.h\"")
+	print("#include \"config/config.h\"")
+	print()
+	print("// hires TMDS color patterns, interleaved: red, green, blue")
+	print("uint32_t DELAYED_COPY_DATA(tmds_hires_color_patterns_rgb)[2*256*TMDS_HIRES_RGB_STRIDE] = {")
+	for i in range(2 * 256):
+		print(f"\t0x{red[i]:05x}, 0x{green[i]:05x}, 0x{blue[i]:05x}, 0, // {'odd ' if i & 0x100 else 'even'} 0x{i & 0xff:02x}")
+	print("};")
+
 ###
 # Generate 2bpp table based on above experiment:
 
-if __name__=="__main__":
+def table_2bpp():
 	levels_2bpp_even = [0x05, 0x50, 0xaf, 0xfa]
 	levels_2bpp_odd  = [0x04, 0x51, 0xae, 0xfb]
 
@@ -182,3 +216,10 @@ if __name__=="__main__":
 			sym1 = enc.encode(p1, 0, 1)
 			assert(enc.imbalance == 0)
 			print(f".word 0x{sym1 << 10 | sym0:05x} // {i0:02b}, {i1:02b}")
+
+if __name__=="__main__":
+	import sys
+	if len(sys.argv) == 3 and sys.argv[1] == "hires":
+		hires_rgb_table(sys.argv[2])
+	else:
+		table_2bpp()